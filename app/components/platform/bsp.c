@@ -20,16 +20,58 @@
 #define MAX_HEX_STR_LENGTH    (128)
 #define LOG_BUFFER_SIZE       (256)
 
+#define NFC_IRQ_TASK_NAME     "nfc_irq"
+#define NFC_IRQ_TASK_STACK    (3072)
+#define NFC_IRQ_TASK_PRIO     (configMAX_PRIORITIES - 2)   // Above every RFAL user, below the IPC tasks
+
 /* Public variables --------------------------------------------------------- */
 /* Private variables -------------------------------------------------------- */
 static const char *TAG = "BSP";
 static spi_device_handle_t  m_spi_hdl;
+static spi_transaction_ext_t m_spi_trans;                    // Reused for every transfer, no per call setup
+static uint8_t              *m_spi_tx_buf;                   // Word aligned DMA buffers, saves the driver
+static uint8_t              *m_spi_rx_buf;                   // a malloc + copy on unaligned caller buffers
+static uint32_t             m_spi_clock_hz = NFC_SPI_CLOCK_HZ;
+
+static SemaphoreHandle_t    m_nfc_comm_mutex;
+static SemaphoreHandle_t    m_nfc_worker_mutex;
+static portMUX_TYPE         m_nfc_irq_status_mux = portMUX_INITIALIZER_UNLOCKED;
+
+#if NFC_LOCK_STATS
+static struct
+{
+  uint32_t depth;             // Recursion level, only touched by the holder
+  int64_t  t0;                // Time of the outermost take
+  bsp_nfc_lock_stats_t stats;
+}
+m_nfc_lock[BSP_NFC_LOCK_CNT] =
+{
+  [BSP_NFC_LOCK_COMM]       = { .stats = { .budget_us = NFC_COMM_LOCK_BUDGET_US } },
+  [BSP_NFC_LOCK_IRQ_STATUS] = { .stats = { .budget_us = NFC_IRQ_STATUS_LOCK_BUDGET_US } },
+  [BSP_NFC_LOCK_WORKER]     = { .stats = { .budget_us = NFC_WORKER_LOCK_BUDGET_US } },
+};
+#endif
+
+static TaskHandle_t         m_nfc_irq_task;
+static void                 (*m_nfc_irq_cb)(void);
+static volatile TaskHandle_t m_nfc_irq_waiter;
+static volatile bool        m_nfc_irq_sim_pending;
+static esp_timer_handle_t   m_nfc_irq_wait_tmr;
+static volatile bool        m_nfc_irq_wait_armed;     // A bsp_nfc_irq_wait() is blocked on the timer
+static void                 (*m_nfc_worker_wait)(void);
 
 /* Private function prototypes ---------------------------------------------- */
 static inline void m_bsp_nvs_init(void);
 static inline void m_bsp_spiffs_init(void);
 static inline void bsp_spi_init(void);
+static esp_err_t m_bsp_spi_add_device(void);
+static esp_err_t m_bsp_spi_transfer(uint8_t cmd_bits, uint8_t cmd, const uint8_t *tx_data, uint8_t *rx_data, uint16_t len);
 static inline void bsp_gpio_init(void);
+static void IRAM_ATTR m_bsp_nfc_irq_isr(void *arg);
+static void m_bsp_nfc_irq_task(void *arg);
+static void m_bsp_nfc_irq_wait_expired(void *arg);
+static inline void m_bsp_nfc_lock_taken(bsp_nfc_lock_t lock);
+static inline void m_bsp_nfc_lock_released(bsp_nfc_lock_t lock);
 
 /* Function definitions ----------------------------------------------------- */
 void bsp_init(void)
@@ -40,23 +82,259 @@ void bsp_init(void)
   bsp_spi_init();
 }
 
-void bsp_spi_transmit_receive(const uint8_t *tx_data, uint8_t *rx_data, uint16_t len)
+esp_err_t bsp_spi_transmit_receive(const uint8_t *tx_data, uint8_t *rx_data, uint16_t len)
+{
+  return m_bsp_spi_transfer(0, 0, tx_data, rx_data, len);
+}
+
+esp_err_t bsp_spi_command_transfer(uint8_t cmd, const uint8_t *tx_data, uint8_t *rx_data, uint16_t len)
+{
+  return m_bsp_spi_transfer(8, cmd, tx_data, rx_data, len);
+}
+
+esp_err_t bsp_spi_set_clock(uint32_t clock_hz)
+{
+  esp_err_t ret;
+  uint32_t  old_hz = m_spi_clock_hz;
+
+  CHECK((0 != clock_hz) && (clock_hz <= NFC_SPI_CLOCK_MAX_HZ), ESP_ERR_INVALID_ARG);
+  CHECK(NULL != m_spi_hdl, ESP_ERR_INVALID_STATE);
+
+  if (clock_hz == m_spi_clock_hz)
+    return ESP_OK;
+
+  spi_device_release_bus(m_spi_hdl);
+  ret = spi_bus_remove_device(m_spi_hdl);
+  if (ESP_OK != ret)
+  {
+    // Still attached, hold the bus again
+    spi_device_acquire_bus(m_spi_hdl, portMAX_DELAY);
+    return ret;
+  }
+
+  m_spi_hdl      = NULL;
+  m_spi_clock_hz = clock_hz;
+
+  ret = m_bsp_spi_add_device();
+  if (ESP_OK == ret)
+    return ESP_OK;
+
+  // Back on the former clock, no handle left otherwise and transfers are rejected
+  m_spi_clock_hz = old_hz;
+  if (ESP_OK != m_bsp_spi_add_device())
+    ESP_LOGE(TAG, "NFC SPI device lost on clock change");
+
+  return ret;
+}
+
+void bsp_nfc_irq_init(void)
 {
   esp_err_t ret;
-  spi_transaction_t t;
 
-  if (0 == len)
+  // Called again on every rfalInitialize(), the pipeline only needs to be built once
+  if (NULL != m_nfc_irq_task)
+    return;
+
+  gpio_config_t io_cfg =
+  {
+    .pin_bit_mask = (1ULL << IO_NFC_IRQ_IN_PIN),
+    .mode         = GPIO_MODE_INPUT,
+    .pull_up_en   = GPIO_PULLUP_DISABLE,
+    .pull_down_en = GPIO_PULLDOWN_DISABLE,   // GPIO35 is input only, no internal pulls
+    .intr_type    = GPIO_INTR_POSEDGE        // IRQ line is active high and stays high until drained
+  };
+  ESP_ERROR_CHECK(gpio_config(&io_cfg));
+
+  // One-shot timer ends bsp_nfc_irq_wait() with us resolution, the tick is 10 ms here
+  esp_timer_create_args_t tmr_cfg =
+  {
+    .callback        = m_bsp_nfc_irq_wait_expired,
+    .arg             = NULL,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name            = "nfc_irq_wait"
+  };
+  ESP_ERROR_CHECK(esp_timer_create(&tmr_cfg, &m_nfc_irq_wait_tmr));
+
+  xTaskCreate(m_bsp_nfc_irq_task, NFC_IRQ_TASK_NAME, NFC_IRQ_TASK_STACK, NULL, NFC_IRQ_TASK_PRIO, &m_nfc_irq_task);
+  assert(m_nfc_irq_task != NULL);
+
+  // The ISR service may already be installed by another driver
+  ret = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+  assert((ESP_OK == ret) || (ESP_ERR_INVALID_STATE == ret));
+
+  ESP_ERROR_CHECK(gpio_isr_handler_add(IO_NFC_IRQ_IN_PIN, m_bsp_nfc_irq_isr, NULL));
+
+  // Line may already be high if the chip raised an IRQ before the handler was attached
+  if (gpio_get_level(IO_NFC_IRQ_IN_PIN))
+    xTaskNotifyGive(m_nfc_irq_task);
+}
+
+void bsp_nfc_irq_set_callback(void (*cb)(void))
+{
+  m_nfc_irq_cb = cb;
+}
+
+void bsp_nfc_irq_set_waiter(TaskHandle_t task)
+{
+  m_nfc_irq_waiter = task;
+}
+
+void bsp_nfc_irq_wait(uint32_t timeout_us)
+{
+  if (0 == timeout_us)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return;
+  }
+
+  m_nfc_irq_wait_armed = true;
+
+  if (ESP_OK != esp_timer_start_once(m_nfc_irq_wait_tmr, timeout_us))
+  {
+    // No us timer, the tick timeout rounded up still blocks instead of spinning
+    m_nfc_irq_wait_armed = false;
+    ulTaskNotifyTake(pdTRUE, (timeout_us + (portTICK_PERIOD_MS * 1000) - 1) / (portTICK_PERIOD_MS * 1000));
     return;
-  memset(&t, 0, sizeof(t)); // Zero out the transaction
+  }
+
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+  // Woken by the IRQ task first, an expiry already on its way must not end the next wait.
+  // Dropping an IRQ notification here is harmless, the IRQ status is set before it is given.
+  m_nfc_irq_wait_armed = false;
+  esp_timer_stop(m_nfc_irq_wait_tmr);
+  ulTaskNotifyTake(pdTRUE, 0);
+}
+
+bool bsp_nfc_irq_is_high(void)
+{
+  bool sim;
+
+  portENTER_CRITICAL(&m_nfc_irq_status_mux);
+  sim                   = m_nfc_irq_sim_pending;
+  m_nfc_irq_sim_pending = false;
+  portEXIT_CRITICAL(&m_nfc_irq_status_mux);
+
+  return (sim || (gpio_get_level(IO_NFC_IRQ_IN_PIN) == 1));
+}
+
+void bsp_nfc_irq_simulate(void)
+{
+  portENTER_CRITICAL(&m_nfc_irq_status_mux);
+  m_nfc_irq_sim_pending = true;
+  portEXIT_CRITICAL(&m_nfc_irq_status_mux);
+
+  if (NULL != m_nfc_irq_task)
+    xTaskNotifyGive(m_nfc_irq_task);
+}
+
+esp_err_t bsp_nfc_light_sleep(uint32_t timeout_us)
+{
+  esp_err_t ret;
 
-  t.length    = len * 8;    // Len is in bytes, transaction length is in bits.
-  t.tx_buffer = tx_data;    // Data
-  t.user      = (void *)1;  // D/C needs to be set to 1
-  t.rx_buffer = rx_data;
+  // The chip keeps the line high until drained, an edge missed while asleep is not lost
+  if (gpio_get_level(IO_NFC_IRQ_IN_PIN))
+    return ESP_OK;
 
-  ret = spi_device_transmit(m_spi_hdl, &t);
+  // GPIO wake-up only knows levels, the edge interrupt is given back afterwards.
+  // Masked meanwhile, the high level would keep firing the ISR until the chip is drained.
+  gpio_intr_disable(IO_NFC_IRQ_IN_PIN);
+  ret = gpio_wakeup_enable(IO_NFC_IRQ_IN_PIN, GPIO_INTR_HIGH_LEVEL);
+  if (ESP_OK == ret)
+    ret = esp_sleep_enable_gpio_wakeup();
+  if ((ESP_OK == ret) && (0 != timeout_us))
+    ret = esp_sleep_enable_timer_wakeup(timeout_us);
+  if (ESP_OK == ret)
+    ret = esp_light_sleep_start();
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+  gpio_wakeup_disable(IO_NFC_IRQ_IN_PIN);
+  gpio_set_intr_type(IO_NFC_IRQ_IN_PIN, GPIO_INTR_POSEDGE);
+  gpio_intr_enable(IO_NFC_IRQ_IN_PIN);
+
+  // The edge may have happened before the interrupt type was restored
+  if ((NULL != m_nfc_irq_task) && gpio_get_level(IO_NFC_IRQ_IN_PIN))
+    xTaskNotifyGive(m_nfc_irq_task);
+
+  return ret;
+}
 
-  assert(ret == ESP_OK); 
+void bsp_nfc_comm_lock(void)
+{
+  xSemaphoreTakeRecursive(m_nfc_comm_mutex, portMAX_DELAY);
+  m_bsp_nfc_lock_taken(BSP_NFC_LOCK_COMM);
+}
+
+void bsp_nfc_comm_unlock(void)
+{
+  m_bsp_nfc_lock_released(BSP_NFC_LOCK_COMM);
+  xSemaphoreGiveRecursive(m_nfc_comm_mutex);
+}
+
+void bsp_nfc_worker_lock(void)
+{
+  xSemaphoreTakeRecursive(m_nfc_worker_mutex, portMAX_DELAY);
+  m_bsp_nfc_lock_taken(BSP_NFC_LOCK_WORKER);
+}
+
+void bsp_nfc_worker_unlock(void)
+{
+  m_bsp_nfc_lock_released(BSP_NFC_LOCK_WORKER);
+  xSemaphoreGiveRecursive(m_nfc_worker_mutex);
+}
+
+void bsp_nfc_worker_set_wait(void (*wait)(void))
+{
+  m_nfc_worker_wait = wait;
+}
+
+void bsp_nfc_worker_wait(void)
+{
+  // No owner yet, the RFAL is run by a plain task
+  if (NULL == m_nfc_worker_wait)
+  {
+    vTaskDelay(1);
+    return;
+  }
+
+  m_nfc_worker_wait();
+}
+
+void bsp_nfc_irq_status_lock(void)
+{
+  portENTER_CRITICAL(&m_nfc_irq_status_mux);
+  m_bsp_nfc_lock_taken(BSP_NFC_LOCK_IRQ_STATUS);
+}
+
+void bsp_nfc_irq_status_unlock(void)
+{
+  m_bsp_nfc_lock_released(BSP_NFC_LOCK_IRQ_STATUS);
+  portEXIT_CRITICAL(&m_nfc_irq_status_mux);
+}
+
+esp_err_t bsp_nfc_lock_stats_get(bsp_nfc_lock_t lock, bsp_nfc_lock_stats_t *stats)
+{
+  CHECK((lock < BSP_NFC_LOCK_CNT) && (NULL != stats), ESP_ERR_INVALID_ARG);
+
+#if NFC_LOCK_STATS
+  *stats = m_nfc_lock[lock].stats;
+#else
+  memset(stats, 0, sizeof(bsp_nfc_lock_stats_t));
+#endif
+
+  return ESP_OK;
+}
+
+void bsp_nfc_lock_stats_reset(void)
+{
+#if NFC_LOCK_STATS
+  for (int i = 0; i < BSP_NFC_LOCK_CNT; i++)
+  {
+    m_nfc_lock[i].stats.count       = 0;
+    m_nfc_lock[i].stats.over_budget = 0;
+    m_nfc_lock[i].stats.max_us      = 0;
+  }
+#endif
 }
 
 void bsp_log_data(const char *format, ...)
@@ -162,34 +440,199 @@ static inline void bsp_spi_init(void)
 
   spi_bus_config_t bus_cfg =
   {
-    .miso_io_num   = IO_NFC_SPI_MISO,
-    .mosi_io_num   = IO_NFC_SPI_MOSI,
-    .sclk_io_num   = IO_NFC_SPI_CLK,
-    .quadwp_io_num = -1,
-    .quadhd_io_num = -1
+    .miso_io_num     = IO_NFC_SPI_MISO,
+    .mosi_io_num     = IO_NFC_SPI_MOSI,
+    .sclk_io_num     = IO_NFC_SPI_CLK,
+    .quadwp_io_num   = -1,
+    .quadhd_io_num   = -1,
+    .max_transfer_sz = 512
   };
 
-  spi_device_interface_config_t dev_cfg =
-  {
-    .clock_speed_hz = 1000000,   // Clock out at 1 MHz
-    .mode           = 0,         // SPI mode 0
-    .spics_io_num   = -1,        // CS pin
-    .queue_size     = 7,         // We want to be able to queue 7 transactions at a time
-  };
+  m_spi_tx_buf = heap_caps_malloc(NFC_SPI_BUF_SIZE, MALLOC_CAP_DMA);
+  m_spi_rx_buf = heap_caps_malloc(NFC_SPI_BUF_SIZE, MALLOC_CAP_DMA);
+  assert((m_spi_tx_buf != NULL) && (m_spi_rx_buf != NULL));
 
   // Initialize the SPI bus
   ret = spi_bus_initialize(HSPI_HOST, &bus_cfg, 1);
   assert(ret == ESP_OK);
 
-  // Attach the LCD to the SPI bus
-  ret = spi_bus_add_device(HSPI_HOST, &dev_cfg, &m_spi_hdl);
+  // Attach the NFC reader to the SPI bus
+  ret = m_bsp_spi_add_device();
   assert(ret == ESP_OK);
+
+  // The NFC IRQ task reads the chip concurrently with the RFAL caller.
+  // Recursive: the register shadow keeps it across a read-modify-write or a batch flush.
+  m_nfc_comm_mutex = xSemaphoreCreateRecursiveMutex();
+  assert(m_nfc_comm_mutex != NULL);
+
+  m_nfc_worker_mutex = xSemaphoreCreateRecursiveMutex();
+  assert(m_nfc_worker_mutex != NULL);
+}
+
+static esp_err_t m_bsp_spi_transfer(uint8_t cmd_bits, uint8_t cmd, const uint8_t *tx_data, uint8_t *rx_data, uint16_t len)
+{
+  esp_err_t ret;
+  spi_transaction_t *t = &m_spi_trans.base;
+  spi_transaction_t *done;
+  bool rx_bounce = false;
+
+  if ((0 == len) && (0 == cmd_bits))
+    return ESP_OK;
+
+  // Lost on a failed clock change
+  CHECK(NULL != m_spi_hdl, ESP_ERR_INVALID_STATE);
+
+  t->flags                  = SPI_TRANS_VARIABLE_CMD;
+  t->cmd                    = cmd;
+  t->length                 = len * 8;    // Len is in bytes, transaction length is in bits.
+  t->rxlength               = 0;          // Same as length
+  t->user                   = NULL;
+  t->tx_buffer              = tx_data;
+  t->rx_buffer              = rx_data;
+  m_spi_trans.command_bits  = cmd_bits;   // Command byte goes out in its own phase, ahead of the payload
+
+  if (len <= 4)
+  {
+    // Fits in the descriptor itself, no DMA buffer involved
+    t->flags |= SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
+    memset(t->tx_data, 0, sizeof(t->tx_data));
+    if (NULL != tx_data)
+      memcpy(t->tx_data, tx_data, len);
+  }
+  else if (len <= NFC_SPI_BUF_SIZE)
+  {
+    // Zero copy whenever the DMA can use the caller buffer as is
+    if ((NULL != tx_data) && (!esp_ptr_dma_capable(tx_data) || (0 != ((uint32_t)tx_data & 3U))))
+    {
+      memcpy(m_spi_tx_buf, tx_data, len);
+      t->tx_buffer = m_spi_tx_buf;
+    }
+
+    rx_bounce = (NULL != rx_data) && (!esp_ptr_dma_capable(rx_data) || (0 != ((uint32_t)rx_data & 3U)));
+    if (rx_bounce)
+      t->rx_buffer = m_spi_rx_buf;
+  }
+
+  if (len <= NFC_SPI_POLLING_MAX)
+  {
+    // Register access: busy-wait is shorter than the ISR + context switch round trip
+    ret = spi_device_polling_transmit(m_spi_hdl, t);
+  }
+  else
+  {
+    // FIFO access: let the DMA run and give the CPU away until it is done
+    ret = spi_device_queue_trans(m_spi_hdl, t, portMAX_DELAY);
+    if (ESP_OK == ret)
+      ret = spi_device_get_trans_result(m_spi_hdl, &done, portMAX_DELAY);
+  }
+
+  if (ESP_OK != ret)
+  {
+    ESP_LOGE(TAG, "SPI transfer of %d bytes failed: %s", len, esp_err_to_name(ret));
+    return ret;
+  }
+
+  if (NULL != rx_data)
+  {
+    if (len <= 4)
+      memcpy(rx_data, t->rx_data, len);
+    else if (rx_bounce)
+      memcpy(rx_data, m_spi_rx_buf, len);
+  }
+
+  return ESP_OK;
+}
+
+static esp_err_t m_bsp_spi_add_device(void)
+{
+  esp_err_t ret;
+
+  spi_device_interface_config_t dev_cfg =
+  {
+    .clock_speed_hz = m_spi_clock_hz,
+    .mode           = 0,               // SPI mode 0
+    .spics_io_num   = IO_NFC_SPI_SS,   // CS driven by the SPI peripheral, framed per transaction
+    .queue_size     = 1,               // Transfers are synchronous, one descriptor in flight
+  };
+
+  ret = spi_bus_add_device(HSPI_HOST, &dev_cfg, &m_spi_hdl);
+  if (ESP_OK != ret)
+  {
+    m_spi_hdl = NULL;
+    return ret;
+  }
+
+  // Only device on the bus: hold it, so transfers skip the bus arbitration
+  return spi_device_acquire_bus(m_spi_hdl, portMAX_DELAY);
 }
 
 static inline void bsp_gpio_init(void)
 {
-  gpio_pad_select_gpio(IO_NFC_SPI_SS);
-  gpio_set_direction(IO_NFC_SPI_SS, GPIO_MODE_OUTPUT);
+  // NFC SPI SS is owned by the SPI peripheral, see m_bsp_spi_add_device()
+}
+
+static void IRAM_ATTR m_bsp_nfc_irq_isr(void *arg)
+{
+  BaseType_t woken = pdFALSE;
+
+  // Nothing but a wake-up here, the SPI access happens in task context
+  vTaskNotifyGiveFromISR(m_nfc_irq_task, &woken);
+
+  if (pdTRUE == woken)
+    portYIELD_FROM_ISR();
+}
+
+static void m_bsp_nfc_irq_task(void *arg)
+{
+  TaskHandle_t waiter;
+
+  while (1)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    // The callback drains IRQ_MAIN..IRQ_ERROR_WUP in one burst for as long as the line is high
+    if (NULL != m_nfc_irq_cb)
+      m_nfc_irq_cb();
+
+    waiter = m_nfc_irq_waiter;
+    if (NULL != waiter)
+      xTaskNotifyGive(waiter);
+  }
+}
+
+static void m_bsp_nfc_irq_wait_expired(void *arg)
+{
+  TaskHandle_t waiter = m_nfc_irq_waiter;
+
+  if ((NULL != waiter) && m_nfc_irq_wait_armed)
+    xTaskNotifyGive(waiter);
+}
+
+static inline void m_bsp_nfc_lock_taken(bsp_nfc_lock_t lock)
+{
+#if NFC_LOCK_STATS
+  // esp_timer, not the cycle counter: a task may change core while holding a mutex
+  if (0 == m_nfc_lock[lock].depth++)
+    m_nfc_lock[lock].t0 = esp_timer_get_time();
+#endif
+}
+
+static inline void m_bsp_nfc_lock_released(bsp_nfc_lock_t lock)
+{
+#if NFC_LOCK_STATS
+  uint32_t held;
+
+  if (0 != --m_nfc_lock[lock].depth)
+    return;
+
+  held = (uint32_t)(esp_timer_get_time() - m_nfc_lock[lock].t0);
+
+  m_nfc_lock[lock].stats.count++;
+  if (held > m_nfc_lock[lock].stats.max_us)
+    m_nfc_lock[lock].stats.max_us = held;
+  if (held > m_nfc_lock[lock].stats.budget_us)
+    m_nfc_lock[lock].stats.over_budget++;
+#endif
 }
 
 /* End of file -------------------------------------------------------- */
\ No newline at end of file
@@ -26,6 +26,45 @@
 #define IRQ_OUT_PIN             (-1)    // NFC
 #define IRQ_IN_PIN              (-1)   // NFC
 
+#define NFC_SPI_CLOCK_MAX_HZ    (6000000)             // ST25R3911 SPI limit
+#ifndef NFC_SPI_CLOCK_HZ
+#define NFC_SPI_CLOCK_HZ        (NFC_SPI_CLOCK_MAX_HZ)
+#endif
+#define NFC_SPI_BUF_SIZE        (128)                 // DMA bounce buffer, covers a full 96 byte FIFO access
+#define NFC_SPI_POLLING_MAX     (16)                  // Transfers up to this length are polled, longer ones are queued
+
+#ifndef NFC_LOCK_STATS
+#define NFC_LOCK_STATS          (1)                   // Lock hold time instrumentation
+#endif
+#define NFC_COMM_LOCK_BUDGET_US       (500)           // Longest SPI sequence: batch flush or full FIFO access
+#define NFC_IRQ_STATUS_LOCK_BUDGET_US (10)            // Critical section, a few loads and stores
+#define NFC_WORKER_LOCK_BUDGET_US     (2000)          // One rfalWorker() pass
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief NFC locks
+ */
+typedef enum
+{
+  BSP_NFC_LOCK_COMM = 0,    // SPI communication and register shadow, recursive mutex
+  BSP_NFC_LOCK_IRQ_STATUS,  // IRQ status, critical section
+  BSP_NFC_LOCK_WORKER,      // RFAL worker, recursive mutex
+  BSP_NFC_LOCK_CNT
+}
+bsp_nfc_lock_t;
+
+/**
+ * @brief NFC lock hold time statistics, outermost take to last give
+ */
+typedef struct
+{
+  uint32_t count;           // Times held
+  uint32_t over_budget;     // Times held longer than the budget
+  uint32_t max_us;          // Longest hold
+  uint32_t budget_us;       // Hold time budget
+}
+bsp_nfc_lock_stats_t;
+
 /* Public variables --------------------------------------------------- */
 /* Public function prototypes ----------------------------------------- */
 /**
@@ -40,14 +79,174 @@
 void bsp_init(void);
 /**
  * @brief         Spi transmit and receive
- * @param[in]     <tx_data>     Pointer to transmit data
- *                <rx_data>     Pointer to receive data
+ * @param[in]     <tx_data>     Pointer to transmit data, NULL to clock out zeros
+ *                <rx_data>     Pointer to receive data, NULL to discard
  *                <len>         Transmit data length
  *
+ * @attention     Short transfers are polled, longer ones are queued to the DMA
+ *                and the caller blocks until done
+ * @return        ESP_OK on success, driver error otherwise
+ */
+esp_err_t bsp_spi_transmit_receive(const uint8_t *tx_data, uint8_t *rx_data, uint16_t len);
+
+/**
+ * @brief         Spi transfer of a command byte followed by a payload, in one transaction
+ * @param[in]     <cmd>         Command byte, sent in the command phase
+ *                <tx_data>     Pointer to payload to transmit, NULL to clock out zeros
+ *                <rx_data>     Pointer to receive the payload, NULL to discard
+ *                <len>         Payload length, 0 sends the command only
+ *
+ * @attention     Caller buffers are handed to the DMA directly when possible, no staging copy
+ * @return        ESP_OK on success, driver error otherwise
+ */
+esp_err_t bsp_spi_command_transfer(uint8_t cmd, const uint8_t *tx_data, uint8_t *rx_data, uint16_t len);
+
+/**
+ * @brief         Change the NFC SPI clock
+ * @param[in]     <clock_hz>    Clock in Hz, up to NFC_SPI_CLOCK_MAX_HZ
+ *
+ * @attention     Must not be called while a transfer is in progress.
+ *                On failure the former clock is kept, if the device cannot be
+ *                attached again the transfers fail with ESP_ERR_INVALID_STATE.
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG if out of range,
+ *                ESP_ERR_INVALID_STATE without a device, driver error otherwise
+ */
+esp_err_t bsp_spi_set_clock(uint32_t clock_hz);
+
+/**
+ * @brief         Configure the NFC IRQ line and start the deferred IRQ task
+ *
+ * @param[in]     None
+ *
+ * @attention     The GPIO ISR only wakes the IRQ task, the chip is drained in task context
+ * @return        None
+ */
+void bsp_nfc_irq_init(void);
+
+/**
+ * @brief         Set the handler run by the IRQ task on every NFC interrupt
+ * @param[in]     <cb>          Pointer to handler, NULL to detach
+ *
+ * @attention     None
+ * @return        None
+ */
+void bsp_nfc_irq_set_callback(void (*cb)(void));
+
+/**
+ * @brief         Set the task notified after every drained IRQ burst
+ * @param[in]     <task>        Task handle, NULL to stop notifying
+ *
+ * @attention     None
+ * @return        None
+ */
+void bsp_nfc_irq_set_waiter(TaskHandle_t task);
+
+/**
+ * @brief         Block the calling task until the next drained IRQ burst or timeout
+ * @param[in]     <timeout_us>  Timeout in microseconds, 0 waits forever
+ *
+ * @attention     The caller must be the registered waiter, see bsp_nfc_irq_set_waiter().
+ *                May return early, callers re-check their condition.
+ * @return        None
+ */
+void bsp_nfc_irq_wait(uint32_t timeout_us);
+
+/**
+ * @brief         Check the NFC IRQ line level, including a pending simulated pulse
+ * @param[in]     None
+ *
+ * @attention     A simulated pulse reads high once, then falls back to the real line
+ * @return        true if the line is high
+ */
+bool bsp_nfc_irq_is_high(void);
+
+/**
+ * @brief         Raise a simulated NFC IRQ pulse and run the IRQ path as the ISR would
+ * @param[in]     None
+ *
+ * @attention     Used to exercise the IRQ path without the chip driving the line
+ * @return        None
+ */
+void bsp_nfc_irq_simulate(void);
+
+/**
+ * @brief         Light-sleep the ESP32 until the NFC IRQ line goes high or timeout
+ * @param[in]     <timeout_us>  Timeout in microseconds, 0 for none
+ *
+ * @attention     Stops every task, both cores and the APB bus until woken. Returns at
+ *                once if the line is already high. A pending IRQ goes to the IRQ task.
+ * @return        ESP_OK on success, error of the sleep driver otherwise
+ */
+esp_err_t bsp_nfc_light_sleep(uint32_t timeout_us);
+
+/**
+ * @brief         Lock/unlock the NFC chip SPI communication
+ * @param[in]     None
+ *
+ * @attention     Recursive, a sequence of accesses can be made atomic by the caller
+ * @return        None
+ */
+void bsp_nfc_comm_lock(void);
+void bsp_nfc_comm_unlock(void);
+
+/**
+ * @brief         Lock/unlock the RFAL worker
+ * @param[in]     None
+ *
+ * @attention     Recursive. Held by rfalWorker() and the RFAL calls that configure the
+ *                chip or run a transceive, each call is atomic. A sequence of calls
+ *                (activation, protocol exchange) is not, run it on the NFC worker task.
+ * @return        None
+ */
+void bsp_nfc_worker_lock(void);
+void bsp_nfc_worker_unlock(void);
+
+/**
+ * @brief         Set the handler putting the RFAL worker to sleep while a transceive is busy
+ * @param[in]     <wait>        Pointer to handler, NULL to detach
+ *
+ * @attention     Registered by the task owning the RFAL
+ * @return        None
+ */
+void bsp_nfc_worker_set_wait(void (*wait)(void));
+
+/**
+ * @brief         Sleep the RFAL worker until the next IRQ, request or SW timer poll
+ * @param[in]     None
+ *
+ * @attention     Sleeps a tick without a handler, callers re-check their condition
+ * @return        None
+ */
+void bsp_nfc_worker_wait(void);
+
+/**
+ * @brief         Enter/exit the critical section guarding the NFC IRQ status
+ * @param[in]     None
+ *
+ * @attention     Must not block inside, no SPI access allowed
+ * @return        None
+ */
+void bsp_nfc_irq_status_lock(void);
+void bsp_nfc_irq_status_unlock(void);
+
+/**
+ * @brief         Get the hold time statistics of a NFC lock
+ * @param[in]     <lock>        Lock
+ * @param[out]    <stats>       Pointer to statistics
+ *
+ * @attention     Snapshot taken without the lock, a field may be one hold behind
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG otherwise
+ */
+esp_err_t bsp_nfc_lock_stats_get(bsp_nfc_lock_t lock, bsp_nfc_lock_stats_t *stats);
+
+/**
+ * @brief         Clear the hold time statistics of all NFC locks
+ * @param[in]     None
+ *
  * @attention     None
  * @return        None
  */
-void bsp_spi_transmit_receive(const uint8_t *tx_data, uint8_t *rx_data, uint16_t len);
+void bsp_nfc_lock_stats_reset(void);
 
 /**
  * @brief         Logging data
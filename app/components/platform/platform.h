@@ -26,7 +26,7 @@
 #define ST25R391X_SS_PIN                        (IO_NFC_SPI_SS)        /*!< GPIO pin used for ST25R391X SPI SS                               */
 #define ST25R391X_SS_PORT                       (-1)                   /*!< GPIO port used for ST25R391X SPI SS port                         */
 
-#define ST25R391X_IRQ_OUT_PIN                   (IO_NFC_IRQ_OUT_PIN)   /*!< GPIO pin used for ST25R391X nIRQ_OUT                             */
+#define ST25R391X_IRQ_OUT_PIN                   (-1)                   /*!< GPIO pin used for ST25R391X nIRQ_OUT, not routed on HW 1.1       */
 #define ST25R391X_IRQ_OUT_PORT                  (-1)                   /*!< GPIO port used for ST25R391X nIRQ_OUT                            */
 
 #define ST25R391X_INT_PIN                       (IO_NFC_IRQ_IN_PIN)    /*!< GPIO pin used for ST25R391X nIRQ_IN                              */
@@ -44,7 +44,7 @@
 ******************************************************************************
 */
 #define RFAL_FEATURE_LISTEN_MODE               (false)    /*!< Enable/Disable RFAL support for Listen Mode                               */
-#define RFAL_FEATURE_WAKEUP_MODE               (false)    /*!< Enable/Disable RFAL support for the Wake-Up mode                          */
+#define RFAL_FEATURE_WAKEUP_MODE               (true)     /*!< Enable/Disable RFAL support for the Wake-Up mode                          */
 
 #define RFAL_FEATURE_NFCA                      (true)     /*!< Enable/Disable RFAL support for NFC-A (ISO14443A)                         */
 #define RFAL_FEATURE_NFCB                      (true)    /*!< Enable/Disable RFAL support for NFC-B (ISO14443B)                         */
@@ -71,6 +71,8 @@
 #define RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN      (1024U)    /*!< ISO-DEP APDU max length.                                                  */
 #define RFAL_FEATURE_NFC_DEP_PDU_MAX_LEN       (512U)     /*!< NFC-DEP PDU max length.                                                   */
 
+#define RFAL_FEATURE_CRC_ENGINE                (2U)       /*!< Software CRC engine: 0 bitwise, 1 table (512 bytes), 2 slice-by-4 (2 kbytes) */
+
 
 #define platformLedOn( port, pin )         
 #define platformLedOff( port, pin )        
@@ -80,11 +82,14 @@
 #define platformGpioClear(port, pin)           gpio_set_level(pin, 0)             /*!< Turns the given GPIO Low                          */
 #define platformGpioIsHigh(port, pin)          (gpio_get_level(pin) == 1)         /*!< Checks if the given LED is High                   */
 #define platformGpioIsLow(port, pin)           (gpio_get_level(pin) == 0)         /*!< Checks if the given LED is Low                    */
+#define platformIrqST25R3911PinIsHigh()        bsp_nfc_irq_is_high()              /*!< Checks the IRQ line, simulated pulses included     */
 
-#define platformTimerCreate(t)                 xTaskGetTickCount() //timerCalculateTimer(t)             /*!< Create a timer with the given time (ms)           */
-#define platformTimerIsExpired(timer)          xTaskGetTickCount() //timerIsExpired(timer)              /*!< Checks if the given timer is expired              */
+#define platformTimerCreate(t)                 timerCalculateTimer(t)             /*!< Create a timer with the given time (ms)           */
+#define platformTimerCreateUs(t)               timerCalculateTimer_us(t)          /*!< Create a timer with the given time (us)           */
+#define platformTimerIsExpired(timer)          timerIsExpired(timer)              /*!< Checks if the given timer is expired              */
 #define platformDelay(t)                       vTaskDelay(pdMS_TO_TICKS(t))       /*!< Performs a delay for the given time (ms)          */
 #define platformGetSysTick()                   xTaskGetTickCount()                /*!< Get System Tick ( 1 tick = 1 ms)                  */
+#define platformGetTimeUs()                    ((uint64_t)esp_timer_get_time())   /*!< Get time since boot in us                         */
 #define platformLog(...)                       bsp_log_data(__VA_ARGS__)          /*!< Log  method                                       */
 #define platformTimerDestroy( timer )
 #define platformErrorHandle()
@@ -105,21 +110,26 @@
 #define PLATFORM_USER_BUTTON_PIN     (-1)
 
 #if !(ST25R391X_INTERFACE_UART) /* ST25R391X_INTERFACE_SPI */
-/*!< SPI SS\CS: Chip|Slave Select                */
-#define platformSpiSelect()                    platformGpioClear(ST25R391X_SS_PORT, ST25R391X_SS_PIN)
+#define ST25R391X_COM_CMDPHASE                                    /*!< Command byte and payload in one SPI transaction */
+
+/*!< SPI SS\CS: Chip|Slave Select, driven by the SPI peripheral */
+#define platformSpiSelect()
 
-/*!< SPI SS\CS: Chip|Slave Deselect              */
-#define platformSpiDeselect()                  platformGpioSet(ST25R391X_SS_PORT, ST25R391X_SS_PIN)
+/*!< SPI SS\CS: Chip|Slave Deselect, driven by the SPI peripheral */
+#define platformSpiDeselect()
 
 /*!< SPI transceive                              */
 #define platformSpiTxRx(txBuf, rxBuf, len)     bsp_spi_transmit_receive(txBuf, rxBuf, len)
 
+/*!< SPI command byte + payload transceive       */
+#define platformSpiCmdTxRx(cmd, txBuf, rxBuf, len)  bsp_spi_command_transfer(cmd, txBuf, rxBuf, len)
+
 #define platformUartTx(TxBuf, len)                        /*!< UART transceive                             */
 #define platformUartRx(RxBuf, len)                        /*!< UART transceive                             */
 #else /* ! ST25R391X_INTERFACE_SPI */
 #define platformSpiSelect()                               /*!< SPI SS\CS: Chip|Slave Select                */
 #define platformSpiDeselect()                             /*!< SPI SS\CS: Chip|Slave Deselect              */
-#define platformSpiTxRx(txBuf, rxBuf, len)                /*!< SPI transceive                              */
+#define platformSpiTxRx(txBuf, rxBuf, len)             (0) /*!< SPI transceive, no bus: always done      */
 #define platformUartTx(TxBuf, len)                        /*!< UART transceive                             */
 #define platformUartRx(RxBuf, len)                        /*!< UART transceive                             */
 #define platformUartTxIT(TxBuf, len)                      /*!< UART transceive                             */
@@ -129,20 +139,27 @@
 
 
 /* Protect RFAL Worker/Task/Process from concurrent execution on multi thread platforms   */
-#define platformProtectWorker()             
-#define platformProtectST25R391xComm()
-#define platformProtectST25R391xIrqStatus()
-#define platformIrqST25R3911PinInitialize()
-#define platformIrqST25R3911SetCallback(data)
+#define platformProtectWorker()                bsp_nfc_worker_lock()
+#define platformProtectST25R391xComm()         bsp_nfc_comm_lock()
+#define platformProtectST25R391xIrqStatus()    bsp_nfc_irq_status_lock()
+#define platformIrqST25R3911PinInitialize()    bsp_nfc_irq_init()
+#define platformIrqST25R3911SetCallback(data)  bsp_nfc_irq_set_callback(data)
+#define platformIrqST25R3911WaitBegin()        bsp_nfc_irq_set_waiter(xTaskGetCurrentTaskHandle())   /*!< Route IRQ notifications to the calling task */
+#define platformIrqST25R3911Wait(us)           bsp_nfc_irq_wait(us)                                  /*!< Block until next IRQ burst or timeout (us)  */
+#define platformIrqST25R3911WaitEnd()          bsp_nfc_irq_set_waiter(NULL)
+#define platformWorkerWait()                   bsp_nfc_worker_wait()                                /*!< Sleep the worker until next IRQ, request or SW timer poll */
+#define platformGetTaskId()                    ((void *)xTaskGetCurrentTaskHandle())                /*!< Identify the calling task, owner of a register batch     */
 
 /* Unprotect RFAL Worker/Task/Process from concurrent execution on multi thread platforms */
-#define platformUnprotectWorker()
-#define platformUnprotectST25R391xComm()
-#define platformUnprotectST25R391xIrqStatus()
+#define platformUnprotectWorker()              bsp_nfc_worker_unlock()
+#define platformUnprotectST25R391xComm()       bsp_nfc_comm_unlock()
+#define platformUnprotectST25R391xIrqStatus()  bsp_nfc_irq_status_unlock()
 #define platformLedsInitialize()
 
 char *hex2Str(unsigned char *data, size_t dataLen);
 
+#include "timer.h"
+
 #endif /* PLATFORM_H */
 
 /* End of file -------------------------------------------------------- */
\ No newline at end of file
@@ -39,6 +39,10 @@ extern "C" {
 #include "esp_system.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
+#include "esp_heap_caps.h"
+#include "soc/soc_memory_layout.h"
 #include "esp32/clk.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
@@ -172,6 +172,28 @@ ReturnCode rfalChipReadTestReg( uint16_t reg, uint8_t* value );
  */
 ReturnCode rfalChipChangeTestRegBits( uint16_t reg, uint8_t valueMask, uint8_t value );
 
+/*!
+ *****************************************************************************
+ * \brief Start a batch of register writes on the RF Chip
+ *
+ * Register writes and bit changes up to the matching rfalChipBatchCommit()
+ * may be held back and written in bulk. Batches can be nested.
+ *
+ *****************************************************************************
+ */
+void rfalChipBatchStart( void );
+
+/*!
+ *****************************************************************************
+ * \brief Commit a batch of register writes on the RF Chip
+ *
+ * Closes the batch opened by rfalChipBatchStart(). The outermost commit
+ * writes all the changes held back to the RF Chip.
+ *
+ *****************************************************************************
+ */
+void rfalChipBatchCommit( void );
+
 /*!
  *****************************************************************************
  * \brief Execute command on the RF Chip
@@ -399,6 +399,19 @@ typedef struct
     uint8_t                  DID;                      /*!< Device ID (RFAL_ISODEP_NO_DID if no DID) */
 } rfalIsoDepApduTxRxParam;
 
+
+/*! ISO-DEP PCD session state, one per activated PICC when several are kept active using DIDs */
+typedef struct
+{
+    uint8_t              blockNumber;                  /*!< Current block number                     */
+    uint8_t              DID;                          /*!< Device ID (RFAL_ISODEP_NO_DID if no DID) */
+    uint8_t              NAD;                          /*!< Node Address (RFAL_ISODEP_NO_NAD if none)*/
+    uint32_t             FWT;                          /*!< Frame Waiting Time (1/fc)                */
+    uint32_t             dFWT;                         /*!< Delta Frame Waiting Time (1/fc)          */
+    uint16_t             FSx;                          /*!< Other device Frame Size (FSC)            */
+    uint16_t             ourFSx;                       /*!< Our device Frame Size (FSD)              */
+} rfalIsoDepSession;
+
 /*
  ******************************************************************************
  * GLOBAL FUNCTION PROTOTYPES
@@ -572,6 +585,63 @@ ReturnCode rfalIsoDepListenGetActivationStatus( void );
 uint16_t rfalIsoDepGetMaxInfLen( void );
 
 
+/*!
+ *****************************************************************************
+ *  \brief  ISO-DEP Save Session
+ *  
+ *  Stores the state of the PICC currently being communicated with: block
+ *  number, DID, NAD, FWT and frame sizes. 
+ *  Together with rfalIsoDepRestoreSession() it allows several PICCs, 
+ *  each activated with its own DID, to be kept active and served in turn
+ *
+ *  \param[out] session : location to store the session state
+ *
+ *  \return ERR_PARAM       : Invalid parameters
+ *  \return ERR_WRONG_STATE : Not in Poller mode or a transceive is ongoing
+ *  \return ERR_NONE        : No error
+ *****************************************************************************
+ */
+ReturnCode rfalIsoDepSaveSession( rfalIsoDepSession *session );
+
+
+/*!
+ *****************************************************************************
+ *  \brief  ISO-DEP Restore Session
+ *  
+ *  Makes the PICC whose state was stored by rfalIsoDepSaveSession() the one
+ *  being communicated with. The next block exchanged with it continues its
+ *  block numbering
+ *
+ *  \param[in]  session : session state to restore
+ *
+ *  \return ERR_PARAM       : Invalid parameters
+ *  \return ERR_WRONG_STATE : Not in Poller mode or a transceive is ongoing
+ *  \return ERR_NONE        : No error
+ *****************************************************************************
+ */
+ReturnCode rfalIsoDepRestoreSession( const rfalIsoDepSession *session );
+
+
+/*!
+ *****************************************************************************
+ *  \brief  ISO-DEP Presence Check
+ *  
+ *  Checks whether the PICC currently being communicated with is still in 
+ *  the field, in one round trip and without disturbing its state.
+ *  An R(NAK) is sent, to which the PICC answers with an R(ACK) 
+ *  ISO14443-4  7.5.4.2  rule 11 / NFC Forum Digital 1.1  15.2.5
+ *  
+ *  This method is blocking
+ *
+ *  \return ERR_WRONG_STATE : Not in Poller mode or a transceive is ongoing
+ *  \return ERR_TIMEOUT     : Timeout error, the PICC is gone
+ *  \return ERR_PROTO       : Protocol error detected, not an R(ACK) of this PICC
+ *  \return ERR_NONE        : No error, PICC present
+ *****************************************************************************
+ */
+ReturnCode rfalIsoDepPresenceCheck( void );
+
+
 /*!
  *****************************************************************************
  *  \brief ISO-DEP Start Transceive 
@@ -112,6 +112,15 @@ enum{
 };
 
 
+/*! NFC-V Get System Information info flags   ISO15693-3 2019 10.4.12 */
+enum{
+    RFAL_NFCV_SYSINFO_DFSID              = 0x01,       /*!< DSFID present                   */
+    RFAL_NFCV_SYSINFO_AFI                = 0x02,       /*!< AFI present                     */
+    RFAL_NFCV_SYSINFO_MEMSIZE            = 0x04,       /*!< Memory size present             */
+    RFAL_NFCV_SYSINFO_ICREF              = 0x08,       /*!< IC reference present            */
+    RFAL_NFCV_SYSINFO_REQ_ALL            = 0x0F,       /*!< Extended request: all the above */
+};
+
 /*! NFC-V command set   ISO15693 2000 9.1 */
 enum 
 {
@@ -129,6 +138,8 @@ enum
     RFAL_NFCV_CMD_EXTENDED_WRITE_SINGLE_BLOCK   = 0x31,      /*!< Extended write single block command                          */
     RFAL_NFCV_CMD_EXTENDED_LOCK_SINGLE_BLOCK    = 0x32,      /*!< Extended lock single block command                           */
     RFAL_NFCV_CMD_EXTENDED_READ_MULTIPLE_BLOCK  = 0x33,      /*!< Extended read multiple block command                         */
+    RFAL_NFCV_CMD_EXTENDED_WRITE_MULTIPLE_BLOCK = 0x34,      /*!< Extended write multiple block command                        */
+    RFAL_NFCV_CMD_EXTENDED_GET_SYS_INFO         = 0x3B,      /*!< Extended Get System Information command                      */
     
 };
 
@@ -508,6 +519,62 @@ ReturnCode rfalNfcvPollerExtendedWriteSingleBlock( uint8_t flags, const uint8_t*
  */
 ReturnCode rfalNfcvPollerExtendedReadMultipleBlocks( uint8_t flags, const uint8_t* uid, uint16_t firstBlockNum, uint16_t numOfBlocks, uint8_t* rxBuf, uint16_t rxBufLen, uint16_t *rcvLen );
 
+/*! 
+ *****************************************************************************
+ * \brief  NFC-V Poller Get System Information
+ *  
+ * Gets the System Information of a device (VICC): DSFID, AFI, memory size
+ * and IC reference, each present if signalled in the info flags.
+ * The memory size holds up to 256 blocks
+ *
+ * \param[in]  flags          : Flags to be used: Sub-carrier; Data_rate; Option
+ *                              for NFC-Forum use: RFAL_NFCV_REQ_FLAG_DEFAULT
+ * \param[in]  uid            : UID of the device
+ *                               if not provided Select mode will be used 
+ * \param[out] rxBuf          : buffer to store response (also with RES_FLAGS)
+ * \param[in]  rxBufLen       : length of rxBuf
+ * \param[out] rcvLen         : number of bytes received
+ *  
+ * \return ERR_WRONG_STATE    : RFAL not initialized or incorrect mode
+ * \return ERR_PARAM          : Invalid parameters
+ * \return ERR_IO             : Generic internal error 
+ * \return ERR_CRC            : CRC error detected
+ * \return ERR_FRAMING        : Framing error detected
+ * \return ERR_PROTO          : Protocol error detected
+ * \return ERR_TIMEOUT        : Timeout error
+ * \return ERR_NONE           : No error
+ *****************************************************************************
+ */
+ReturnCode rfalNfcvPollerGetSystemInformation( uint8_t flags, const uint8_t* uid, uint8_t* rxBuf, uint16_t rxBufLen, uint16_t *rcvLen );
+
+/*! 
+ *****************************************************************************
+ * \brief  NFC-V Poller Extended Get System Information
+ *  
+ * Gets the System Information of a device (VICC) whose memory exceeds 
+ * 256 blocks: the memory size holds a 16 bits number of blocks
+ *
+ * \param[in]  flags          : Flags to be used: Sub-carrier; Data_rate; Option
+ *                              for NFC-Forum use: RFAL_NFCV_REQ_FLAG_DEFAULT
+ * \param[in]  uid            : UID of the device
+ *                               if not provided Select mode will be used 
+ * \param[in]  requestField   : information requested, RFAL_NFCV_SYSINFO_xxx
+ * \param[out] rxBuf          : buffer to store response (also with RES_FLAGS)
+ * \param[in]  rxBufLen       : length of rxBuf
+ * \param[out] rcvLen         : number of bytes received
+ *  
+ * \return ERR_WRONG_STATE    : RFAL not initialized or incorrect mode
+ * \return ERR_PARAM          : Invalid parameters
+ * \return ERR_NOTSUPP        : Command not supported by the device
+ * \return ERR_CRC            : CRC error detected
+ * \return ERR_FRAMING        : Framing error detected
+ * \return ERR_PROTO          : Protocol error detected
+ * \return ERR_TIMEOUT        : Timeout error
+ * \return ERR_NONE           : No error
+ *****************************************************************************
+ */
+ReturnCode rfalNfcvPollerExtendedGetSystemInformation( uint8_t flags, const uint8_t* uid, uint8_t requestField, uint8_t* rxBuf, uint16_t rxBufLen, uint16_t *rcvLen );
+
 #endif /* RFAL_NFCV_H */
 
 /**
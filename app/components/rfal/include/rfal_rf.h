@@ -165,7 +165,7 @@
 #define rfalConv1fcToMs( t )                 (uint32_t)( (uint32_t)(t) / RFAL_1MS_IN_1FC )                               /*!< Converts the given t from 1/fc to ms       */
 #define rfalConvMsTo1fc( t )                 (uint32_t)( (uint32_t)(t) * RFAL_1MS_IN_1FC )                               /*!< Converts the given t from ms to 1/fc       */
 
-#define rfalConv1fcToUs( t )                 (uint32_t)( ((uint32_t)(t) * RFAL_US_IN_MS) / RFAL_1MS_IN_1FC)              /*!< Converts the given t from 1/fc to us       */
+#define rfalConv1fcToUs( t )                 (uint32_t)( ((uint64_t)(t) * RFAL_US_IN_MS) / RFAL_1MS_IN_1FC)              /*!< Converts the given t from 1/fc to us       */
 #define rfalConvUsTo1fc( t )                 (uint32_t)( ((uint32_t)(t) * RFAL_1MS_IN_1FC) / RFAL_US_IN_MS)              /*!< Converts the given t from us to 1/fc       */
 
 #define rfalConv64fcToMs( t )                (uint32_t)( (uint32_t)(t) / (RFAL_1MS_IN_1FC / RFAL_1FC_IN_64FC) )          /*!< Converts the given t from 64/fc to ms      */
@@ -393,6 +393,17 @@ typedef struct {
 } rfalTransceiveContext;
 
 
+/*! Struct that holds the Rx FIFO statistics, see rfalGetRxStats()                                          */
+typedef struct {
+    uint32_t              frames;                 /*!< Frames received                                      */
+    uint32_t              nearMisses;             /*!< Frames whose FIFO got within 8 bytes of full         */
+    uint32_t              overflows;              /*!< Frames which lost bytes on a FIFO overflow           */
+    uint16_t              lastFrameLen;           /*!< Length of the last frame in bytes                    */
+    uint8_t               lastPeakLevel;          /*!< Highest FIFO level seen on the last frame            */
+    uint8_t               lastDrains;             /*!< FIFO drains needed on the last frame                 */
+} rfalRxStats;
+
+
 /*! System callback to indicate an event that requires a system reRun        */
 typedef void (* rfalUpperLayerCallback)(void);
 
@@ -1066,11 +1077,34 @@ rfalTransceiveState rfalGetTransceiveState( void );
  * \return  ERR_LINK_LOSS    : Link Loss - External Field is Off
  * \return  ERR_RF_COLLISION : Collision detected
  * \return  ERR_IO           : Internal error
+ * \return  ERR_FIFO         : Rx FIFO overflow, bytes were lost
  *****************************************************************************
  */
 ReturnCode rfalGetTransceiveStatus( void );
 
 
+/*! 
+ *****************************************************************************
+ * \brief  Get Rx FIFO statistics
+ *  
+ * Long responses are drained from the FIFO by the IRQ context on every water
+ * level interrupt. These statistics tell how close the FIFO got to overflow,
+ * a frame that did overflow is reported as ERR_FIFO.
+ *
+ * \param[out] stats : location to copy the statistics to
+ *****************************************************************************
+ */
+void rfalGetRxStats( rfalRxStats *stats );
+
+
+/*! 
+ *****************************************************************************
+ * \brief  Clear Rx FIFO statistics
+ *****************************************************************************
+ */
+void rfalClearRxStats( void );
+
+
 /*! 
  *****************************************************************************
  * \brief  Is Transceive in Tx
@@ -1487,6 +1521,27 @@ ReturnCode rfalListenSetState( rfalLmState newSt );
 ReturnCode rfalWakeUpModeStart( const rfalWakeUpConfig *config );
 
 
+/*!
+ *****************************************************************************
+ * \brief Wake-Up Mode Calibrate
+ *
+ * Measures the references of the measurements enabled on the given 
+ * configuration, averaging several measurements done with the field off.
+ * The result is stored on the configuration references, ready to be given 
+ * to rfalWakeUpModeStart() 
+ * 
+ * \param[in,out] config  : Wake-Up configuration whose references are set
+ * \param[in]     samples : number of measurements averaged per reference
+ * 
+ * \return ERR_WRONG_STATE : Not initialized properly or Wake-Up mode running
+ * \return ERR_PARAM       : Invalid parameter
+ * \return ERR_NONE        : Done with no error
+ * 
+ *****************************************************************************
+ */
+ReturnCode rfalWakeUpModeCalibrate( rfalWakeUpConfig *config, uint8_t samples );
+
+
 /*!
  *****************************************************************************
  * \brief Wake-Up Has Woke
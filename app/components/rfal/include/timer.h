@@ -34,6 +34,10 @@
  */
  
  
+ 
+#ifndef TIMER_H
+#define TIMER_H
+
  /*
 ******************************************************************************
 * INCLUDES
@@ -48,6 +52,15 @@
 */
 #define timerIsRunning(t)            (!timerIsExpired(t))
 
+/*
+******************************************************************************
+* GLOBAL TYPES
+******************************************************************************
+*/
+
+/*! Clock source returning a monotonic time in microseconds */
+typedef uint64_t (*timerClockSource)( void );
+
 /*
 ******************************************************************************
 * GLOBAL DEFINES
@@ -67,10 +80,25 @@
  *
  * \param[in]  time : time/duration in Milliseconds for the timer
  *
- * \return u32 : The new timer calculated based on the given time 
+ * \return u64 : The new timer calculated based on the given time 
  *****************************************************************************
  */
-uint32_t timerCalculateTimer( uint16_t time );
+uint64_t timerCalculateTimer( uint16_t time );
+
+
+ /*! 
+ *****************************************************************************
+ * \brief  Calculate Timer in microseconds
+ *  
+ * Same as timerCalculateTimer() with the duration given in microseconds.
+ * The timer holds an absolute 64 bit deadline and never wraps.
+ * 
+ * \param[in]  time_us : time/duration in microseconds for the timer
+ *
+ * \return u64 : The new timer calculated based on the given time 
+ *****************************************************************************
+ */
+uint64_t timerCalculateTimer_us( uint32_t time_us );
 
 
 /*! 
@@ -89,7 +117,19 @@ uint32_t timerCalculateTimer( uint16_t time );
  * \return false : timer is still running
  *****************************************************************************
  */
-bool timerIsExpired( uint32_t timer );
+bool timerIsExpired( uint64_t timer );
+
+
+/*! 
+ *****************************************************************************
+ * \brief  Remaining time of a Timer
+ *  
+ * \param[in]  timer : the timer to check 
+ *
+ * \return The time in microseconds until the timer expires, 0 if expired
+ *****************************************************************************
+ */
+uint64_t timerRemaining_us( uint64_t timer );
 
 
  /*! 
@@ -126,3 +166,30 @@ void timerStopwatchStart( void );
  *****************************************************************************
  */
 uint32_t timerStopwatchMeasure( void );
+
+
+/*! 
+ *****************************************************************************
+ * \brief  Stopwatch Measure in microseconds
+ *  
+ * \return The time in us since the stopwatch was started
+ *****************************************************************************
+ */
+uint32_t timerStopwatchMeasure_us( void );
+
+
+/*! 
+ *****************************************************************************
+ * \brief  Set the clock source
+ *  
+ * Replaces the clock the timers are based on, e.g. by a fake clock when
+ * running on a host. Timers calculated against the previous clock are not
+ * converted.
+ * 
+ * \param[in]  clock : clock returning microseconds, NULL restores the
+ *                     platform clock (platformGetTimeUs)
+ *****************************************************************************
+ */
+void timerSetClockSource( timerClockSource clock );
+
+#endif /* TIMER_H */
@@ -54,6 +54,13 @@
 
 #define RFAL_TEST_REG         0x0080U      /*!< Test Register indicator  */    
 
+#define RFAL_ANALOG_CONFIG_IDX_TECHS      (6U)     /*!< Indexed technologies: Chip, A, B, F, AP2P, V                   */
+#define RFAL_ANALOG_CONFIG_IDX_LOWS       (64U)    /*!< Indexed bit rate/direction combinations or Chip events          */
+#define RFAL_ANALOG_CONFIG_IDX_SLOTS      (2U * RFAL_ANALOG_CONFIG_IDX_TECHS * RFAL_ANALOG_CONFIG_IDX_LOWS) /*!< Poll/Listen x Tech x Low */
+#define RFAL_ANALOG_CONFIG_IDX_POOL_SIZE  (2U * RFAL_ANALOG_CONFIG_LUT_SIZE)  /*!< Max Configuration IDs referenced by all slots */
+#define RFAL_ANALOG_CONFIG_IDX_NO_SLOT    (0xFFFFU) /*!< Configuration ID cannot be indexed                            */
+#define RFAL_ANALOG_CONFIG_IDX_MAX_KEYS   (15U)    /*!< Max slots a Configuration ID can match: 5 techs x 3 directions */
+
 /*
  ******************************************************************************
  * MACROS
@@ -80,6 +87,17 @@ typedef struct {
 
 static rfalAnalogConfigMgmt   gRfalAnalogConfigMgmt;  /*!< Analog Configuration LUT management */
 
+/*! Direct index of the current Analog Configuration LUT.
+ *  Slot s lists, in table order, the offsets of all Configuration IDs matching the
+ *  query of slot s, in pool[ slotStart[s] ... slotStart[s+1]-1 ] */
+typedef struct {
+    uint16_t slotStart[RFAL_ANALOG_CONFIG_IDX_SLOTS + 1U]; /*!< Start of each slot in pool                    */
+    uint16_t pool[RFAL_ANALOG_CONFIG_IDX_POOL_SIZE];       /*!< Offsets of the Configuration IDs in the table */
+    bool     valid;                                        /*!< Index matches the current LUT                 */
+} rfalAnalogConfigIdx;
+
+static rfalAnalogConfigIdx    gRfalAnalogConfigIdx;   /*!< Analog Configuration LUT index      */
+
 /*
  ******************************************************************************
  * LOCAL TABLES
@@ -92,6 +110,10 @@ static rfalAnalogConfigMgmt   gRfalAnalogConfigMgmt;  /*!< Analog Configuration
  ******************************************************************************
  */
 static rfalAnalogConfigNum rfalAnalogConfigSearch( rfalAnalogConfigId configId, uint16_t *configOffset );
+static ReturnCode rfalAnalogConfigApply( uint16_t configOffset );
+static void rfalAnalogConfigIndexBuild( void );
+static uint16_t rfalAnalogConfigIndexSlot( rfalAnalogConfigId configId );
+static uint8_t rfalAnalogConfigIndexKeys( rfalAnalogConfigId configId, uint16_t *keys );
 
 #if RFAL_FEATURE_DYNAMIC_ANALOG_CONFIG
     static void rfalAnalogConfigPtrUpdate( const uint8_t* analogConfigTbl );
@@ -114,6 +136,7 @@ void rfalAnalogConfigInitialize( void )
     /* Use default Analog configuration settings in Flash by default. */
     gRfalAnalogConfigMgmt.currentAnalogConfigTbl = (const uint8_t *)rfalAnalogConfigDefaultSettings;
     gRfalAnalogConfigMgmt.configTblSize = sizeof(rfalAnalogConfigDefaultSettings);
+    rfalAnalogConfigIndexBuild();
     gRfalAnalogConfigMgmt.ready = true;
     
 } /* rfalAnalogConfigInitialize() */
@@ -280,46 +303,56 @@ ReturnCode rfalSetAnalogConfig( rfalAnalogConfigId configId )
 {
     rfalAnalogConfigOffset configOffset = 0;
     rfalAnalogConfigNum numConfigSet;
-    rfalAnalogConfigRegAddrMaskVal *configTbl;
     ReturnCode retCode = ERR_NONE;
-    rfalAnalogConfigNum i;
+    uint16_t slot;
+    uint16_t k;
     
     if (true != gRfalAnalogConfigMgmt.ready)
     {
         return ERR_REQUEST;
     }
     
-    /* Search LUT for the specific Configuration ID. */
-    while(true)
+    /* Collect the register changes and write them in as few bursts as possible */
+    rfalChipBatchStart();
+    
+    slot = rfalAnalogConfigIndexSlot( configId );
+    if( gRfalAnalogConfigIdx.valid && (slot != RFAL_ANALOG_CONFIG_IDX_NO_SLOT) )
     {
-        numConfigSet = rfalAnalogConfigSearch(configId, &configOffset);
-        if( RFAL_ANALOG_CONFIG_LUT_NOT_FOUND == numConfigSet )
+        /* Direct lookup: the index already lists every matching Configuration ID */
+        for( k = gRfalAnalogConfigIdx.slotStart[slot]; k < gRfalAnalogConfigIdx.slotStart[slot + 1U]; k++ )
         {
-            break;
-        }
-        
-        configTbl = (rfalAnalogConfigRegAddrMaskVal *)( (uint32_t)gRfalAnalogConfigMgmt.currentAnalogConfigTbl + (uint32_t)configOffset); 
-        /* Increment the offset to the next index to search from. */
-        configOffset += (uint16_t)(numConfigSet * sizeof(rfalAnalogConfigRegAddrMaskVal)); 
-        
-        if ((gRfalAnalogConfigMgmt.configTblSize + 1U) < configOffset)
-        {   /* Error check make sure that the we do not access outside the configuration Table Size */
-            return ERR_NOMEM;
+            retCode = rfalAnalogConfigApply( gRfalAnalogConfigIdx.pool[k] );
+            if( retCode != ERR_NONE )
+            {
+                break;
+            }
         }
-        
-        for ( i = 0; i < numConfigSet; i++)
+    }
+    else
+    {
+        /* Search LUT for the specific Configuration ID. */
+        while(true)
         {
-            if( (GETU16(configTbl[i].addr) & RFAL_TEST_REG) != 0U )
+            numConfigSet = rfalAnalogConfigSearch(configId, &configOffset);
+            if( RFAL_ANALOG_CONFIG_LUT_NOT_FOUND == numConfigSet )
             {
-                EXIT_ON_ERR(retCode, rfalChipChangeTestRegBits( (GETU16(configTbl[i].addr) & ~RFAL_TEST_REG), configTbl[i].mask, configTbl[i].val) );
+                break;
             }
-            else
+            
+            /* Point back to the Configuration ID, and on to the next one for the next search */
+            retCode       = rfalAnalogConfigApply( (uint16_t)(configOffset - sizeof(rfalAnalogConfigId) - sizeof(rfalAnalogConfigNum)) );
+            configOffset += (uint16_t)(numConfigSet * sizeof(rfalAnalogConfigRegAddrMaskVal)); 
+            
+            if( retCode != ERR_NONE )
             {
-                EXIT_ON_ERR(retCode, rfalChipChangeRegBits( GETU16(configTbl[i].addr), configTbl[i].mask, configTbl[i].val) );
+                break;
             }
-        }
-        
-    } /* while(found Analog Config Id) */
+            
+        } /* while(found Analog Config Id) */
+    }
+    
+    /* Whatever was applied before an error is still written out */
+    rfalChipBatchCommit();
     
     return retCode;
     
@@ -347,6 +380,7 @@ static void rfalAnalogConfigPtrUpdate( const uint8_t* analogConfigTbl )
 {
 
     gRfalAnalogConfigMgmt.currentAnalogConfigTbl = analogConfigTbl;
+    rfalAnalogConfigIndexBuild();
     gRfalAnalogConfigMgmt.ready = true;
     
 } /* rfalAnalogConfigPtrUpdate() */
@@ -399,3 +433,254 @@ static rfalAnalogConfigNum rfalAnalogConfigSearch( rfalAnalogConfigId configId,
     
     return RFAL_ANALOG_CONFIG_LUT_NOT_FOUND;
 } /* rfalAnalogConfigSearch() */
+
+
+/*! 
+ *****************************************************************************
+ * \brief  Apply the register settings of one Configuration ID
+ *  
+ * \param[in]  configOffset: Offset of the Configuration ID in the current Table
+ * 
+ * \return ERR_NOMEM : Configuration exceeds the Table size
+ * \return ERR_NONE  : Settings applied
+ *****************************************************************************
+ */
+static ReturnCode rfalAnalogConfigApply( uint16_t configOffset )
+{
+    const rfalAnalogConfigRegAddrMaskVal *configTbl;
+    rfalAnalogConfigNum numConfigSet;
+    rfalAnalogConfigNum i;
+    ReturnCode retCode = ERR_NONE;
+    
+    numConfigSet = gRfalAnalogConfigMgmt.currentAnalogConfigTbl[configOffset + sizeof(rfalAnalogConfigId)];
+    configOffset += (uint16_t)(sizeof(rfalAnalogConfigId) + sizeof(rfalAnalogConfigNum));
+    configTbl     = (const rfalAnalogConfigRegAddrMaskVal *)&gRfalAnalogConfigMgmt.currentAnalogConfigTbl[configOffset];
+    
+    /* Error check make sure that the we do not access outside the configuration Table Size */
+    if( (gRfalAnalogConfigMgmt.configTblSize + 1U) < (configOffset + (numConfigSet * sizeof(rfalAnalogConfigRegAddrMaskVal))) )
+    {
+        return ERR_NOMEM;
+    }
+    
+    for ( i = 0; i < numConfigSet; i++)
+    {
+        if( (GETU16(configTbl[i].addr) & RFAL_TEST_REG) != 0U )
+        {
+            retCode = rfalChipChangeTestRegBits( (GETU16(configTbl[i].addr) & ~RFAL_TEST_REG), configTbl[i].mask, configTbl[i].val);
+        }
+        else
+        {
+            retCode = rfalChipChangeRegBits( GETU16(configTbl[i].addr), configTbl[i].mask, configTbl[i].val);
+        }
+        
+        if( retCode != ERR_NONE )
+        {
+            break;
+        }
+    }
+    
+    return retCode;
+} /* rfalAnalogConfigApply() */
+
+
+/*! 
+ *****************************************************************************
+ * \brief  Build the direct index of the current Analog Configuration LUT
+ *  
+ * Walks the Table once and records, for every query slot, the offsets of the
+ * Configuration IDs rfalAnalogConfigSearch() would find for it, in Table order.
+ * Counting sort in two passes: count per slot, then fill.
+ * If the Table does not fit the index, it is left invalid and lookups fall
+ * back to the linear search.
+ *
+ *****************************************************************************
+ */
+static void rfalAnalogConfigIndexBuild( void )
+{
+    const uint8_t *currentConfigTbl = gRfalAnalogConfigMgmt.currentAnalogConfigTbl;
+    uint16_t keys[RFAL_ANALOG_CONFIG_IDX_MAX_KEYS];
+    uint16_t i;
+    uint16_t s;
+    uint16_t total;
+    uint8_t  pass;
+    uint8_t  numKeys;
+    uint8_t  k;
+    
+    gRfalAnalogConfigIdx.valid = false;
+    
+    for( pass = 0; pass < 2U; pass++ )
+    {
+        if( pass == 0U )
+        {
+            ST_MEMSET( gRfalAnalogConfigIdx.slotStart, 0x00, sizeof(gRfalAnalogConfigIdx.slotStart) );
+        }
+        
+        i = 0;
+        while( (i + sizeof(rfalAnalogConfigId) + sizeof(rfalAnalogConfigNum)) <= gRfalAnalogConfigMgmt.configTblSize )
+        {
+            numKeys = rfalAnalogConfigIndexKeys( GETU16(&currentConfigTbl[i]), keys );
+            for( k = 0; k < numKeys; k++ )
+            {
+                if( pass == 0U )
+                {
+                    gRfalAnalogConfigIdx.slotStart[keys[k] + 1U]++;                       /* Count */
+                }
+                else
+                {
+                    gRfalAnalogConfigIdx.pool[gRfalAnalogConfigIdx.slotStart[keys[k]]++] = i;  /* Fill, slotStart moves to the slot end */
+                }
+            }
+            
+            i += (uint16_t)( sizeof(rfalAnalogConfigId) + sizeof(rfalAnalogConfigNum) 
+                            + (currentConfigTbl[i + sizeof(rfalAnalogConfigId)] * sizeof(rfalAnalogConfigRegAddrMaskVal) ) );
+        }
+        
+        if( pass == 0U )
+        {
+            /* Counts to start positions */
+            total = 0;
+            for( s = 0; s < RFAL_ANALOG_CONFIG_IDX_SLOTS; s++ )
+            {
+                total += gRfalAnalogConfigIdx.slotStart[s + 1U];
+                gRfalAnalogConfigIdx.slotStart[s] = (total - gRfalAnalogConfigIdx.slotStart[s + 1U]);
+            }
+            gRfalAnalogConfigIdx.slotStart[RFAL_ANALOG_CONFIG_IDX_SLOTS] = total;
+            
+            if( total > RFAL_ANALOG_CONFIG_IDX_POOL_SIZE )
+            {
+                return;
+            }
+        }
+    }
+    
+    /* Filling moved every start to the end of its slot, i.e. the start of the next one */
+    for( s = RFAL_ANALOG_CONFIG_IDX_SLOTS; s > 0U; s-- )
+    {
+        gRfalAnalogConfigIdx.slotStart[s] = gRfalAnalogConfigIdx.slotStart[s - 1U];
+    }
+    gRfalAnalogConfigIdx.slotStart[0] = 0;
+    
+    gRfalAnalogConfigIdx.valid = true;
+} /* rfalAnalogConfigIndexBuild() */
+
+
+/*! 
+ *****************************************************************************
+ * \brief  Get the index slot of a Configuration ID query
+ *  
+ * \param[in]  configId: Configuration ID as passed to rfalSetAnalogConfig()
+ * 
+ * \return slot number
+ * \return #RFAL_ANALOG_CONFIG_IDX_NO_SLOT if the query is not indexed (several 
+ *         technologies or Chip event out of range), linear search is needed
+ *****************************************************************************
+ */
+static uint16_t rfalAnalogConfigIndexSlot( rfalAnalogConfigId configId )
+{
+    uint16_t tech;
+    uint16_t low;
+    uint16_t t;
+    
+    tech = (uint16_t)RFAL_ANALOG_CONFIG_ID_GET_TECH(configId);
+    
+    if( tech == RFAL_ANALOG_CONFIG_TECH_CHIP )
+    {
+        t   = 0;
+        low = (configId & RFAL_ANALOG_CONFIG_CHIP_SPECIFIC_MASK);
+        if( low >= RFAL_ANALOG_CONFIG_IDX_LOWS )
+        {
+            return RFAL_ANALOG_CONFIG_IDX_NO_SLOT;
+        }
+    }
+    else
+    {
+        /* One technology bit, NFC-A up to NFC-V */
+        for( t = 1; t < RFAL_ANALOG_CONFIG_IDX_TECHS; t++ )
+        {
+            if( tech == (RFAL_ANALOG_CONFIG_TECH_NFCA << (t - 1U)) )
+            {
+                break;
+            }
+        }
+        /* Bits between bit rate and direction are not part of the slot */
+        if( (t >= RFAL_ANALOG_CONFIG_IDX_TECHS) || ((configId & (RFAL_ANALOG_CONFIG_CHIP_SPECIFIC_MASK & ~(RFAL_ANALOG_CONFIG_BITRATE_MASK | RFAL_ANALOG_CONFIG_DIRECTION_MASK))) != 0U) )
+        {
+            return RFAL_ANALOG_CONFIG_IDX_NO_SLOT;
+        }
+        
+        low = ( (RFAL_ANALOG_CONFIG_ID_GET_BITRATE(configId) >> (RFAL_ANALOG_CONFIG_BITRATE_SHIFT - 2U))
+              | RFAL_ANALOG_CONFIG_ID_GET_DIRECTION(configId) );
+    }
+    
+    return (uint16_t)( ((((uint16_t)RFAL_ANALOG_CONFIG_ID_GET_POLL_LISTEN(configId) >> RFAL_ANALOG_CONFIG_POLL_LISTEN_MODE_SHIFT) * RFAL_ANALOG_CONFIG_IDX_TECHS) + t) 
+                       * RFAL_ANALOG_CONFIG_IDX_LOWS + low );
+} /* rfalAnalogConfigIndexSlot() */
+
+
+/*! 
+ *****************************************************************************
+ * \brief  Get all index slots a Table Configuration ID belongs to
+ *  
+ * Mirrors the matching of rfalAnalogConfigSearch(): a Table entry serves every
+ * technology it has set, and with direction TX and RX also TX only, RX only 
+ * and Anticollision queries.
+ * 
+ * \param[in]  configId: Configuration ID found in the Table
+ * \param[out] keys: Slots the Configuration ID belongs to
+ * 
+ * \return number of slots in keys
+ *****************************************************************************
+ */
+static uint8_t rfalAnalogConfigIndexKeys( rfalAnalogConfigId configId, uint16_t *keys )
+{
+    rfalAnalogConfigId query;
+    uint16_t dir;
+    uint16_t d;
+    uint16_t slot;
+    uint8_t  t;
+    uint8_t  n = 0;
+    
+    if( RFAL_ANALOG_CONFIG_ID_GET_TECH(configId) == RFAL_ANALOG_CONFIG_TECH_CHIP )
+    {
+        slot = rfalAnalogConfigIndexSlot( configId );
+        if( slot != RFAL_ANALOG_CONFIG_IDX_NO_SLOT )
+        {
+            keys[n++] = slot;
+        }
+        return n;
+    }
+    
+    /* Such an entry is never matched by an indexed query */
+    if( (configId & (RFAL_ANALOG_CONFIG_CHIP_SPECIFIC_MASK & ~(RFAL_ANALOG_CONFIG_BITRATE_MASK | RFAL_ANALOG_CONFIG_DIRECTION_MASK))) != 0U )
+    {
+        return n;
+    }
+    
+    dir = (uint16_t)RFAL_ANALOG_CONFIG_ID_GET_DIRECTION(configId);
+    
+    for( t = 1; t < RFAL_ANALOG_CONFIG_IDX_TECHS; t++ )
+    {
+        if( (configId & (RFAL_ANALOG_CONFIG_TECH_NFCA << (t - 1U))) == 0U )
+        {
+            continue;
+        }
+        
+        /* Query directions d matched: no direction only by no direction, otherwise every d within dir */
+        for( d = 0; d <= RFAL_ANALOG_CONFIG_DIRECTION_MASK; d++ )
+        {
+            if( ((dir == 0U) && (d != 0U)) || ((dir != 0U) && ((d == 0U) || ((d & dir) != d))) )
+            {
+                continue;
+            }
+            
+            query = (rfalAnalogConfigId)( RFAL_ANALOG_CONFIG_ID_GET_POLL_LISTEN(configId) 
+                                        | (RFAL_ANALOG_CONFIG_TECH_NFCA << (t - 1U))
+                                        | RFAL_ANALOG_CONFIG_ID_GET_BITRATE(configId)
+                                        | d );
+            keys[n++] = rfalAnalogConfigIndexSlot( query );
+        }
+    }
+    
+    return n;
+} /* rfalAnalogConfigIndexKeys() */
+
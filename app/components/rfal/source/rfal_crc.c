@@ -43,10 +43,165 @@
 
 /*
 ******************************************************************************
-* LOCAL FUNCTION PROTOTYPES
+* LOCAL DEFINES
 ******************************************************************************
 */
-static uint16_t rfalCrcUpdateCcitt(uint16_t crcSeed, uint8_t dataByte);
+#if (RFAL_FEATURE_CRC_ENGINE == RFAL_CRC_ENGINE_SLICE4)
+    #define RFAL_CRC_TBL_NUM    4U        /*!< Slice-by-4: one table per byte of a 32 bit word */
+#else
+    #define RFAL_CRC_TBL_NUM    1U        /*!< Single 256 entry table                          */
+#endif
+
+/*
+******************************************************************************
+* LOCAL TABLES
+******************************************************************************
+*/
+#if (RFAL_FEATURE_CRC_ENGINE != RFAL_CRC_ENGINE_BITWISE)
+/*! CRC CCITT (LSB first, polynomial 0x8408) lookup tables.
+ *  rfalCrcTbl[0][i] is the CRC of byte i, rfalCrcTbl[k][i] the same byte followed by k zero bytes */
+static const uint16_t rfalCrcTbl[RFAL_CRC_TBL_NUM][256] =
+{
+  {
+    0x0000U, 0x1189U, 0x2312U, 0x329BU, 0x4624U, 0x57ADU, 0x6536U, 0x74BFU,
+    0x8C48U, 0x9DC1U, 0xAF5AU, 0xBED3U, 0xCA6CU, 0xDBE5U, 0xE97EU, 0xF8F7U,
+    0x1081U, 0x0108U, 0x3393U, 0x221AU, 0x56A5U, 0x472CU, 0x75B7U, 0x643EU,
+    0x9CC9U, 0x8D40U, 0xBFDBU, 0xAE52U, 0xDAEDU, 0xCB64U, 0xF9FFU, 0xE876U,
+    0x2102U, 0x308BU, 0x0210U, 0x1399U, 0x6726U, 0x76AFU, 0x4434U, 0x55BDU,
+    0xAD4AU, 0xBCC3U, 0x8E58U, 0x9FD1U, 0xEB6EU, 0xFAE7U, 0xC87CU, 0xD9F5U,
+    0x3183U, 0x200AU, 0x1291U, 0x0318U, 0x77A7U, 0x662EU, 0x54B5U, 0x453CU,
+    0xBDCBU, 0xAC42U, 0x9ED9U, 0x8F50U, 0xFBEFU, 0xEA66U, 0xD8FDU, 0xC974U,
+    0x4204U, 0x538DU, 0x6116U, 0x709FU, 0x0420U, 0x15A9U, 0x2732U, 0x36BBU,
+    0xCE4CU, 0xDFC5U, 0xED5EU, 0xFCD7U, 0x8868U, 0x99E1U, 0xAB7AU, 0xBAF3U,
+    0x5285U, 0x430CU, 0x7197U, 0x601EU, 0x14A1U, 0x0528U, 0x37B3U, 0x263AU,
+    0xDECDU, 0xCF44U, 0xFDDFU, 0xEC56U, 0x98E9U, 0x8960U, 0xBBFBU, 0xAA72U,
+    0x6306U, 0x728FU, 0x4014U, 0x519DU, 0x2522U, 0x34ABU, 0x0630U, 0x17B9U,
+    0xEF4EU, 0xFEC7U, 0xCC5CU, 0xDDD5U, 0xA96AU, 0xB8E3U, 0x8A78U, 0x9BF1U,
+    0x7387U, 0x620EU, 0x5095U, 0x411CU, 0x35A3U, 0x242AU, 0x16B1U, 0x0738U,
+    0xFFCFU, 0xEE46U, 0xDCDDU, 0xCD54U, 0xB9EBU, 0xA862U, 0x9AF9U, 0x8B70U,
+    0x8408U, 0x9581U, 0xA71AU, 0xB693U, 0xC22CU, 0xD3A5U, 0xE13EU, 0xF0B7U,
+    0x0840U, 0x19C9U, 0x2B52U, 0x3ADBU, 0x4E64U, 0x5FEDU, 0x6D76U, 0x7CFFU,
+    0x9489U, 0x8500U, 0xB79BU, 0xA612U, 0xD2ADU, 0xC324U, 0xF1BFU, 0xE036U,
+    0x18C1U, 0x0948U, 0x3BD3U, 0x2A5AU, 0x5EE5U, 0x4F6CU, 0x7DF7U, 0x6C7EU,
+    0xA50AU, 0xB483U, 0x8618U, 0x9791U, 0xE32EU, 0xF2A7U, 0xC03CU, 0xD1B5U,
+    0x2942U, 0x38CBU, 0x0A50U, 0x1BD9U, 0x6F66U, 0x7EEFU, 0x4C74U, 0x5DFDU,
+    0xB58BU, 0xA402U, 0x9699U, 0x8710U, 0xF3AFU, 0xE226U, 0xD0BDU, 0xC134U,
+    0x39C3U, 0x284AU, 0x1AD1U, 0x0B58U, 0x7FE7U, 0x6E6EU, 0x5CF5U, 0x4D7CU,
+    0xC60CU, 0xD785U, 0xE51EU, 0xF497U, 0x8028U, 0x91A1U, 0xA33AU, 0xB2B3U,
+    0x4A44U, 0x5BCDU, 0x6956U, 0x78DFU, 0x0C60U, 0x1DE9U, 0x2F72U, 0x3EFBU,
+    0xD68DU, 0xC704U, 0xF59FU, 0xE416U, 0x90A9U, 0x8120U, 0xB3BBU, 0xA232U,
+    0x5AC5U, 0x4B4CU, 0x79D7U, 0x685EU, 0x1CE1U, 0x0D68U, 0x3FF3U, 0x2E7AU,
+    0xE70EU, 0xF687U, 0xC41CU, 0xD595U, 0xA12AU, 0xB0A3U, 0x8238U, 0x93B1U,
+    0x6B46U, 0x7ACFU, 0x4854U, 0x59DDU, 0x2D62U, 0x3CEBU, 0x0E70U, 0x1FF9U,
+    0xF78FU, 0xE606U, 0xD49DU, 0xC514U, 0xB1ABU, 0xA022U, 0x92B9U, 0x8330U,
+    0x7BC7U, 0x6A4EU, 0x58D5U, 0x495CU, 0x3DE3U, 0x2C6AU, 0x1EF1U, 0x0F78U
+  }
+#if (RFAL_FEATURE_CRC_ENGINE == RFAL_CRC_ENGINE_SLICE4)
+ ,{
+    0x0000U, 0x19D8U, 0x33B0U, 0x2A68U, 0x6760U, 0x7EB8U, 0x54D0U, 0x4D08U,
+    0xCEC0U, 0xD718U, 0xFD70U, 0xE4A8U, 0xA9A0U, 0xB078U, 0x9A10U, 0x83C8U,
+    0x9591U, 0x8C49U, 0xA621U, 0xBFF9U, 0xF2F1U, 0xEB29U, 0xC141U, 0xD899U,
+    0x5B51U, 0x4289U, 0x68E1U, 0x7139U, 0x3C31U, 0x25E9U, 0x0F81U, 0x1659U,
+    0x2333U, 0x3AEBU, 0x1083U, 0x095BU, 0x4453U, 0x5D8BU, 0x77E3U, 0x6E3BU,
+    0xEDF3U, 0xF42BU, 0xDE43U, 0xC79BU, 0x8A93U, 0x934BU, 0xB923U, 0xA0FBU,
+    0xB6A2U, 0xAF7AU, 0x8512U, 0x9CCAU, 0xD1C2U, 0xC81AU, 0xE272U, 0xFBAAU,
+    0x7862U, 0x61BAU, 0x4BD2U, 0x520AU, 0x1F02U, 0x06DAU, 0x2CB2U, 0x356AU,
+    0x4666U, 0x5FBEU, 0x75D6U, 0x6C0EU, 0x2106U, 0x38DEU, 0x12B6U, 0x0B6EU,
+    0x88A6U, 0x917EU, 0xBB16U, 0xA2CEU, 0xEFC6U, 0xF61EU, 0xDC76U, 0xC5AEU,
+    0xD3F7U, 0xCA2FU, 0xE047U, 0xF99FU, 0xB497U, 0xAD4FU, 0x8727U, 0x9EFFU,
+    0x1D37U, 0x04EFU, 0x2E87U, 0x375FU, 0x7A57U, 0x638FU, 0x49E7U, 0x503FU,
+    0x6555U, 0x7C8DU, 0x56E5U, 0x4F3DU, 0x0235U, 0x1BEDU, 0x3185U, 0x285DU,
+    0xAB95U, 0xB24DU, 0x9825U, 0x81FDU, 0xCCF5U, 0xD52DU, 0xFF45U, 0xE69DU,
+    0xF0C4U, 0xE91CU, 0xC374U, 0xDAACU, 0x97A4U, 0x8E7CU, 0xA414U, 0xBDCCU,
+    0x3E04U, 0x27DCU, 0x0DB4U, 0x146CU, 0x5964U, 0x40BCU, 0x6AD4U, 0x730CU,
+    0x8CCCU, 0x9514U, 0xBF7CU, 0xA6A4U, 0xEBACU, 0xF274U, 0xD81CU, 0xC1C4U,
+    0x420CU, 0x5BD4U, 0x71BCU, 0x6864U, 0x256CU, 0x3CB4U, 0x16DCU, 0x0F04U,
+    0x195DU, 0x0085U, 0x2AEDU, 0x3335U, 0x7E3DU, 0x67E5U, 0x4D8DU, 0x5455U,
+    0xD79DU, 0xCE45U, 0xE42DU, 0xFDF5U, 0xB0FDU, 0xA925U, 0x834DU, 0x9A95U,
+    0xAFFFU, 0xB627U, 0x9C4FU, 0x8597U, 0xC89FU, 0xD147U, 0xFB2FU, 0xE2F7U,
+    0x613FU, 0x78E7U, 0x528FU, 0x4B57U, 0x065FU, 0x1F87U, 0x35EFU, 0x2C37U,
+    0x3A6EU, 0x23B6U, 0x09DEU, 0x1006U, 0x5D0EU, 0x44D6U, 0x6EBEU, 0x7766U,
+    0xF4AEU, 0xED76U, 0xC71EU, 0xDEC6U, 0x93CEU, 0x8A16U, 0xA07EU, 0xB9A6U,
+    0xCAAAU, 0xD372U, 0xF91AU, 0xE0C2U, 0xADCAU, 0xB412U, 0x9E7AU, 0x87A2U,
+    0x046AU, 0x1DB2U, 0x37DAU, 0x2E02U, 0x630AU, 0x7AD2U, 0x50BAU, 0x4962U,
+    0x5F3BU, 0x46E3U, 0x6C8BU, 0x7553U, 0x385BU, 0x2183U, 0x0BEBU, 0x1233U,
+    0x91FBU, 0x8823U, 0xA24BU, 0xBB93U, 0xF69BU, 0xEF43U, 0xC52BU, 0xDCF3U,
+    0xE999U, 0xF041U, 0xDA29U, 0xC3F1U, 0x8EF9U, 0x9721U, 0xBD49U, 0xA491U,
+    0x2759U, 0x3E81U, 0x14E9U, 0x0D31U, 0x4039U, 0x59E1U, 0x7389U, 0x6A51U,
+    0x7C08U, 0x65D0U, 0x4FB8U, 0x5660U, 0x1B68U, 0x02B0U, 0x28D8U, 0x3100U,
+    0xB2C8U, 0xAB10U, 0x8178U, 0x98A0U, 0xD5A8U, 0xCC70U, 0xE618U, 0xFFC0U
+  }
+ ,{
+    0x0000U, 0x5ADCU, 0xB5B8U, 0xEF64U, 0x6361U, 0x39BDU, 0xD6D9U, 0x8C05U,
+    0xC6C2U, 0x9C1EU, 0x737AU, 0x29A6U, 0xA5A3U, 0xFF7FU, 0x101BU, 0x4AC7U,
+    0x8595U, 0xDF49U, 0x302DU, 0x6AF1U, 0xE6F4U, 0xBC28U, 0x534CU, 0x0990U,
+    0x4357U, 0x198BU, 0xF6EFU, 0xAC33U, 0x2036U, 0x7AEAU, 0x958EU, 0xCF52U,
+    0x033BU, 0x59E7U, 0xB683U, 0xEC5FU, 0x605AU, 0x3A86U, 0xD5E2U, 0x8F3EU,
+    0xC5F9U, 0x9F25U, 0x7041U, 0x2A9DU, 0xA698U, 0xFC44U, 0x1320U, 0x49FCU,
+    0x86AEU, 0xDC72U, 0x3316U, 0x69CAU, 0xE5CFU, 0xBF13U, 0x5077U, 0x0AABU,
+    0x406CU, 0x1AB0U, 0xF5D4U, 0xAF08U, 0x230DU, 0x79D1U, 0x96B5U, 0xCC69U,
+    0x0676U, 0x5CAAU, 0xB3CEU, 0xE912U, 0x6517U, 0x3FCBU, 0xD0AFU, 0x8A73U,
+    0xC0B4U, 0x9A68U, 0x750CU, 0x2FD0U, 0xA3D5U, 0xF909U, 0x166DU, 0x4CB1U,
+    0x83E3U, 0xD93FU, 0x365BU, 0x6C87U, 0xE082U, 0xBA5EU, 0x553AU, 0x0FE6U,
+    0x4521U, 0x1FFDU, 0xF099U, 0xAA45U, 0x2640U, 0x7C9CU, 0x93F8U, 0xC924U,
+    0x054DU, 0x5F91U, 0xB0F5U, 0xEA29U, 0x662CU, 0x3CF0U, 0xD394U, 0x8948U,
+    0xC38FU, 0x9953U, 0x7637U, 0x2CEBU, 0xA0EEU, 0xFA32U, 0x1556U, 0x4F8AU,
+    0x80D8U, 0xDA04U, 0x3560U, 0x6FBCU, 0xE3B9U, 0xB965U, 0x5601U, 0x0CDDU,
+    0x461AU, 0x1CC6U, 0xF3A2U, 0xA97EU, 0x257BU, 0x7FA7U, 0x90C3U, 0xCA1FU,
+    0x0CECU, 0x5630U, 0xB954U, 0xE388U, 0x6F8DU, 0x3551U, 0xDA35U, 0x80E9U,
+    0xCA2EU, 0x90F2U, 0x7F96U, 0x254AU, 0xA94FU, 0xF393U, 0x1CF7U, 0x462BU,
+    0x8979U, 0xD3A5U, 0x3CC1U, 0x661DU, 0xEA18U, 0xB0C4U, 0x5FA0U, 0x057CU,
+    0x4FBBU, 0x1567U, 0xFA03U, 0xA0DFU, 0x2CDAU, 0x7606U, 0x9962U, 0xC3BEU,
+    0x0FD7U, 0x550BU, 0xBA6FU, 0xE0B3U, 0x6CB6U, 0x366AU, 0xD90EU, 0x83D2U,
+    0xC915U, 0x93C9U, 0x7CADU, 0x2671U, 0xAA74U, 0xF0A8U, 0x1FCCU, 0x4510U,
+    0x8A42U, 0xD09EU, 0x3FFAU, 0x6526U, 0xE923U, 0xB3FFU, 0x5C9BU, 0x0647U,
+    0x4C80U, 0x165CU, 0xF938U, 0xA3E4U, 0x2FE1U, 0x753DU, 0x9A59U, 0xC085U,
+    0x0A9AU, 0x5046U, 0xBF22U, 0xE5FEU, 0x69FBU, 0x3327U, 0xDC43U, 0x869FU,
+    0xCC58U, 0x9684U, 0x79E0U, 0x233CU, 0xAF39U, 0xF5E5U, 0x1A81U, 0x405DU,
+    0x8F0FU, 0xD5D3U, 0x3AB7U, 0x606BU, 0xEC6EU, 0xB6B2U, 0x59D6U, 0x030AU,
+    0x49CDU, 0x1311U, 0xFC75U, 0xA6A9U, 0x2AACU, 0x7070U, 0x9F14U, 0xC5C8U,
+    0x09A1U, 0x537DU, 0xBC19U, 0xE6C5U, 0x6AC0U, 0x301CU, 0xDF78U, 0x85A4U,
+    0xCF63U, 0x95BFU, 0x7ADBU, 0x2007U, 0xAC02U, 0xF6DEU, 0x19BAU, 0x4366U,
+    0x8C34U, 0xD6E8U, 0x398CU, 0x6350U, 0xEF55U, 0xB589U, 0x5AEDU, 0x0031U,
+    0x4AF6U, 0x102AU, 0xFF4EU, 0xA592U, 0x2997U, 0x734BU, 0x9C2FU, 0xC6F3U
+  }
+ ,{
+    0x0000U, 0x1CBBU, 0x3976U, 0x25CDU, 0x72ECU, 0x6E57U, 0x4B9AU, 0x5721U,
+    0xE5D8U, 0xF963U, 0xDCAEU, 0xC015U, 0x9734U, 0x8B8FU, 0xAE42U, 0xB2F9U,
+    0xC3A1U, 0xDF1AU, 0xFAD7U, 0xE66CU, 0xB14DU, 0xADF6U, 0x883BU, 0x9480U,
+    0x2679U, 0x3AC2U, 0x1F0FU, 0x03B4U, 0x5495U, 0x482EU, 0x6DE3U, 0x7158U,
+    0x8F53U, 0x93E8U, 0xB625U, 0xAA9EU, 0xFDBFU, 0xE104U, 0xC4C9U, 0xD872U,
+    0x6A8BU, 0x7630U, 0x53FDU, 0x4F46U, 0x1867U, 0x04DCU, 0x2111U, 0x3DAAU,
+    0x4CF2U, 0x5049U, 0x7584U, 0x693FU, 0x3E1EU, 0x22A5U, 0x0768U, 0x1BD3U,
+    0xA92AU, 0xB591U, 0x905CU, 0x8CE7U, 0xDBC6U, 0xC77DU, 0xE2B0U, 0xFE0BU,
+    0x16B7U, 0x0A0CU, 0x2FC1U, 0x337AU, 0x645BU, 0x78E0U, 0x5D2DU, 0x4196U,
+    0xF36FU, 0xEFD4U, 0xCA19U, 0xD6A2U, 0x8183U, 0x9D38U, 0xB8F5U, 0xA44EU,
+    0xD516U, 0xC9ADU, 0xEC60U, 0xF0DBU, 0xA7FAU, 0xBB41U, 0x9E8CU, 0x8237U,
+    0x30CEU, 0x2C75U, 0x09B8U, 0x1503U, 0x4222U, 0x5E99U, 0x7B54U, 0x67EFU,
+    0x99E4U, 0x855FU, 0xA092U, 0xBC29U, 0xEB08U, 0xF7B3U, 0xD27EU, 0xCEC5U,
+    0x7C3CU, 0x6087U, 0x454AU, 0x59F1U, 0x0ED0U, 0x126BU, 0x37A6U, 0x2B1DU,
+    0x5A45U, 0x46FEU, 0x6333U, 0x7F88U, 0x28A9U, 0x3412U, 0x11DFU, 0x0D64U,
+    0xBF9DU, 0xA326U, 0x86EBU, 0x9A50U, 0xCD71U, 0xD1CAU, 0xF407U, 0xE8BCU,
+    0x2D6EU, 0x31D5U, 0x1418U, 0x08A3U, 0x5F82U, 0x4339U, 0x66F4U, 0x7A4FU,
+    0xC8B6U, 0xD40DU, 0xF1C0U, 0xED7BU, 0xBA5AU, 0xA6E1U, 0x832CU, 0x9F97U,
+    0xEECFU, 0xF274U, 0xD7B9U, 0xCB02U, 0x9C23U, 0x8098U, 0xA555U, 0xB9EEU,
+    0x0B17U, 0x17ACU, 0x3261U, 0x2EDAU, 0x79FBU, 0x6540U, 0x408DU, 0x5C36U,
+    0xA23DU, 0xBE86U, 0x9B4BU, 0x87F0U, 0xD0D1U, 0xCC6AU, 0xE9A7U, 0xF51CU,
+    0x47E5U, 0x5B5EU, 0x7E93U, 0x6228U, 0x3509U, 0x29B2U, 0x0C7FU, 0x10C4U,
+    0x619CU, 0x7D27U, 0x58EAU, 0x4451U, 0x1370U, 0x0FCBU, 0x2A06U, 0x36BDU,
+    0x8444U, 0x98FFU, 0xBD32U, 0xA189U, 0xF6A8U, 0xEA13U, 0xCFDEU, 0xD365U,
+    0x3BD9U, 0x2762U, 0x02AFU, 0x1E14U, 0x4935U, 0x558EU, 0x7043U, 0x6CF8U,
+    0xDE01U, 0xC2BAU, 0xE777U, 0xFBCCU, 0xACEDU, 0xB056U, 0x959BU, 0x8920U,
+    0xF878U, 0xE4C3U, 0xC10EU, 0xDDB5U, 0x8A94U, 0x962FU, 0xB3E2U, 0xAF59U,
+    0x1DA0U, 0x011BU, 0x24D6U, 0x386DU, 0x6F4CU, 0x73F7U, 0x563AU, 0x4A81U,
+    0xB48AU, 0xA831U, 0x8DFCU, 0x9147U, 0xC666U, 0xDADDU, 0xFF10U, 0xE3ABU,
+    0x5152U, 0x4DE9U, 0x6824U, 0x749FU, 0x23BEU, 0x3F05U, 0x1AC8U, 0x0673U,
+    0x772BU, 0x6B90U, 0x4E5DU, 0x52E6U, 0x05C7U, 0x197CU, 0x3CB1U, 0x200AU,
+    0x92F3U, 0x8E48U, 0xAB85U, 0xB73EU, 0xE01FU, 0xFCA4U, 0xD969U, 0xC5D2U
+  }
+#endif /* RFAL_CRC_ENGINE_SLICE4 */
+};
+#endif /* !RFAL_CRC_ENGINE_BITWISE */
 
 /*
 ******************************************************************************
@@ -56,31 +211,57 @@ static uint16_t rfalCrcUpdateCcitt(uint16_t crcSeed, uint8_t dataByte);
 uint16_t rfalCrcCalculateCcitt(uint16_t preloadValue, const uint8_t* buf, uint16_t length)
 {
     uint16_t crc = preloadValue;
-    uint16_t index;
+    uint16_t index = 0;
 
-    for (index = 0; index < length; index++)
+#if (RFAL_FEATURE_CRC_ENGINE == RFAL_CRC_ENGINE_SLICE4)
+    /* Four bytes per step, the CRC folds into the first two */
+    for (; (index + 4U) <= length; index += 4U)
     {
-        crc = rfalCrcUpdateCcitt(crc, buf[index]);
+        crc = rfalCrcTbl[3][(uint8_t)(crc ^ buf[index])]
+            ^ rfalCrcTbl[2][(uint8_t)((crc >> 8) ^ buf[index + 1U])]
+            ^ rfalCrcTbl[1][buf[index + 2U]]
+            ^ rfalCrcTbl[0][buf[index + 3U]];
+    }
+#endif /* RFAL_CRC_ENGINE_SLICE4 */
+
+    for (; index < length; index++)
+    {
+        crc = rfalCrcUpdateCcittByte(crc, buf[index]);
     }
 
     return crc;
 }
 
-/*
-******************************************************************************
-* LOCAL FUNCTIONS
-******************************************************************************
-*/
-static uint16_t rfalCrcUpdateCcitt(uint16_t crcSeed, uint8_t dataByte)
+
+uint16_t rfalCrcUpdateCcittByte(uint16_t crc, uint8_t dataByte)
 {
-    uint16_t crc = crcSeed;
+#if (RFAL_FEATURE_CRC_ENGINE == RFAL_CRC_ENGINE_BITWISE)
     uint8_t  dat = dataByte;
     
     dat ^= (uint8_t)(crc & 0xFFU);
     dat ^= dat << 4;
 
-    crc = (crc >> 8)^(((uint16_t) dat) << 8)^(((uint16_t) dat) << 3)^(((uint16_t) dat) >> 4);
+    return (crc >> 8)^(((uint16_t) dat) << 8)^(((uint16_t) dat) << 3)^(((uint16_t) dat) >> 4);
+#else
+    return (crc >> 8) ^ rfalCrcTbl[0][(uint8_t)(crc ^ dataByte)];
+#endif /* RFAL_CRC_ENGINE_BITWISE */
+}
+
 
-    return crc;
+void rfalCrcCcittStart(rfalCrcCcittCtx* ctx, uint16_t preloadValue)
+{
+    ctx->crc = preloadValue;
+}
+
+
+void rfalCrcCcittUpdate(rfalCrcCcittCtx* ctx, const uint8_t* buf, uint16_t length)
+{
+    ctx->crc = rfalCrcCalculateCcitt(ctx->crc, buf, length);
+}
+
+
+uint16_t rfalCrcCcittGet(const rfalCrcCcittCtx* ctx)
+{
+    return ctx->crc;
 }
 
@@ -47,6 +47,31 @@
 */
 #include "platform.h"
 
+/*
+******************************************************************************
+* GLOBAL DEFINES
+******************************************************************************
+*/
+#define RFAL_CRC_ENGINE_BITWISE     0U    /*!< Byte at a time, shifts only: no table                  */
+#define RFAL_CRC_ENGINE_TABLE       1U    /*!< Byte at a time, 256 entry table: 512 bytes             */
+#define RFAL_CRC_ENGINE_SLICE4      2U    /*!< Four bytes at a time, 4 x 256 entry tables: 2 kbytes   */
+
+#ifndef RFAL_FEATURE_CRC_ENGINE
+    #define RFAL_FEATURE_CRC_ENGINE RFAL_CRC_ENGINE_TABLE  /*!< Software CRC engine, see RFAL_CRC_ENGINE_xxx */
+#endif
+
+/*
+******************************************************************************
+* GLOBAL TYPES
+******************************************************************************
+*/
+
+/*! Running CRC of a frame fed in several chunks */
+typedef struct
+{
+    uint16_t crc;    /*!< CRC over the data so far */
+} rfalCrcCcittCtx;
+
 /*
 ******************************************************************************
 * GLOBAL FUNCTION PROTOTYPES
@@ -71,5 +96,59 @@
  */
 extern uint16_t rfalCrcCalculateCcitt(uint16_t preloadValue, const uint8_t* buf, uint16_t length);
 
+/*! 
+ *****************************************************************************
+ *  \brief  Add one byte to a CRC according to CCITT standard.
+ *
+ *  Lets encoders and decoders compute the CRC on the fly, byte by byte,
+ *  instead of a second pass over the frame.
+ *
+ *  \param[in] crc : CRC so far, or the initial value.
+ *  \param[in] dataByte : byte to add.
+ *
+ *  \return 16 bit long crc value.
+ *
+ *****************************************************************************
+ */
+extern uint16_t rfalCrcUpdateCcittByte(uint16_t crc, uint8_t dataByte);
+
+/*! 
+ *****************************************************************************
+ *  \brief  Start a streamed CRC calculation according to CCITT standard.
+ *
+ *  \param[out] ctx : stream context.
+ *  \param[in] preloadValue : Initial value of CRC calculation.
+ *
+ *****************************************************************************
+ */
+extern void rfalCrcCcittStart(rfalCrcCcittCtx* ctx, uint16_t preloadValue);
+
+/*! 
+ *****************************************************************************
+ *  \brief  Add a chunk of data to a streamed CRC calculation.
+ *
+ *  Feeding a frame in any number of chunks gives the same result as 
+ *  rfalCrcCalculateCcitt() over the whole frame.
+ *
+ *  \param[in,out] ctx : stream context.
+ *  \param[in] buf : next chunk of data.
+ *  \param[in] length : size of the chunk.
+ *
+ *****************************************************************************
+ */
+extern void rfalCrcCcittUpdate(rfalCrcCcittCtx* ctx, const uint8_t* buf, uint16_t length);
+
+/*! 
+ *****************************************************************************
+ *  \brief  Get the CRC of the data streamed so far.
+ *
+ *  \param[in] ctx : stream context.
+ *
+ *  \return 16 bit long crc value.
+ *
+ *****************************************************************************
+ */
+extern uint16_t rfalCrcCcittGet(const rfalCrcCcittCtx* ctx);
+
 #endif /* RFAL_CRC_H_ */
 
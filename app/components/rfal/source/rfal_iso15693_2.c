@@ -87,6 +87,13 @@
 
 #define ISO15693_PHY_BIT_BUFFER_SIZE 1000 /*!< size of the receiving buffer. Might be adjusted if longer datastreams are expected. */
 
+#define ISO15693_SYMBOL_LEN_1_4    4U   /*!< Coded bytes per data byte in 1 out of 4                            */
+#define ISO15693_SYMBOL_LEN_1_256  64U  /*!< Coded bytes per data byte in 1 out of 256                          */
+
+#define ISO15693_MAN_DATA_MASK   0x0FU  /*!< Manchester table: decoded bits, pair i gives bit i                 */
+#define ISO15693_MAN_COL_MASK    0xF0U  /*!< Manchester table: pairs which are no data bit (collision or EOF)   */
+#define ISO15693_MAN_COL_SHIFT   4U     /*!< Manchester table: shift of the collision flags                     */
+
 
 /*
 ******************************************************************************
@@ -94,14 +101,65 @@
 ******************************************************************************
 */
 static iso15693PhyConfig_t iso15693PhyConfig; /*!< current phy configuration */
+static uint16_t            iso15693VCDCrc;     /*!< CRC of the frame being coded, built as the data is coded */
+
+/*
+******************************************************************************
+* LOCAL TABLES
+******************************************************************************
+*/
+
+/*! 1 out of 4 coding of a nibble: the two coded bytes, first pair first */
+static const uint8_t iso15693Code1Of4Tbl[16][2] =
+{
+    { ISO15693_DAT_00_1_4, ISO15693_DAT_00_1_4 }, { ISO15693_DAT_01_1_4, ISO15693_DAT_00_1_4 },
+    { ISO15693_DAT_10_1_4, ISO15693_DAT_00_1_4 }, { ISO15693_DAT_11_1_4, ISO15693_DAT_00_1_4 },
+    { ISO15693_DAT_00_1_4, ISO15693_DAT_01_1_4 }, { ISO15693_DAT_01_1_4, ISO15693_DAT_01_1_4 },
+    { ISO15693_DAT_10_1_4, ISO15693_DAT_01_1_4 }, { ISO15693_DAT_11_1_4, ISO15693_DAT_01_1_4 },
+    { ISO15693_DAT_00_1_4, ISO15693_DAT_10_1_4 }, { ISO15693_DAT_01_1_4, ISO15693_DAT_10_1_4 },
+    { ISO15693_DAT_10_1_4, ISO15693_DAT_10_1_4 }, { ISO15693_DAT_11_1_4, ISO15693_DAT_10_1_4 },
+    { ISO15693_DAT_00_1_4, ISO15693_DAT_11_1_4 }, { ISO15693_DAT_01_1_4, ISO15693_DAT_11_1_4 },
+    { ISO15693_DAT_10_1_4, ISO15693_DAT_11_1_4 }, { ISO15693_DAT_11_1_4, ISO15693_DAT_11_1_4 }
+};
+
+/*! 1 out of 256 coding: the only non zero byte of the 64 is byte data/4, holding the slot data%4 */
+static const uint8_t iso15693Code1Of256Tbl[4] =
+{
+    ISO15693_DAT_SLOT0_1_256, ISO15693_DAT_SLOT1_1_256, ISO15693_DAT_SLOT2_1_256, ISO15693_DAT_SLOT3_1_256
+};
+
+/*! Manchester decoding of 8 received bits = 4 symbol pairs, LSB first.
+ *  Pair 01b (bit order as received: 1 then 0) is a 0, pair 10b a 1, 00b and 11b are collisions.
+ *  Low nibble: decoded bits. High nibble: flags of the pairs which are no valid bit. */
+static const uint8_t iso15693ManchesterTbl[256] =
+{
+    0xF0U, 0xE0U, 0xE1U, 0xF0U, 0xD0U, 0xC0U, 0xC1U, 0xD0U, 0xD2U, 0xC2U, 0xC3U, 0xD2U, 0xF0U, 0xE0U, 0xE1U, 0xF0U,
+    0xB0U, 0xA0U, 0xA1U, 0xB0U, 0x90U, 0x80U, 0x81U, 0x90U, 0x92U, 0x82U, 0x83U, 0x92U, 0xB0U, 0xA0U, 0xA1U, 0xB0U,
+    0xB4U, 0xA4U, 0xA5U, 0xB4U, 0x94U, 0x84U, 0x85U, 0x94U, 0x96U, 0x86U, 0x87U, 0x96U, 0xB4U, 0xA4U, 0xA5U, 0xB4U,
+    0xF0U, 0xE0U, 0xE1U, 0xF0U, 0xD0U, 0xC0U, 0xC1U, 0xD0U, 0xD2U, 0xC2U, 0xC3U, 0xD2U, 0xF0U, 0xE0U, 0xE1U, 0xF0U,
+    0x70U, 0x60U, 0x61U, 0x70U, 0x50U, 0x40U, 0x41U, 0x50U, 0x52U, 0x42U, 0x43U, 0x52U, 0x70U, 0x60U, 0x61U, 0x70U,
+    0x30U, 0x20U, 0x21U, 0x30U, 0x10U, 0x00U, 0x01U, 0x10U, 0x12U, 0x02U, 0x03U, 0x12U, 0x30U, 0x20U, 0x21U, 0x30U,
+    0x34U, 0x24U, 0x25U, 0x34U, 0x14U, 0x04U, 0x05U, 0x14U, 0x16U, 0x06U, 0x07U, 0x16U, 0x34U, 0x24U, 0x25U, 0x34U,
+    0x70U, 0x60U, 0x61U, 0x70U, 0x50U, 0x40U, 0x41U, 0x50U, 0x52U, 0x42U, 0x43U, 0x52U, 0x70U, 0x60U, 0x61U, 0x70U,
+    0x78U, 0x68U, 0x69U, 0x78U, 0x58U, 0x48U, 0x49U, 0x58U, 0x5AU, 0x4AU, 0x4BU, 0x5AU, 0x78U, 0x68U, 0x69U, 0x78U,
+    0x38U, 0x28U, 0x29U, 0x38U, 0x18U, 0x08U, 0x09U, 0x18U, 0x1AU, 0x0AU, 0x0BU, 0x1AU, 0x38U, 0x28U, 0x29U, 0x38U,
+    0x3CU, 0x2CU, 0x2DU, 0x3CU, 0x1CU, 0x0CU, 0x0DU, 0x1CU, 0x1EU, 0x0EU, 0x0FU, 0x1EU, 0x3CU, 0x2CU, 0x2DU, 0x3CU,
+    0x78U, 0x68U, 0x69U, 0x78U, 0x58U, 0x48U, 0x49U, 0x58U, 0x5AU, 0x4AU, 0x4BU, 0x5AU, 0x78U, 0x68U, 0x69U, 0x78U,
+    0xF0U, 0xE0U, 0xE1U, 0xF0U, 0xD0U, 0xC0U, 0xC1U, 0xD0U, 0xD2U, 0xC2U, 0xC3U, 0xD2U, 0xF0U, 0xE0U, 0xE1U, 0xF0U,
+    0xB0U, 0xA0U, 0xA1U, 0xB0U, 0x90U, 0x80U, 0x81U, 0x90U, 0x92U, 0x82U, 0x83U, 0x92U, 0xB0U, 0xA0U, 0xA1U, 0xB0U,
+    0xB4U, 0xA4U, 0xA5U, 0xB4U, 0x94U, 0x84U, 0x85U, 0x94U, 0x96U, 0x86U, 0x87U, 0x96U, 0xB4U, 0xA4U, 0xA5U, 0xB4U,
+    0xF0U, 0xE0U, 0xE1U, 0xF0U, 0xD0U, 0xC0U, 0xC1U, 0xD0U, 0xD2U, 0xC2U, 0xC3U, 0xD2U, 0xF0U, 0xE0U, 0xE1U, 0xF0U
+};
 
 /*
 ******************************************************************************
 * LOCAL FUNCTION PROTOTYPES
 ******************************************************************************
 */
-static ReturnCode iso15693PhyVCDCode1Of4(const uint8_t data, uint8_t* outbuffer, uint16_t maxOutBufLen, uint16_t* outBufLen);
-static ReturnCode iso15693PhyVCDCode1Of256(const uint8_t data, uint8_t* outbuffer, uint16_t maxOutBufLen, uint16_t* outBufLen);
+static uint16_t iso15693VCDCodedLength(uint16_t length, bool sendCrc);
+static void iso15693PhyVCDCode1Of4(const uint8_t data, uint8_t* outbuffer, uint16_t from, uint16_t to);
+static void iso15693PhyVCDCode1Of256(const uint8_t data, uint8_t* outbuffer, uint16_t from, uint16_t to);
+static bool iso15693VICCIsEOF(const uint8_t *inBuf, uint16_t inBufLen, uint16_t mp);
 
 
 
@@ -144,143 +202,130 @@ ReturnCode iso15693PhyGetConfiguration(iso15693PhyConfig_t* config)
     return ERR_NONE;
 }
 
+/*! 
+ *****************************************************************************
+ *  \brief  Get the coded length of an ISO15693 frame
+ *
+ *  Returns the exact number of bytes iso15693VCDCode() produces for the
+ *  frame with the current coding, SOF and EOF included, before coding it.
+ *
+ *  \param[in] length : number of bytes to send.
+ *  \param[in] sendCrc : If set to true, CRC is appended to the frame
+ *
+ *  \return number of coded bytes, 1 (EOF only) for an empty frame.
+ *
+ *****************************************************************************
+ */
+static uint16_t iso15693VCDCodedLength(uint16_t length, bool sendCrc)
+{
+    uint16_t symLen;
+    
+    /* An empty frame is the EOF alone */
+    if (length == 0U)
+    {
+        return 1U;
+    }
+    
+    symLen = ((ISO15693_VCD_CODING_1_4 == iso15693PhyConfig.coding) ? ISO15693_SYMBOL_LEN_1_4 : ISO15693_SYMBOL_LEN_1_256);
+    
+    return (uint16_t)( 1U                                                          /* SOF */
+                     + ((length + (uint16_t)((sendCrc) ? 2U : 0U)) * symLen)
+                     + 1U );                                                     /* EOF */
+}
+
 ReturnCode iso15693VCDCode(uint8_t* buffer, uint16_t length, bool sendCrc, bool sendFlags, bool picopassMode,
                    uint16_t *subbit_total_length, uint16_t *offset,
                    uint8_t* outbuf, uint16_t outBufSize, uint16_t* actOutBufSize)
 {
-    ReturnCode err = ERR_NONE;
-    uint8_t eof, sof;
-    uint8_t transbuf[2];
-    uint16_t crc = 0;
-    ReturnCode (*txFunc)(const uint8_t data, uint8_t* outbuffer, uint16_t maxOutBufLen, uint16_t* outBufLen);
-    uint8_t crc_len;
-    uint8_t* outputBuf;
-    uint16_t outputBufSize;
-
-    crc_len = (uint8_t)((sendCrc)?2:0);
+    uint16_t total;
+    uint16_t symLen;
+    uint16_t pos;
+    uint16_t end;
+    uint16_t sym;
+    uint16_t from;
+    uint16_t to;
+    uint8_t  data;
 
     *actOutBufSize = 0;
+    
+    symLen = ((ISO15693_VCD_CODING_1_4 == iso15693PhyConfig.coding) ? ISO15693_SYMBOL_LEN_1_4 : ISO15693_SYMBOL_LEN_1_256);
+    total  = iso15693VCDCodedLength(length, sendCrc);
+    *subbit_total_length = total;
+    
+    if (outBufSize == 0U)
+    {
+        return ERR_NOMEM;
+    }
+    
+    pos = *offset;
+    end = (uint16_t)MIN( total, (pos + outBufSize) );
 
-    if (ISO15693_VCD_CODING_1_4 == iso15693PhyConfig.coding)
+    if (0U == pos)
     {
-        sof = ISO15693_DAT_SOF_1_4;
-        eof = ISO15693_DAT_EOF_1_4;
-        txFunc = iso15693PhyVCDCode1Of4;
-        *subbit_total_length = (
-                ( 1U  /* SOF */
-                  + ((length + (uint16_t)crc_len) * 4U)
-                  + 1U) /* EOF */
-                );
-        if (outBufSize < 5U) { /* 5 should be safe: enough for sof + 1byte data in 1of4 */
-            return ERR_NOMEM;
+        if ((length != 0U) && sendFlags && !picopassMode)
+        {
+            /* set high datarate flag */
+            buffer[0] |= (uint8_t)ISO15693_REQ_FLAG_HIGH_DATARATE;
+            /* clear sub-carrier flag - we only support single sub-carrier */
+            buffer[0] = (uint8_t)(buffer[0] & ~ISO15693_REQ_FLAG_TWO_SUBCARRIERS);  /* MISRA 10.3 */
+        }
+        
+        iso15693VCDCrc = ((picopassMode) ? 0xE012U : 0xFFFFU);       /* In PicoPass Mode a different Preset Value is used   */
+        
+        /* Send SOF */
+        if (length != 0U)
+        {
+            outbuf[(*actOutBufSize)++] = ((ISO15693_VCD_CODING_1_4 == iso15693PhyConfig.coding) ? ISO15693_DAT_SOF_1_4 : ISO15693_DAT_SOF_1_256);
+            pos++;
         }
     }
-    else
+    
+    /* Data and CRC symbols, resuming in the middle of a symbol if the last call stopped there */
+    while ((pos < end) && (pos < (total - 1U)))
     {
-        sof = ISO15693_DAT_SOF_1_256;
-        eof = ISO15693_DAT_EOF_1_256;
-        txFunc = iso15693PhyVCDCode1Of256;
-        *subbit_total_length = (
-                ( 1U  /* SOF */
-                  + ((length + (uint16_t)crc_len) * 64U) 
-                  + 1U) /* EOF */
-                );
-
-        if (*offset != 0U)
+        sym  = ((pos - 1U) / symLen);
+        from = ((pos - 1U) % symLen);
+        to   = (uint16_t)MIN( symLen, (from + (end - pos)) );
+        
+        if (sym < length)
         {
-            if (outBufSize < 64U) { /* 64 should be safe: enough a single byte data in 1of256 */
-                return ERR_NOMEM;
+            data = buffer[sym];
+            
+            /* The CRC follows the coding, each data byte is added as its symbol starts */
+            if ((from == 0U) && (!picopassMode || (sym != 0U)))                  /* CMD byte is not taken into account in PicoPass mode */
+            {
+                iso15693VCDCrc = rfalCrcUpdateCcittByte(iso15693VCDCrc, data);
             }
         }
         else
         {
-            if (outBufSize < 65U) { /* At beginning of a frame we need at least 65 bytes to start: enough for sof + 1byte data in 1of256 */
-                return ERR_NOMEM;
-            }
+            /* send crc */
+            data = (uint8_t)(((picopassMode) ? iso15693VCDCrc : (uint16_t)~iso15693VCDCrc) >> ((sym - length) * 8U));
         }
-    }
-
-    if (length == 0U)
-    {
-        *subbit_total_length = 1;
-    }
-
-    if ((length != 0U) && (0U == *offset) && sendFlags && !picopassMode)
-    {
-        /* set high datarate flag */
-        buffer[0] |= (uint8_t)ISO15693_REQ_FLAG_HIGH_DATARATE;
-        /* clear sub-carrier flag - we only support single sub-carrier */
-        buffer[0] = (uint8_t)(buffer[0] & ~ISO15693_REQ_FLAG_TWO_SUBCARRIERS);  /* MISRA 10.3 */
-    }
-
-    outputBuf = outbuf;             /* MISRA 17.8: Use intermediate variable */
-    outputBufSize = outBufSize;     /* MISRA 17.8: Use intermediate variable */
-
-    /* Send SOF if at 0 offset */
-    if ((length != 0U) && (0U == *offset))
-    {
-        *outputBuf = sof; 
-        (*actOutBufSize)++;
-        outputBufSize--;
-        outputBuf++;
-    }
-
-    while ((*offset < length) && (err == ERR_NONE))
-    {
-        uint16_t filled_size;
-        /* send data */
-        err = txFunc(buffer[*offset], outputBuf, outputBufSize, &filled_size);
-        (*actOutBufSize) += filled_size;
-        outputBuf = &outputBuf[filled_size];	/* MISRA 18.4: Avoid pointer arithmetic */
-        outputBufSize -= filled_size;
-        if (err == ERR_NONE) {
-            (*offset)++;
-        }
-    }
-    if (err != ERR_NONE) {
-        return ERR_AGAIN;
-    }
-
-    while ((err == ERR_NONE) && sendCrc && (*offset < (length + 2U)))
-    {
-        uint16_t filled_size;
-        if (0U==crc)
+        
+        if (ISO15693_VCD_CODING_1_4 == iso15693PhyConfig.coding)
         {
-            crc = rfalCrcCalculateCcitt( (uint16_t) ((picopassMode) ? 0xE012U : 0xFFFFU),        /* In PicoPass Mode a different Preset Value is used   */
-                                                    ((picopassMode) ? (buffer + 1U) : buffer),   /* CMD byte is not taken into account in PicoPass mode */
-                                                    ((picopassMode) ? (length - 1U) : length));  /* CMD byte is not taken into account in PicoPass mode */
-            
-            crc = ((picopassMode) ? crc : ~crc);
+            iso15693PhyVCDCode1Of4(data, &outbuf[*actOutBufSize], from, to);
         }
-        /* send crc */
-        transbuf[0] = (uint8_t)(crc & 0xffU);
-        transbuf[1] = (uint8_t)((crc >> 8) & 0xffU);
-        err = txFunc(transbuf[*offset - length], outputBuf, outputBufSize, &filled_size);
-        (*actOutBufSize) += filled_size;
-        outputBuf = &outputBuf[filled_size];	/* MISRA 18.4: Avoid pointer arithmetic */
-        outputBufSize -= filled_size;
-        if (err == ERR_NONE) {
-            (*offset)++;
+        else
+        {
+            iso15693PhyVCDCode1Of256(data, &outbuf[*actOutBufSize], from, to);
         }
+        
+        *actOutBufSize += (to - from);
+        pos            += (to - from);
     }
-    if (err != ERR_NONE) {
-        return ERR_AGAIN;
-    }
-
-    if ((!sendCrc && (*offset == length))
-            || (sendCrc && (*offset == (length + 2U))))
-    {
-        *outputBuf = eof; 
-        (*actOutBufSize)++;
-        outputBufSize--;
-        outputBuf++;
-    }
-    else
+    
+    /* Send EOF */
+    if ((pos < end) && (pos == (total - 1U)))
     {
-        return ERR_AGAIN;
+        outbuf[(*actOutBufSize)++] = ((ISO15693_VCD_CODING_1_4 == iso15693PhyConfig.coding) ? ISO15693_DAT_EOF_1_4 : ISO15693_DAT_EOF_1_256);
+        pos++;
     }
+    
+    *offset = pos;
 
-    return err;
+    return ((pos < total) ? ERR_AGAIN : ERR_NONE);
 }
 
 ReturnCode iso15693VICCDecode(const uint8_t *inBuf,
@@ -296,6 +341,11 @@ ReturnCode iso15693VICCDecode(const uint8_t *inBuf,
     uint16_t crc;
     uint16_t mp; /* Current bit position in manchester bit inBuf*/
     uint16_t bp; /* Current bit position in outBuf */
+    uint16_t prevBp;
+    uint8_t  man;
+    uint8_t  pairs;
+    bool     isEOF = false;
+    bool     stop  = false;
 
     *bitsBeforeCol = 0;
     *outBufPos = 0;
@@ -323,47 +373,81 @@ ReturnCode iso15693VICCDecode(const uint8_t *inBuf,
         return ERR_CRC;
     }
 
-    for ( ; mp < ((inBufLen * 8U) - 2U); mp+=2U )
+    /* The CRC runs along the decoding, two bytes behind: once EOF is found it covers all but the received CRC */
+    crc = ((picopassMode) ? 0xE012U : 0xFFFFU);
+    
+    while ( (mp < ((inBufLen * 8U) - 2U)) && !stop )
     {
-        bool isEOF = false;
+        pairs = 1;
         
-        uint8_t man;
-        man  = (inBuf[mp/8U] >> (mp%8U)) & 0x1U;
-        man |= ((inBuf[(mp+1U)/8U] >> ((mp+1U)%8U)) & 0x1U) << 1;
-        if (1U == man)
-        {
-            bp++;
-        }
-        if (2U == man)
+        if ((mp + 8U) < (inBufLen * 8U))
         {
-            outBuf[bp/8U] = (uint8_t)(outBuf[bp/8U] | (1U <<(bp%8U)));  /* MISRA 10.3 */
-            bp++;
-        }
-        if ((bp%8U) == 0U)
-        { /* Check for EOF */
-            ISO_15693_DEBUG("ceof %hhx %hhx\n", inBuf[mp/8U], inBuf[mp/8+1]);
-            if ( ((inBuf[mp/8U]   & 0xe0U) == 0xa0U)
-               &&(inBuf[(mp/8U)+1U] == 0x03U))
-            { /* Now we know that it was 10111000 = EOF */
-                ISO_15693_DEBUG("EOF\n");
-                isEOF = true;
+            /* Next 4 pairs: bits 5..7 of this byte and 0..4 of the next one (mp is always 5 modulo 8 here) */
+            man = iso15693ManchesterTbl[ (uint8_t)((inBuf[mp/8U] >> 5) | (inBuf[(mp/8U)+1U] << 3)) ];
+            
+            if ((man & ISO15693_MAN_COL_MASK) == 0U)
+            {   /* Fast path: 4 data bits, half a byte */
+                outBuf[bp/8U] = (uint8_t)(outBuf[bp/8U] | ((man & ISO15693_MAN_DATA_MASK) << (bp%8U)));  /* MISRA 10.3 */
+                bp += 4U;
+                mp += 8U;
+                
+                if ((bp%8U) == 0U)
+                {
+                    if ((bp/8U) > 2U)
+                    {
+                        crc = rfalCrcUpdateCcittByte(crc, outBuf[(bp/8U) - 3U]);
+                    }
+                    
+                    /* Check for EOF right after the last pair */
+                    isEOF = iso15693VICCIsEOF(inBuf, inBufLen, (mp - 2U));
+                    stop  = (isEOF || (bp >= (outBufLen * 8U)));
+                }
+                continue;
             }
+            
+            /* Collision or EOF within: go through the 4 pairs one by one */
+            pairs = 4;
         }
-        if ( ((0U == man) || (3U == man)) && !isEOF )
-        {  
-            if (bp >= ignoreBits)
+        
+        for ( ; (pairs > 0U) && !stop; pairs--, mp+=2U )
+        {
+            prevBp = bp;
+            
+            man  = (inBuf[mp/8U] >> (mp%8U)) & 0x1U;
+            man |= ((inBuf[(mp+1U)/8U] >> ((mp+1U)%8U)) & 0x1U) << 1;
+            if (1U == man)
             {
-                err = ERR_RF_COLLISION;
+                bp++;
             }
-            else
+            if (2U == man)
             {
-                /* ignored collision: leave as 0 */
+                outBuf[bp/8U] = (uint8_t)(outBuf[bp/8U] | (1U <<(bp%8U)));  /* MISRA 10.3 */
                 bp++;
             }
-        }
-        if ( (bp >= (outBufLen * 8U)) || (err == ERR_RF_COLLISION) || isEOF )        
-        { /* Don't write beyond the end */
-            break;
+            if ((bp%8U) == 0U)
+            { /* Check for EOF */
+                isEOF = iso15693VICCIsEOF(inBuf, inBufLen, mp);
+            }
+            if ( ((0U == man) || (3U == man)) && !isEOF )
+            {  
+                if (bp >= ignoreBits)
+                {
+                    err = ERR_RF_COLLISION;
+                }
+                else
+                {
+                    /* ignored collision: leave as 0 */
+                    bp++;
+                }
+            }
+            if ( (bp != prevBp) && ((bp%8U) == 0U) && ((bp/8U) > 2U) )
+            {
+                crc = rfalCrcUpdateCcittByte(crc, outBuf[(bp/8U) - 3U]);
+            }
+            if ( (bp >= (outBufLen * 8U)) || (err == ERR_RF_COLLISION) || isEOF )        
+            { /* Don't write beyond the end */
+                stop = true;
+            }
         }
     }
 
@@ -386,7 +470,7 @@ ReturnCode iso15693VICCDecode(const uint8_t *inBuf,
         ISO_15693_DEBUG("Calculate CRC, val: 0x%x, outBufLen: ", *outBuf);
         ISO_15693_DEBUG("0x%x ", *outBufPos - 2);
         
-        crc = rfalCrcCalculateCcitt(((picopassMode) ? 0xE012U : 0xFFFFU), outBuf, *outBufPos - 2U);
+        /* CRC over all but the last 2 bytes was computed while decoding */
         crc = ((picopassMode) ? crc : ~crc);
         
         if (((crc & 0xffU) == outBuf[*outBufPos-2U]) &&
@@ -417,118 +501,97 @@ ReturnCode iso15693VICCDecode(const uint8_t *inBuf,
 */
 /*! 
  *****************************************************************************
- *  \brief  Perform 1 of 4 coding and send coded data
- *
- *  This function takes \a length bytes from \a buffer, perform 1 of 4 coding
- *  (see ISO15693-2 specification) and sends the data using stream mode.
+ *  \brief  Perform 1 of 4 coding
  *
- *  \param[in] sendSof : send SOF prior to data.
- *  \param[in] buffer : data to send.
- *  \param[in] length : number of bytes to send.
+ *  Codes \a data into its 4 bytes (see ISO15693-2 specification) and stores
+ *  the bytes \a from up to \a to (excluded) of them.
  *
- *  \return ERR_IO : Error during communication.
- *  \return ERR_NONE : No error.
+ *  \param[in] data : data byte to code.
+ *  \param[out] outbuffer : where to store the coded bytes.
+ *  \param[in] from : first coded byte to store.
+ *  \param[in] to : coded byte to stop at, 4 for the whole symbol.
  *
  *****************************************************************************
  */
-static ReturnCode iso15693PhyVCDCode1Of4(const uint8_t data, uint8_t* outbuffer, uint16_t maxOutBufLen, uint16_t* outBufLen)
+static void iso15693PhyVCDCode1Of4(const uint8_t data, uint8_t* outbuffer, uint16_t from, uint16_t to)
 {
-    uint8_t tmp;
-    ReturnCode err = ERR_NONE;
+    uint8_t coded[ISO15693_SYMBOL_LEN_1_4];
     uint16_t a;
-    uint8_t* outbuf = outbuffer;
 
-    *outBufLen = 0;
-
-    if (maxOutBufLen < 4U) {
-        return ERR_NOMEM;
+    if ((from == 0U) && (to == ISO15693_SYMBOL_LEN_1_4))
+    {
+        outbuffer[0] = iso15693Code1Of4Tbl[data & 0x0FU][0];
+        outbuffer[1] = iso15693Code1Of4Tbl[data & 0x0FU][1];
+        outbuffer[2] = iso15693Code1Of4Tbl[data >> 4][0];
+        outbuffer[3] = iso15693Code1Of4Tbl[data >> 4][1];
+        return;
     }
-
-    tmp = data;
-    for (a = 0; a < 4U; a++)
+    
+    /* Partial symbol at the start or end of a buffer */
+    coded[0] = iso15693Code1Of4Tbl[data & 0x0FU][0];
+    coded[1] = iso15693Code1Of4Tbl[data & 0x0FU][1];
+    coded[2] = iso15693Code1Of4Tbl[data >> 4][0];
+    coded[3] = iso15693Code1Of4Tbl[data >> 4][1];
+    for (a = from; a < to; a++)
     {
-        switch (tmp & 0x3U)
-        {
-            case 0:
-                *outbuf = ISO15693_DAT_00_1_4;
-                break;
-            case 1:
-                *outbuf = ISO15693_DAT_01_1_4;
-                break;
-            case 2:
-                *outbuf = ISO15693_DAT_10_1_4;
-                break;
-            case 3:
-                *outbuf = ISO15693_DAT_11_1_4;
-                break;
-            default:
-                /* MISRA 16.4: mandatory default statement */
-                break;
-        }
-        outbuf++;
-        (*outBufLen)++;
-        tmp >>= 2;
+        outbuffer[a - from] = coded[a];
     }
-    return err;
 }
 
 /*! 
  *****************************************************************************
- *  \brief  Perform 1 of 256 coding and send coded data
+ *  \brief  Perform 1 of 256 coding
  *
- *  This function takes \a length bytes from \a buffer, perform 1 of 256 coding
- *  (see ISO15693-2 specification) and sends the data using stream mode.
- *  \note This function sends SOF prior to the data.
+ *  Codes \a data into its 64 bytes (see ISO15693-2 specification) and stores
+ *  the bytes \a from up to \a to (excluded) of them.
  *
- *  \param[in] sendSof : send SOF prior to data.
- *  \param[in] buffer : data to send.
- *  \param[in] length : number of bytes to send.
- *
- *  \return ERR_IO : Error during communication.
- *  \return ERR_NONE : No error.
+ *  \param[in] data : data byte to code.
+ *  \param[out] outbuffer : where to store the coded bytes.
+ *  \param[in] from : first coded byte to store.
+ *  \param[in] to : coded byte to stop at, 64 for the whole symbol.
  *
  *****************************************************************************
  */
-static ReturnCode iso15693PhyVCDCode1Of256(const uint8_t data, uint8_t* outbuffer, uint16_t maxOutBufLen, uint16_t* outBufLen)
+static void iso15693PhyVCDCode1Of256(const uint8_t data, uint8_t* outbuffer, uint16_t from, uint16_t to)
 {
-    uint8_t tmp;
-    ReturnCode err = ERR_NONE;
-    uint16_t a;
-    uint8_t* outbuf = outbuffer;
-
-    *outBufLen = 0;
+    uint16_t slot = ((uint16_t)data >> 2);
 
-    if (maxOutBufLen < 64U) {
-        return ERR_NOMEM;
-    }
-
-    tmp = data;
-    for (a = 0; a < 64U; a++)
+    ST_MEMSET(outbuffer, 0x00, (to - from));
+    
+    if ((slot >= from) && (slot < to))
     {
-        switch (tmp)
-        {
-            case 0:
-                *outbuf = ISO15693_DAT_SLOT0_1_256;
-                break;
-            case 1:
-                *outbuf = ISO15693_DAT_SLOT1_1_256;
-                break;
-            case 2:
-                *outbuf = ISO15693_DAT_SLOT2_1_256;
-                break;
-            case 3:
-                *outbuf = ISO15693_DAT_SLOT3_1_256;
-                break;
-            default:
-                *outbuf = 0;
-                break;               
-        }
-        outbuf++;
-        (*outBufLen)++;
-        tmp -= 4U;
+        outbuffer[slot - from] = iso15693Code1Of256Tbl[data & 0x03U];
     }
+}
 
-    return err;
+/*! 
+ *****************************************************************************
+ *  \brief  Check for EOF after a Manchester pair
+ *
+ *  Called on a byte boundary of the decoded data, checks whether the
+ *  received bits following the pair at \a mp are the VICC EOF (10111000).
+ *
+ *  \param[in] inBuf : received bit stream.
+ *  \param[in] inBufLen : length of the bit stream in bytes.
+ *  \param[in] mp : position of the last decoded pair.
+ *
+ *  \return true : EOF follows.
+ *
+ *****************************************************************************
+ */
+static bool iso15693VICCIsEOF(const uint8_t *inBuf, uint16_t inBufLen, uint16_t mp)
+{
+    ISO_15693_DEBUG("ceof %hhx %hhx\n", inBuf[mp/8U], inBuf[mp/8+1]);
+    
+    if ( (((mp/8U)+1U) < inBufLen)
+       &&((inBuf[mp/8U]   & 0xe0U) == 0xa0U)
+       &&(inBuf[(mp/8U)+1U] == 0x03U))
+    { /* Now we know that it was 10111000 = EOF */
+        ISO_15693_DEBUG("EOF\n");
+        return true;
+    }
+    return false;
 }
 
 #endif /* RFAL_FEATURE_NFCV */
+
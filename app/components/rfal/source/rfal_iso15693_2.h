@@ -135,6 +135,8 @@ extern ReturnCode iso15693PhyGetConfiguration(iso15693PhyConfig_t* config);
  *
  *  This function takes \a length bytes from \a buffer, perform proper
  *  encoding and sends out the frame to the ST25R3911.
+ *  Each call fills \a outbuf completely, or up to the end of the frame,
+ *  stopping within a symbol if needed. The CRC is computed while coding.
  *
  *  \param[in] buffer : data to send, modified to adapt flags.
  *  \param[in] length : number of bytes to send.
@@ -143,17 +145,16 @@ extern ReturnCode iso15693PhyGetConfiguration(iso15693PhyConfig_t* config);
  *                        ISO15693.
  *  \param[in] picopassMode :  If set to true, the coding will be according to Picopass
  *  \param[out] subbit_total_length : Return the complete bytes which need to 
- *                                   be send for the current coding
+ *                                   be send for the current coding, SOF and EOF included
  *  \param[in,out] offset : Set to 0 for first transfer, function will update it to
-                            point to next byte to be coded
+                            the number of coded bytes produced so far
  *  \param[out] outbuf : buffer where the function will store the coded subbit stream
  *  \param[out] outBufSize : the size of the output buffer
  *  \param[out] actOutBufSize : the amount of data stored into the buffer at this call
  *
  *  \return ERR_IO : Error during communication.
  *  \return ERR_AGAIN : Data was not coded all the way. Call function again with a new/emptied buffer
- *  \return ERR_NO_MEM : In case outBuf is not big enough. Needs to have at 
-                         least 5 bytes for 1of4 coding and 65 bytes for 1of256 coding
+ *  \return ERR_NO_MEM : In case outBufSize is 0
  *  \return ERR_NONE : No error.
  *
  *****************************************************************************
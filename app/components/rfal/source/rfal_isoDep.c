@@ -387,13 +387,13 @@ typedef struct{
   rfalBitRate     rxBR;          /*!< Current Rx Bit Rate                       */
   uint16_t        *rxLen;        /*!< Output parameter ptr to Rx length         */
   bool            *rxChaining;   /*!< Output parameter ptr to Rx chaining flag  */  
-  uint32_t        WTXTimer;      /*!< Timer used for WTX                        */
+  uint64_t        WTXTimer;      /*!< Timer used for WTX                        */
   bool            lastDID00;     /*!< Last PCD block had DID flag (for DID = 0) */
   
   bool            isTxPending;   /*!< Flag pending Block while waiting WTX Ack  */
   bool            isWait4WTX;    /*!< Flag for waiting WTX Ack                  */
   
-  uint32_t        SFGTTimer;     /*!< Timer used for SFGT                       */
+  uint64_t        SFGTTimer;     /*!< Timer used for SFGT                       */
   
   uint8_t         maxRetriesI;   /*!< Number of retries for a I-Block           */
   uint8_t         maxRetriesS;   /*!< Number of retries for a S-Block           */
@@ -1391,6 +1391,113 @@ ReturnCode rfalIsoDepListenGetActivationStatus( void )
 #endif  /* RFAL_FEATURE_ISO_DEP_LISTEN */
 
 
+#if RFAL_FEATURE_ISO_DEP_POLL
+
+/*******************************************************************************/
+ReturnCode rfalIsoDepSaveSession( rfalIsoDepSession *session )
+{
+    if( session == NULL )
+    {
+        return ERR_PARAM;
+    }
+    
+    /* Only a PCD in between exchanges has a consistent state to hand over */
+    if( (gIsoDep.role != ISODEP_ROLE_PCD) || (gIsoDep.state != ISODEP_ST_IDLE) )
+    {
+        return ERR_WRONG_STATE;
+    }
+    
+    session->blockNumber = gIsoDep.blockNumber;
+    session->DID         = gIsoDep.did;
+    session->NAD         = gIsoDep.nad;
+    session->FWT         = gIsoDep.fwt;
+    session->dFWT        = gIsoDep.dFwt;
+    session->FSx         = gIsoDep.fsx;
+    session->ourFSx      = gIsoDep.ourFsx;
+    
+    return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode rfalIsoDepRestoreSession( const rfalIsoDepSession *session )
+{
+    if( session == NULL )
+    {
+        return ERR_PARAM;
+    }
+    
+    if( (gIsoDep.role != ISODEP_ROLE_PCD) || (gIsoDep.state != ISODEP_ST_IDLE) )
+    {
+        return ERR_WRONG_STATE;
+    }
+    
+    gIsoDep.blockNumber = session->blockNumber;
+    gIsoDep.did         = session->DID;
+    gIsoDep.nad         = session->NAD;
+    gIsoDep.fwt         = session->FWT;
+    gIsoDep.dFwt        = session->dFWT;
+    gIsoDep.fsx         = session->FSx;
+    gIsoDep.ourFsx      = session->ourFSx;
+    
+    /* Retransmission context belongs to the previous PICC */
+    gIsoDep.isTxChaining = false;
+    gIsoDep.isRxChaining = false;
+    gIsoDep.lastPCB      = ISODEP_PCB_INVALID;
+    isoDepClearCounters();
+    
+    return ERR_NONE;
+}
+
+
+/*******************************************************************************/
+ReturnCode rfalIsoDepPresenceCheck( void )
+{
+    ReturnCode ret;
+    uint8_t    txBuf[ISODEP_CONTROLMSG_BUF_LEN];
+    uint8_t    rxBuf[ISODEP_CONTROLMSG_BUF_LEN];
+    uint16_t   txLen;
+    uint16_t   rxLen;
+    
+    if( (gIsoDep.role != ISODEP_ROLE_PCD) || (gIsoDep.state != ISODEP_ST_IDLE) )
+    {
+        return ERR_WRONG_STATE;
+    }
+    
+    /* Local buffers, the INF buffers of the last exchange may be long gone */
+    txLen          = 0;
+    txBuf[txLen++] = isoDep_PCBRNAK( gIsoDep.blockNumber );
+    
+    if( gIsoDep.did != RFAL_ISODEP_NO_DID )
+    {
+        txBuf[0]      |= ISODEP_PCB_DID_BIT;
+        txBuf[txLen++] = gIsoDep.did;
+    }
+    
+    ret = rfalTransceiveBlockingTxRx( txBuf, txLen, rxBuf, (uint16_t)sizeof(rxBuf), &rxLen, RFAL_TXRX_FLAGS_DEFAULT, (gIsoDep.fwt + gIsoDep.dFwt) );
+    if( ret != ERR_NONE )
+    {
+        return ret;
+    }
+    
+    /* Block number is not checked, the PICC acknowledges whatever block it is on */
+    if( (rxLen < RFAL_ISODEP_PCB_LEN) || !isoDep_PCBisRACK( rxBuf[0] ) )
+    {
+        return ERR_PROTO;
+    }
+    
+    /* With several PICCs active the answer must come from the addressed one */
+    if( (gIsoDep.did != RFAL_ISODEP_NO_DID) && ( !isoDep_PCBhasDID( rxBuf[0] ) || (rxLen < (RFAL_ISODEP_PCB_LEN + RFAL_ISODEP_DID_LEN)) || (rxBuf[RFAL_ISODEP_PCB_LEN] != gIsoDep.did) ) )
+    {
+        return ERR_PROTO;
+    }
+    
+    return ERR_NONE;
+}
+
+#endif  /* RFAL_FEATURE_ISO_DEP_POLL */
+
+
 /*******************************************************************************/
 uint16_t rfalIsoDepGetMaxInfLen( void )
 {
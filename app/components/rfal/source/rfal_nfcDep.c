@@ -323,7 +323,7 @@ typedef struct{
   
   rfalNfcDepDevice        *nfcDepDev;        /*!< Pointer to NFC-DEP device info                */
 
-  uint32_t                RTOXTimer;         /*!< Timer used for RTOX                           */  
+  uint64_t                RTOXTimer;         /*!< Timer used for RTOX                           */  
   rfalNfcDepDeactCallback isDeactivating;    /*!< Deactivating flag check callback              */
   
   bool                    isReqPending;      /*!< Flag pending REQ from Target activation       */
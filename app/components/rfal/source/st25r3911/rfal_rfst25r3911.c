@@ -98,9 +98,9 @@ typedef struct{
 
 /*! Struct that holds the software timers                                 */
 typedef struct{
-    uint32_t                GT;          /*!< RFAL's GT timer             */
-    uint32_t                FWT;         /*!< FWT/RWT timer for Active P2P*/
-    uint32_t                RXE;         /*!< Timer between RXS and RXE   */ 
+    uint64_t                GT;          /*!< RFAL's GT timer             */
+    uint64_t                FWT;         /*!< FWT/RWT timer for Active P2P*/
+    uint64_t                RXE;         /*!< Timer between RXS and RXE   */ 
 } rfalTimers;
 
 
@@ -120,6 +120,24 @@ typedef struct{
 } rfalFIFO;
 
 
+/*! Struct that holds the Tx chunk staged for the next FIFO refill, written from the IRQ context as soon as the WL interrupt lands */
+typedef struct{
+    const uint8_t*          buf;         /*!< Next chunk to be written on FIFO                                                           */
+    uint16_t                len;         /*!< Length of the next chunk                                                                   */
+    volatile bool           armed;       /*!< Chunk staged and owned by the IRQ context until TXE, changed under the comm lock only      */
+    volatile ReturnCode     err;         /*!< NFC-V coder error on the last chunk staged, the frame cannot be completed                  */
+} rfalTxStream;
+
+
+/*! Struct that holds the state of the Rx FIFO drain done from the IRQ context */
+typedef struct{
+    volatile bool           armed;       /*!< Rx ongoing, WL is drained from the IRQ context until RXE, changed under the comm lock only */
+    uint8_t                 peakLevel;   /*!< Highest FIFO level seen on the current frame                                               */
+    uint8_t                 drains;      /*!< FIFO drains done on the current frame                                                      */
+    bool                    overflow;    /*!< FIFO overflow seen on the current frame                                                    */
+} rfalRxStream;
+
+
 /*! Struct that holds RFAL's configuration settings                                                      */
 typedef struct{    
     uint8_t                 obsvModeTx;  /*!< RFAL's config of the ST25R3911's observation mode while Tx */
@@ -148,7 +166,7 @@ typedef struct{
  *    ISO15693 frame: SOF + Flags + Data + CRC + EOF  
  */
 typedef struct{    
-    uint8_t               codingBuffer[((2 + 255 + 3)*2)];/*!< Coding buffer,   length MUST be above 64: [65; ...]                   */
+    uint8_t               codingBuffer[((2 + 255 + 3)*2)];/*!< Coding buffer, holds one FIFO load of coded bytes                      */
     uint16_t              nfcvOffset;                     /*!< Offset needed for ISO15693 coding function                            */
     rfalTransceiveContext origCtx;                        /*!< Context provided by user                                              */
     uint16_t              ignoreBits;                     /*!< Number of bits at the beginning of a frame to be ignored when decoding*/
@@ -170,6 +188,9 @@ typedef struct{
     rfalWum               wum;       /*!< RFAL's Wake-Up mode management                  */
     
     rfalFIFO              fifo;      /*!< RFAL's FIFO management                          */
+    rfalTxStream          txStream;  /*!< RFAL's Tx FIFO refill staging                   */
+    rfalRxStream          rxStream;  /*!< RFAL's Rx FIFO drain state                      */
+    rfalRxStats           rxStats;   /*!< RFAL's Rx FIFO statistics                       */
     rfalTimers            tmr;       /*!< RFAL's Software timers                          */
     rfalCallbacks         callbacks; /*!< RFAL's callbacks                                */
     
@@ -216,6 +237,7 @@ typedef enum
 #define RFAL_FIFO_STATUS_REG1           0U                                             /*!< Location of FIFO status register 1 in local copy                                */
 #define RFAL_FIFO_STATUS_REG2           1U                                             /*!< Location of FIFO status register 2 in local copy                                */
 #define RFAL_FIFO_STATUS_INVALID        0xFFU                                          /*!< Value indicating that the local FIFO status in invalid|cleared                  */
+#define RFAL_FIFO_RX_NEAR_MISS          (ST25R3911_FIFO_DEPTH - 8U)                    /*!< FIFO level on Rx from which a frame is accounted as an overflow near-miss       */
 
 #define RFAL_ST25R3911_GPT_MAX_1FC      rfalConv8fcTo1fc(  0xFFFFU )                   /*!< Max GPT steps in 1fc (0xFFFF steps of 8/fc    => 0xFFFF * 590ns  = 38,7ms)      */
 #define RFAL_ST25R3911_NRT_MAX_1FC      rfalConv4096fcTo1fc( 0xFFFFU )                 /*!< Max NRT steps in 1fc (0xFFFF steps of 4096/fc => 0xFFFF * 302us  = 19.8s )      */
@@ -223,8 +245,7 @@ typedef enum
 #define RFAL_ST25R3911_MRT_MAX_1FC      rfalConv64fcTo1fc( 0x00FFU )                   /*!< Max MRT steps in 1fc (0x00FF steps of 64/fc   => 0x00FF * 4.72us = 1.2ms )      */
 #define RFAL_ST25R3911_MRT_MIN_1FC      rfalConv64fcTo1fc( 0x0004U )                   /*!< Min MRT steps in 1fc ( 0<=mrt<=4 ; 4 (64/fc)  => 0x0004 * 4.72us = 18.88us )    */
 #define RFAL_ST25R3911_GT_MAX_1FC       rfalConvMsTo1fc( 5000U )                       /*!< Max GT value allowed in 1/fc                                                    */
-#define RFAL_ST25R3911_GT_MIN_1FC       rfalConvMsTo1fc(RFAL_ST25R3911_SW_TMR_MIN_1MS) /*!< Min GT value allowed in 1/fc                                                    */
-#define RFAL_ST25R3911_SW_TMR_MIN_1MS   1U                                             /*!< Min value of a SW timer in ms                                                   */
+#define RFAL_ST25R3911_SW_TMR_MIN_1US   1U                                             /*!< Min value of a SW timer in us (0 would wait forever)                            */
 
 #define RFAL_OBSMODE_DISABLE            0x00U                                          /*!< Observation Mode disabled                                                       */
 
@@ -314,7 +335,7 @@ typedef enum
 
 #define rfalCalcNumBytes( nBits )                (((uint32_t)(nBits) + 7U) / 8U)                          /*!< Returns the number of bytes required to fit given the number of bits */
 
-#define rfalTimerStart( timer, time_ms )         (timer) = platformTimerCreate((uint16_t)(time_ms))       /*!< Configures and starts the RTOX timer          */
+#define rfalTimerStart( timer, time_us )         (timer) = platformTimerCreateUs((uint32_t)(time_us))     /*!< Configures and starts the RTOX timer          */
 #define rfalTimerisExpired( timer )              platformTimerIsExpired( timer )                          /*!< Checks if timer has expired                   */
 
 #define rfalST25R3911ObsModeDisable()            st25r3911WriteTestRegister(0x01U, 0x00U)                 /*!< Disable ST25R3911 Observation mode                                                               */
@@ -361,6 +382,37 @@ static void rfalErrorHandling( void );
 static ReturnCode rfalRunTransceiveWorker( void );
 static ReturnCode rfalRunListenModeWorker( void );
 static void rfalRunWakeUpModeWorker( void );
+static ReturnCode rfalSetModeBatched( rfalMode mode, rfalBitRate txBR, rfalBitRate rxBR );
+static void rfalTxStreamStage( void );
+static void rfalFIFOStreamsDisarm( void );
+static void rfalRxeTimerRestart( void );
+static bool rfalRxeTimerIsExpired( void );
+static uint32_t rfalTxStreamRefill( uint32_t irqs );
+static uint32_t rfalRxStreamDrain( uint32_t irqs );
+static void rfalRxStreamLevel( uint8_t level, uint8_t status2 );
+static uint32_t rfalFIFOIrqHook( uint32_t irqs );
+static ReturnCode rfalSetBitRateBatched( rfalBitRate txBR, rfalBitRate rxBR );
+
+/* Public entry points run under the worker lock, another task may call in while the worker runs */
+static ReturnCode rfalInitializeLocked( void );
+static ReturnCode rfalFieldOnAndStartGTLocked( void );
+static ReturnCode rfalStartTransceiveLocked( const rfalTransceiveContext *ctx );
+static ReturnCode rfalTransceiveBlockingTxLocked( uint8_t* txBuf, uint16_t txBufLen, uint8_t* rxBuf, uint16_t rxBufLen, uint16_t* actLen, uint32_t flags, uint32_t fwt );
+static ReturnCode rfalTransceiveBlockingTxRxLocked( uint8_t* txBuf, uint16_t txBufLen, uint8_t* rxBuf, uint16_t rxBufLen, uint16_t* actLen, uint32_t flags, uint32_t fwt );
+static ReturnCode rfalWakeUpModeStartLocked( const rfalWakeUpConfig *config );
+static ReturnCode rfalWakeUpModeStopLocked( void );
+static ReturnCode rfalWakeUpModeCalibrateLocked( rfalWakeUpConfig *config, uint8_t samples );
+#if RFAL_FEATURE_NFCA
+static ReturnCode rfalISO14443ATransceiveShortFrameLocked( rfal14443AShortFrameCmd txCmd, uint8_t* rxBuf, uint8_t rxBufLen, uint16_t* rxRcvdLen, uint32_t fwt );
+static ReturnCode rfalISO14443ATransceiveAnticollisionFrameLocked( uint8_t *buf, uint8_t *bytesToSend, uint8_t *bitsToSend, uint16_t *rxLength, uint32_t fwt );
+#endif /* RFAL_FEATURE_NFCA */
+#if RFAL_FEATURE_NFCV
+static ReturnCode rfalISO15693TransceiveAnticollisionFrameLocked( uint8_t *txBuf, uint8_t txBufLen, uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen );
+static ReturnCode rfalISO15693TransceiveEOFLocked( uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen );
+#endif /* RFAL_FEATURE_NFCV */
+#if RFAL_FEATURE_NFCF
+static ReturnCode rfalFeliCaPollLocked( rfalFeliCaPollSlots slots, uint16_t sysCode, uint8_t reqCode, rfalFeliCaPollRes* pollResList, uint8_t pollResListSize, uint8_t *devicesDetected, uint8_t *collisionsDetected );
+#endif /* RFAL_FEATURE_NFCF */
 
 static void rfalFIFOStatusUpdate( void );
 static void rfalFIFOStatusClear( void );
@@ -377,9 +429,30 @@ static uint8_t rfalFIFOGetNumIncompleteBits( void );
 
 /*******************************************************************************/
 ReturnCode rfalInitialize( void )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalInitializeLocked( );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalInitializeLocked( void )
 {
     st25r3911InitInterrupts();
     
+    /* Tx FIFO refills and Rx FIFO drains are served straight from the IRQ context */
+    rfalFIFOStreamsDisarm();
+    ST_MEMSET( &gRFAL.rxStats, 0x00, sizeof(rfalRxStats) );
+    st25r3911IRQHookSet( ST25R3911_IRQ_MASK_FWL, rfalFIFOIrqHook );
+    
+    /* Start with no bus error latched */
+    st25r3911ComGetError();
+    
     /* Initialize chip */
     st25r3911Initialize();
     
@@ -457,7 +530,8 @@ ReturnCode rfalInitialize( void )
      * Registers set by rfalSetAnalogConfig will tell rfalCalibrate what to perform*/
     rfalCalibrate();
     
-    return ERR_NONE;
+    /* The chip may not hold the configuration above if the bus failed */
+    return st25r3911ComGetError();
 }
 
 
@@ -546,6 +620,8 @@ void rfalSetPostTxRxCallback( rfalPostTxRxCallback pFunc )
 /*******************************************************************************/
 ReturnCode rfalDeinitialize( void )
 {
+    platformProtectWorker();
+    
     /* Deinitialize chip */
     st25r3911Deinitialize();
     
@@ -553,6 +629,8 @@ ReturnCode rfalDeinitialize( void )
     rfalSetAnalogConfig( (RFAL_ANALOG_CONFIG_TECH_CHIP | RFAL_ANALOG_CONFIG_CHIP_DEINIT) );
  
     gRFAL.state = RFAL_STATE_IDLE;
+    
+    platformUnprotectWorker();
     return ERR_NONE;
 }
 
@@ -590,6 +668,22 @@ void rfalDisableObsvMode( void )
 
 /*******************************************************************************/
 ReturnCode rfalSetMode( rfalMode mode, rfalBitRate txBR, rfalBitRate rxBR )
+{
+    ReturnCode ret;
+    
+    /* Mode, bit rate and analog config registers go out as one coalesced write */
+    platformProtectWorker();
+    st25r3911BatchStart();
+    ret = rfalSetModeBatched( mode, txBR, rxBR );
+    st25r3911BatchCommit();
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalSetModeBatched( rfalMode mode, rfalBitRate txBR, rfalBitRate rxBR )
 {
 
     /* Check if RFAL is not initialized */
@@ -786,7 +880,7 @@ ReturnCode rfalSetMode( rfalMode mode, rfalBitRate txBR, rfalBitRate rxBR )
     gRFAL.mode  = mode;
     
     /* Apply the given bit rate */
-    return rfalSetBitRate(txBR, rxBR);
+    return rfalSetBitRateBatched(txBR, rxBR);
 }
 
 
@@ -802,6 +896,21 @@ ReturnCode rfalSetBitRate( rfalBitRate txBR, rfalBitRate rxBR )
 {
     ReturnCode ret;
     
+    platformProtectWorker();
+    st25r3911BatchStart();
+    ret = rfalSetBitRateBatched( txBR, rxBR );
+    st25r3911BatchCommit();
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalSetBitRateBatched( rfalBitRate txBR, rfalBitRate rxBR )
+{
+    ReturnCode ret;
+    
     /* Check if RFAL is not initialized */
     if( gRFAL.state == RFAL_STATE_IDLE )
     {
@@ -1028,6 +1137,19 @@ bool rfalIsGTExpired( void )
 
 /*******************************************************************************/
 ReturnCode rfalFieldOnAndStartGT( void )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalFieldOnAndStartGTLocked( );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalFieldOnAndStartGTLocked( void )
 {
     ReturnCode  ret;
     
@@ -1063,8 +1185,8 @@ ReturnCode rfalFieldOnAndStartGT( void )
     /* Start GT timer in case the GT value is set */
     if( (gRFAL.timings.GT != RFAL_TIMING_NONE) )
     {
-        /* Ensure that a SW timer doesn't have a lower value then the minimum  */
-        rfalTimerStart( gRFAL.tmr.GT, rfalConv1fcToMs( MAX( (gRFAL.timings.GT), RFAL_ST25R3911_GT_MIN_1FC) ) );
+        /* SW timer runs in us, no need to round GT up to the former 1ms minimum */
+        rfalTimerStart( gRFAL.tmr.GT, rfalConv1fcToUs( gRFAL.timings.GT ) );
     }
     
     return ret;
@@ -1074,6 +1196,8 @@ ReturnCode rfalFieldOnAndStartGT( void )
 /*******************************************************************************/
 ReturnCode rfalFieldOff( void )
 {
+    platformProtectWorker();
+    
     /* Check whether a TxRx is not yet finished */
     if( gRFAL.TxRx.state != RFAL_TXRX_STATE_IDLE )
     {
@@ -1087,12 +1211,26 @@ ReturnCode rfalFieldOff( void )
     rfalSetAnalogConfig( (RFAL_ANALOG_CONFIG_TECH_CHIP | RFAL_ANALOG_CONFIG_CHIP_FIELD_OFF) );
     gRFAL.field = false;
     
+    platformUnprotectWorker();
     return ERR_NONE;
 }
 
 
 /*******************************************************************************/
 ReturnCode rfalStartTransceive( const rfalTransceiveContext *ctx )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalStartTransceiveLocked( ctx );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalStartTransceiveLocked( const rfalTransceiveContext *ctx )
 {
     uint32_t FxTAdj;  /* FWT or FDT adjustment calculation */
     
@@ -1234,6 +1372,19 @@ bool rfalIsTransceiveInRx( void )
 
 /*******************************************************************************/
 ReturnCode rfalTransceiveBlockingTx( uint8_t* txBuf, uint16_t txBufLen, uint8_t* rxBuf, uint16_t rxBufLen, uint16_t* actLen, uint32_t flags, uint32_t fwt )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalTransceiveBlockingTxLocked( txBuf, txBufLen, rxBuf, rxBufLen, actLen, flags, fwt );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalTransceiveBlockingTxLocked( uint8_t* txBuf, uint16_t txBufLen, uint8_t* rxBuf, uint16_t rxBufLen, uint16_t* actLen, uint32_t flags, uint32_t fwt )
 {
     ReturnCode               ret;
     rfalTransceiveContext    ctx;
@@ -1248,11 +1399,19 @@ ReturnCode rfalTransceiveBlockingTx( uint8_t* txBuf, uint16_t txBufLen, uint8_t*
 /*******************************************************************************/
 static ReturnCode rfalTransceiveRunBlockingTx( void )
 {
-    ReturnCode  ret;
+    ReturnCode          ret;
+    rfalTransceiveState state;
         
     do{
+        state = gRFAL.TxRx.state;
         rfalWorker();
         ret = rfalGetTransceiveStatus();
+        
+        /* No progress: sleep until the chip signals or the SW timers are due */
+        if( (ret == ERR_BUSY) && (state == gRFAL.TxRx.state) )
+        {
+            platformWorkerWait();
+        }
     }
     while( rfalIsTransceiveInTx() && (ret == ERR_BUSY) );
     
@@ -1268,14 +1427,25 @@ static ReturnCode rfalTransceiveRunBlockingTx( void )
 /*******************************************************************************/
 ReturnCode rfalTransceiveBlockingRx( void )
 {
-    ReturnCode ret;
+    ReturnCode          ret;
+    rfalTransceiveState state;
+    
+    platformProtectWorker();
     
     do{
+        state = gRFAL.TxRx.state;
         rfalWorker();
         ret = rfalGetTransceiveStatus();
+        
+        /* No progress: sleep until the chip signals or the SW timers are due */
+        if( (ret == ERR_BUSY) && (state == gRFAL.TxRx.state) )
+        {
+            platformWorkerWait();
+        }
     }
     while( rfalIsTransceiveInRx() && (ret == ERR_BUSY) );
-        
+    
+    platformUnprotectWorker();
     return ret;
 }
 
@@ -1285,6 +1455,19 @@ ReturnCode rfalTransceiveBlockingTxRx( uint8_t* txBuf, uint16_t txBufLen, uint8_
 {
     ReturnCode ret;
     
+    platformProtectWorker();
+    ret = rfalTransceiveBlockingTxRxLocked( txBuf, txBufLen, rxBuf, rxBufLen, actLen, flags, fwt );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalTransceiveBlockingTxRxLocked( uint8_t* txBuf, uint16_t txBufLen, uint8_t* rxBuf, uint16_t rxBufLen, uint16_t* actLen, uint32_t flags, uint32_t fwt )
+{
+    ReturnCode ret;
+    
     EXIT_ON_ERR( ret, rfalTransceiveBlockingTx( txBuf, txBufLen, rxBuf, rxBufLen, actLen, flags, fwt ) );
     ret = rfalTransceiveBlockingRx();
     
@@ -1303,6 +1486,25 @@ static ReturnCode rfalRunTransceiveWorker( void )
 {
     if( gRFAL.state == RFAL_STATE_TXRX )
     {     
+        /* A failed bus transfer, here or in the IRQ context, ends the transceive */
+        if( st25r3911ComGetError() != ERR_NONE )
+        {
+            if( rfalIsTransceiveInTx() )
+            {
+                gRFAL.TxRx.status = ERR_IO;
+                gRFAL.TxRx.state  = RFAL_TXRX_STATE_TX_FAIL;
+            }
+            else if( rfalIsTransceiveInRx() )
+            {
+                gRFAL.TxRx.status = ERR_IO;
+                gRFAL.TxRx.state  = RFAL_TXRX_STATE_RX_FAIL;
+            }
+            else
+            {
+                /* MISRA 15.7 - Empty else */
+            }
+        }
+        
         /* Run Tx or Rx state machines */
         if( rfalIsTransceiveInTx() )
         {
@@ -1360,6 +1562,8 @@ ReturnCode rfalGetTransceiveRSSI( uint16_t *rssi )
 /*******************************************************************************/
 void rfalWorker( void )
 {
+    platformProtectWorker();
+    
     switch( gRFAL.state )
     {
         case RFAL_STATE_TXRX:
@@ -1379,6 +1583,8 @@ void rfalWorker( void )
             /* MISRA 16.4: no empty default statement (a comment being enough) */
             break;
     }
+    
+    platformUnprotectWorker();
 }
 
 
@@ -1465,6 +1671,9 @@ static void rfalErrorHandling( void )
 /*******************************************************************************/
 static void rfalCleanupTransceive( void )
 {
+    /* Nothing left for the IRQ context to load or drain */
+    rfalFIFOStreamsDisarm();
+    
     /*******************************************************************************/
     /* Transceive flags                                                            */
     /*******************************************************************************/
@@ -1497,6 +1706,9 @@ static void rfalPrepareTransceive( void )
     uint32_t maskInterrupts;
     uint8_t  reg;
     
+    /* No refill or drain of the previous frame may run past this point */
+    rfalFIFOStreamsDisarm();
+    
     /*******************************************************************************/
     /* In the EMVCo mode the NRT will continue to run.                             *
      * For the clear to stop it, the EMV mode has to be disabled before            */
@@ -1615,7 +1827,6 @@ static void rfalPrepareTransceive( void )
 static void rfalTransceiveTx( void )
 {
     volatile uint32_t irqs;
-    uint16_t          tmp;
     ReturnCode        ret;
     
     /* Supress warning in case NFC-V feature is disabled */
@@ -1728,6 +1939,18 @@ static void rfalTransceiveTx( void )
             /*Check if Observation Mode is enabled and set it on ST25R391x */
             rfalCheckEnableObsModeTx(); 
             
+            /* Stage the next chunk now, the IRQ context loads it the moment WL comes */
+            platformProtectST25R391xComm();
+            rfalTxStreamStage();
+            platformUnprotectST25R391xComm();
+            
+            if( gRFAL.txStream.err != ERR_NONE )
+            {
+                gRFAL.TxRx.status = gRFAL.txStream.err;
+                gRFAL.TxRx.state  = RFAL_TXRX_STATE_TX_FAIL;
+                break;
+            }
+            
             /*******************************************************************************/
             /* Trigger/Start transmission                                                  */
             if( (gRFAL.TxRx.ctx.flags & (uint32_t)RFAL_TXRX_FLAGS_CRC_TX_MANUAL) != 0U )
@@ -1739,83 +1962,22 @@ static void rfalTransceiveTx( void )
                 st25r3911ExecuteCommand( ST25R3911_CMD_TRANSMIT_WITH_CRC );
             }
              
-            /* Check if a WL level is expected or TXE should come */
-            gRFAL.TxRx.state = (( gRFAL.fifo.bytesWritten < gRFAL.fifo.bytesTotal ) ? RFAL_TXRX_STATE_TX_WAIT_WL : RFAL_TXRX_STATE_TX_WAIT_TXE);
+            /* Refills, if any, are done from the IRQ context: only TXE is to be waited for */
+            gRFAL.TxRx.state = RFAL_TXRX_STATE_TX_WAIT_TXE;
             break;
 
         /*******************************************************************************/
-        case RFAL_TXRX_STATE_TX_WAIT_WL:
-            
-            irqs = st25r3911GetInterrupt( (ST25R3911_IRQ_MASK_FWL | ST25R3911_IRQ_MASK_TXE) );            
-            if( irqs == ST25R3911_IRQ_MASK_NONE )
-            {
-               break;  /* No interrupt to process */
-            }
-            
-            if( ((irqs & ST25R3911_IRQ_MASK_FWL) != 0U) && ((irqs & ST25R3911_IRQ_MASK_TXE) == 0U) )
-            {
-                gRFAL.TxRx.state  = RFAL_TXRX_STATE_TX_RELOAD_FIFO;
-            }
-            else
+        case RFAL_TXRX_STATE_TX_WAIT_TXE:
+           
+            /* The coder failed on a chunk staged from the IRQ context */
+            if( gRFAL.txStream.err != ERR_NONE )
             {
-                gRFAL.TxRx.status = ERR_IO;
+                rfalFIFOStreamsDisarm();
+                gRFAL.TxRx.status = gRFAL.txStream.err;
                 gRFAL.TxRx.state  = RFAL_TXRX_STATE_TX_FAIL;
                 break;
             }
             
-            /* fall through */
-            
-        /*******************************************************************************/
-        case RFAL_TXRX_STATE_TX_RELOAD_FIFO:   /*  PRQA S 2003 # MISRA 16.3 - Intentional fall through */
-            
-        #if RFAL_FEATURE_NFCV
-            /*******************************************************************************/
-            /* In NFC-V streaming mode, the FIFO needs to be loaded with the coded bits    */
-            if( (RFAL_MODE_POLL_NFCV == gRFAL.mode) || (RFAL_MODE_POLL_PICOPASS == gRFAL.mode) )
-            {
-                uint16_t maxLen;
-                                
-                /* Load FIFO with the remaining length or maximum available (which fit on the coding buffer) */
-                maxLen = (uint16_t)MIN( (gRFAL.fifo.bytesTotal - gRFAL.fifo.bytesWritten), gRFAL.fifo.expWL);
-                maxLen = (uint16_t)MIN( maxLen, sizeof(gRFAL.nfcvData.codingBuffer) );
-                tmp    = 0;
-
-                /* Calculate the bytes needed to be Written into FIFO (a incomplete byte will be added as 1byte) */
-                ret = iso15693VCDCode(gRFAL.TxRx.ctx.txBuf, rfalConvBitsToBytes(gRFAL.TxRx.ctx.txBufLen), (((gRFAL.nfcvData.origCtx.flags & (uint32_t)RFAL_TXRX_FLAGS_CRC_TX_MANUAL) != 0U)?false:true), (((gRFAL.nfcvData.origCtx.flags & (uint32_t)RFAL_TXRX_FLAGS_NFCV_FLAG_MANUAL) != 0U)?false:true), (RFAL_MODE_POLL_PICOPASS == gRFAL.mode),
-                          &gRFAL.fifo.bytesTotal, &gRFAL.nfcvData.nfcvOffset, gRFAL.nfcvData.codingBuffer, maxLen, &tmp);
-
-                if( (ret != ERR_NONE) && (ret != ERR_AGAIN) )
-                {
-                    gRFAL.TxRx.status = ret;
-                    gRFAL.TxRx.state  = RFAL_TXRX_STATE_TX_FAIL;
-                    break;
-                }
-
-                /* Load FIFO with coded bytes */
-                /* TODO: check tmp does not exceed 255 */
-                st25r3911WriteFifo( gRFAL.nfcvData.codingBuffer, (uint8_t)tmp );
-            }
-            /*******************************************************************************/
-            else
-        #endif /* RFAL_FEATURE_NFCV */
-            {
-                /* Load FIFO with the remaining length or maximum available */
-                tmp = MIN( (gRFAL.fifo.bytesTotal - gRFAL.fifo.bytesWritten), gRFAL.fifo.expWL);       /* tmp holds the number of bytes written on this iteration */
-                /* TODO: check tmp does not exceed 255 */
-                st25r3911WriteFifo( &gRFAL.TxRx.ctx.txBuf[gRFAL.fifo.bytesWritten], (uint8_t)tmp );
-            }
-            
-            /* Update total written bytes to FIFO */
-            gRFAL.fifo.bytesWritten += tmp;
-            
-            /* Check if a WL level is expected or TXE should come */
-            gRFAL.TxRx.state = (( gRFAL.fifo.bytesWritten < gRFAL.fifo.bytesTotal ) ? RFAL_TXRX_STATE_TX_WAIT_WL : RFAL_TXRX_STATE_TX_WAIT_TXE);
-            break;
-            
-            
-        /*******************************************************************************/
-        case RFAL_TXRX_STATE_TX_WAIT_TXE:
-           
             irqs = st25r3911GetInterrupt( (ST25R3911_IRQ_MASK_FWL | ST25R3911_IRQ_MASK_TXE) );
             if( irqs == ST25R3911_IRQ_MASK_NONE )
             {
@@ -1825,10 +1987,20 @@ static void rfalTransceiveTx( void )
             
             if( (irqs & ST25R3911_IRQ_MASK_TXE) != 0U )
             {
+                rfalFIFOStreamsDisarm();
+                
+                /* The FIFO ran dry before the whole frame was loaded */
+                if( gRFAL.fifo.bytesWritten < gRFAL.fifo.bytesTotal )
+                {
+                    gRFAL.TxRx.status = ERR_IO;
+                    gRFAL.TxRx.state  = RFAL_TXRX_STATE_TX_FAIL;
+                    break;
+                }
+                
                 /* In Active comm start SW timer to measure FWT */
                 if( rfalIsModeActiveComm( gRFAL.mode) && (gRFAL.TxRx.ctx.fwt != RFAL_FWT_NONE) && (gRFAL.TxRx.ctx.fwt != 0U) ) 
                 {
-                    rfalTimerStart( gRFAL.tmr.FWT, rfalConv1fcToMs( gRFAL.TxRx.ctx.fwt ) );
+                    rfalTimerStart( gRFAL.tmr.FWT, rfalConv1fcToUs( gRFAL.TxRx.ctx.fwt ) );
                 }
                 
                 gRFAL.TxRx.state = RFAL_TXRX_STATE_TX_DONE;
@@ -1929,6 +2101,14 @@ static void rfalTransceiveRx( void )
                 *gRFAL.TxRx.ctx.rxRcvdLen = 0;
             }
             
+            /* From now on the FIFO is drained by the IRQ context upon WL */
+            platformProtectST25R391xComm();
+            gRFAL.rxStream.peakLevel = 0;
+            gRFAL.rxStream.drains    = 0;
+            gRFAL.rxStream.overflow  = false;
+            gRFAL.rxStream.armed     = true;
+            platformUnprotectST25R391xComm();
+            
             gRFAL.TxRx.state = ( rfalIsModeActiveComm( gRFAL.mode ) ? RFAL_TXRX_STATE_RX_WAIT_EON : RFAL_TXRX_STATE_RX_WAIT_RXS );
             break;
            
@@ -1994,7 +2174,7 @@ static void rfalTransceiveRx( void )
                     /* REMARK: Silicon workaround ST25R3911 Errata #1.1                            */
                     /* Rarely on corrupted frames I_rxs gets signaled but I_rxe is not signaled    */
                     /* Use a SW timer to handle an eventual missing RXE                            */
-                    rfalTimerStart( gRFAL.tmr.RXE, RFAL_NORXE_TOUT );
+                    rfalRxeTimerRestart();
                     /*******************************************************************************/
                     
                     gRFAL.TxRx.state  = RFAL_TXRX_STATE_RX_WAIT_RXE;
@@ -2035,7 +2215,7 @@ static void rfalTransceiveRx( void )
                 /* ST25R3911 may indicate RXS without RXE afterwards, this happens rarely on   */
                 /* corrupted frames.                                                           */
                 /* SW timer is used to timeout upon a missing RXE                              */
-                if( rfalTimerisExpired( gRFAL.tmr.RXE ) )
+                if( rfalRxeTimerIsExpired() )
                 {
                     gRFAL.TxRx.status = ERR_FRAMING;
                     gRFAL.TxRx.state  = RFAL_TXRX_STATE_RX_FAIL;
@@ -2058,6 +2238,9 @@ static void rfalTransceiveRx( void )
         /*******************************************************************************/
         case RFAL_TXRX_STATE_RX_ERR_CHECK:   /*  PRQA S 2003 # MISRA 16.3 - Intentional fall through */
         
+            /* Reception is over, whatever is left in the FIFO is read below */
+            rfalFIFOStreamsDisarm();
+        
             /* Retrieve and check for any error irqs */
             irqs |= st25r3911GetInterrupt( (ST25R3911_IRQ_MASK_CRC | ST25R3911_IRQ_MASK_PAR | ST25R3911_IRQ_MASK_ERR1 | ST25R3911_IRQ_MASK_ERR2 | ST25R3911_IRQ_MASK_COL) );
         
@@ -2149,6 +2332,29 @@ static void rfalTransceiveRx( void )
         case RFAL_TXRX_STATE_RX_READ_DATA:   /*  PRQA S 2003 # MISRA 16.3 - Intentional fall through */
                         
             tmp = rfalFIFOStatusGetNumBytes();
+            
+            /*******************************************************************************/
+            /* Account the frame and fail it if bytes were lost on a FIFO overflow         */
+            rfalRxStreamLevel( tmp, gRFAL.fifo.status[RFAL_FIFO_STATUS_REG2] );
+            gRFAL.rxStats.frames++;
+            gRFAL.rxStats.lastPeakLevel = gRFAL.rxStream.peakLevel;
+            gRFAL.rxStats.lastDrains    = gRFAL.rxStream.drains;
+            if( gRFAL.rxStream.overflow )
+            {
+                gRFAL.rxStats.overflows++;
+                if( gRFAL.TxRx.status == ERR_BUSY )
+                {
+                    gRFAL.TxRx.status = ERR_FIFO;
+                }
+            }
+            else if( gRFAL.rxStream.peakLevel >= RFAL_FIFO_RX_NEAR_MISS )
+            {
+                gRFAL.rxStats.nearMisses++;
+            }
+            else
+            {
+                /* MISRA 15.7 - Empty else */
+            }
                         
             /*******************************************************************************/
             /* Check if CRC should not be placed in rxBuf                                  */
@@ -2187,6 +2393,8 @@ static void rfalTransceiveRx( void )
                 gRFAL.TxRx.state  = RFAL_TXRX_STATE_RX_FAIL;
             }
 
+            gRFAL.rxStats.lastFrameLen = gRFAL.fifo.bytesTotal;
+
             /*******************************************************************************/
             /* Retrieve remaining bytes from FIFO to rxBuf, and assign total length rcvd   */
             st25r3911ReadFifo( &gRFAL.TxRx.ctx.rxBuf[gRFAL.fifo.bytesWritten], tmp);
@@ -2261,16 +2469,20 @@ static void rfalTransceiveRx( void )
         /*******************************************************************************/
         case RFAL_TXRX_STATE_RX_READ_FIFO:
         
+            /* The drain in the IRQ context works on the same FIFO counters and timer */
+            platformProtectST25R391xComm();
+        
             /*******************************************************************************/
             /* REMARK: Silicon workaround ST25R3911B Errata #1.1                           */
             /* ST25R3911 may indicate RXS without RXE afterwards, this happens rarely on   */
             /* corrupted frames.                                                           */
             /* Re-Start SW timer to handle an eventual missing RXE                         */
-            rfalTimerStart( gRFAL.tmr.RXE, RFAL_NORXE_TOUT );
+            rfalTimerStart( gRFAL.tmr.RXE, (RFAL_NORXE_TOUT * RFAL_US_IN_MS) );
             /*******************************************************************************/        
                     
         
             tmp = rfalFIFOStatusGetNumBytes();
+            rfalRxStreamLevel( tmp, gRFAL.fifo.status[RFAL_FIFO_STATUS_REG2] );
             gRFAL.fifo.bytesTotal += tmp;
             
             /*******************************************************************************/
@@ -2290,6 +2502,8 @@ static void rfalTransceiveRx( void )
                 st25r3911ReadFifo( NULL, (tmp - aux) );
             }
             
+            platformUnprotectST25R391xComm();
+            
             rfalFIFOStatusClear();
             gRFAL.TxRx.state  = RFAL_TXRX_STATE_RX_WAIT_RXE;
             break;
@@ -2372,6 +2586,219 @@ static void rfalTransceiveRx( void )
     }    
 }
 
+/*******************************************************************************/
+static void rfalTxStreamStage( void )
+{
+    uint16_t len;
+    
+    gRFAL.txStream.armed = false;
+    gRFAL.txStream.err   = ERR_NONE;
+    
+    /* Next refill: what is left or what the FIFO has room for when WL triggers */
+    len = (uint16_t)MIN( (gRFAL.fifo.bytesTotal - gRFAL.fifo.bytesWritten), gRFAL.fifo.expWL );
+    if( len == 0U )
+    {
+        return;
+    }
+    
+#if RFAL_FEATURE_NFCV
+    /* In NFC-V streaming mode the chunk is coded ahead into the coding buffer */
+    if( (RFAL_MODE_POLL_NFCV == gRFAL.mode) || (RFAL_MODE_POLL_PICOPASS == gRFAL.mode) )
+    {
+        ReturnCode ret;
+        uint16_t   coded;
+        
+        len = (uint16_t)MIN( len, sizeof(gRFAL.nfcvData.codingBuffer) );
+        ret = iso15693VCDCode(gRFAL.TxRx.ctx.txBuf, rfalConvBitsToBytes(gRFAL.TxRx.ctx.txBufLen), (((gRFAL.nfcvData.origCtx.flags & (uint32_t)RFAL_TXRX_FLAGS_CRC_TX_MANUAL) != 0U)?false:true), (((gRFAL.nfcvData.origCtx.flags & (uint32_t)RFAL_TXRX_FLAGS_NFCV_FLAG_MANUAL) != 0U)?false:true), (RFAL_MODE_POLL_PICOPASS == gRFAL.mode),
+                              &gRFAL.fifo.bytesTotal, &gRFAL.nfcvData.nfcvOffset, gRFAL.nfcvData.codingBuffer, len, &coded);
+        if( (ret != ERR_NONE) && (ret != ERR_AGAIN) )
+        {
+            gRFAL.txStream.err = ret;   /* Not staged: the worker ends the transceive with it */
+            return;
+        }
+        
+        gRFAL.txStream.buf = gRFAL.nfcvData.codingBuffer;
+        gRFAL.txStream.len = coded;
+    }
+    else
+#endif /* RFAL_FEATURE_NFCV */
+    {
+        /* Straight from the user buffer, no copy */
+        gRFAL.txStream.buf = &gRFAL.TxRx.ctx.txBuf[gRFAL.fifo.bytesWritten];
+        gRFAL.txStream.len = len;
+    }
+    
+    gRFAL.txStream.armed = true;
+}
+
+
+/*******************************************************************************/
+static uint32_t rfalTxStreamRefill( uint32_t irqs )
+{
+    if( !gRFAL.txStream.armed )
+    {
+        return ST25R3911_IRQ_MASK_NONE;   /* Not transmitting or all loaded: WL goes to the worker as usual */
+    }
+    
+    /* TXE already there: too late, leave it all to the worker */
+    if( (irqs & ST25R3911_IRQ_MASK_TXE) != 0U )
+    {
+        gRFAL.txStream.armed = false;
+        return ST25R3911_IRQ_MASK_NONE;
+    }
+    
+    /* Chunk is bounded by the water level, always fits in one FIFO access */
+    st25r3911WriteFifo( gRFAL.txStream.buf, (uint8_t)gRFAL.txStream.len );
+    gRFAL.fifo.bytesWritten += gRFAL.txStream.len;
+    
+    /* Get the following chunk ready while this one goes out */
+    rfalTxStreamStage();
+    
+    /* WL left to the worker on a coder error, it wakes up and ends the transceive */
+    return ((gRFAL.txStream.err != ERR_NONE) ? ST25R3911_IRQ_MASK_NONE : ST25R3911_IRQ_MASK_FWL);
+}
+
+
+/*******************************************************************************/
+static uint32_t rfalRxStreamDrain( uint32_t irqs )
+{
+    uint8_t  status[ST25R3911_FIFO_STATUS_LEN];
+    uint16_t space;
+    uint8_t  aux;
+    
+    if( !gRFAL.rxStream.armed )
+    {
+        return ST25R3911_IRQ_MASK_NONE;
+    }
+    
+    /* RXE already there: the worker reads the FIFO once and checks the frame */
+    if( (irqs & ST25R3911_IRQ_MASK_RXE) != 0U )
+    {
+        return ST25R3911_IRQ_MASK_NONE;
+    }
+    
+    /* Status and FIFO read back to back, nobody gets in between */
+    platformProtectST25R391xComm();
+    
+    st25r3911ReadMultipleRegisters( ST25R3911_REG_FIFO_RX_STATUS1, status, ST25R3911_FIFO_STATUS_LEN );
+    rfalRxStreamLevel( status[RFAL_FIFO_STATUS_REG1], status[RFAL_FIFO_STATUS_REG2] );
+    gRFAL.rxStream.drains++;
+    
+    /*******************************************************************************/
+    /* Straight into rxBuf, what does not fit is dumped for the Rx to continue     */
+    gRFAL.fifo.bytesTotal += status[RFAL_FIFO_STATUS_REG1];
+    space = (uint16_t)( rfalConvBitsToBytes(gRFAL.TxRx.ctx.rxBufLen) - gRFAL.fifo.bytesWritten );
+    aux   = (uint8_t)MIN( (uint16_t)status[RFAL_FIFO_STATUS_REG1], space );
+    
+    st25r3911ReadFifo( &gRFAL.TxRx.ctx.rxBuf[gRFAL.fifo.bytesWritten], aux );
+    gRFAL.fifo.bytesWritten += aux;
+    
+    if( aux < status[RFAL_FIFO_STATUS_REG1] )
+    {
+        st25r3911ReadFifo( NULL, (status[RFAL_FIFO_STATUS_REG1] - aux) );
+    }
+    
+    /* Data is flowing, push the missing RXE timeout further (Errata #1.1).
+     * The 64 bit deadline is only written and read under the comm lock    */
+    rfalTimerStart( gRFAL.tmr.RXE, (RFAL_NORXE_TOUT * RFAL_US_IN_MS) );
+    
+    platformUnprotectST25R391xComm();
+    
+    return ST25R3911_IRQ_MASK_FWL;
+}
+
+
+/*******************************************************************************/
+static void rfalRxStreamLevel( uint8_t level, uint8_t status2 )
+{
+    gRFAL.rxStream.peakLevel = MAX( gRFAL.rxStream.peakLevel, level );
+    
+    if( (status2 & ST25R3911_REG_FIFO_RX_STATUS2_fifo_ovr) != 0U )
+    {
+        gRFAL.rxStream.overflow = true;
+    }
+}
+
+
+/*******************************************************************************/
+static uint32_t rfalFIFOIrqHook( uint32_t irqs )
+{
+    uint32_t ret;
+    
+    /* Armed check, FIFO access and restage as one step: the worker disarms 
+     * under the same lock, so once it did no refill or drain is in flight  */
+    platformProtectST25R391xComm();
+    
+    if( gRFAL.txStream.armed )
+    {
+        ret = rfalTxStreamRefill( irqs );
+    }
+    else
+    {
+        ret = rfalRxStreamDrain( irqs );
+    }
+    
+    platformUnprotectST25R391xComm();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static void rfalRxeTimerRestart( void )
+{
+    /* The Rx drain in the IRQ context restarts it too: a 64 bit store is not atomic */
+    platformProtectST25R391xComm();
+    rfalTimerStart( gRFAL.tmr.RXE, (RFAL_NORXE_TOUT * RFAL_US_IN_MS) );
+    platformUnprotectST25R391xComm();
+}
+
+
+/*******************************************************************************/
+static bool rfalRxeTimerIsExpired( void )
+{
+    bool expired;
+    
+    platformProtectST25R391xComm();
+    expired = rfalTimerisExpired( gRFAL.tmr.RXE );
+    platformUnprotectST25R391xComm();
+    
+    return expired;
+}
+
+
+/*******************************************************************************/
+static void rfalFIFOStreamsDisarm( void )
+{
+    /* Waits for a refill or drain running in the IRQ context to complete */
+    platformProtectST25R391xComm();
+    gRFAL.txStream.armed = false;
+    gRFAL.rxStream.armed = false;
+    platformUnprotectST25R391xComm();
+}
+
+
+/*******************************************************************************/
+void rfalGetRxStats( rfalRxStats *stats )
+{
+    if( stats != NULL )
+    {
+        platformProtectWorker();
+        (*stats) = gRFAL.rxStats;
+        platformUnprotectWorker();
+    }
+}
+
+
+/*******************************************************************************/
+void rfalClearRxStats( void )
+{
+    platformProtectWorker();
+    ST_MEMSET( &gRFAL.rxStats, 0x00, sizeof(rfalRxStats) );
+    platformUnprotectWorker();
+}
+
+
 /*******************************************************************************/
 static void rfalFIFOStatusUpdate( void )
 {
@@ -2427,6 +2854,19 @@ static uint8_t rfalFIFOGetNumIncompleteBits( void )
 
 /*******************************************************************************/
 ReturnCode rfalISO14443ATransceiveShortFrame( rfal14443AShortFrameCmd txCmd, uint8_t* rxBuf, uint8_t rxBufLen, uint16_t* rxRcvdLen, uint32_t fwt )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalISO14443ATransceiveShortFrameLocked( txCmd, rxBuf, rxBufLen, rxRcvdLen, fwt );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalISO14443ATransceiveShortFrameLocked( rfal14443AShortFrameCmd txCmd, uint8_t* rxBuf, uint8_t rxBufLen, uint16_t* rxRcvdLen, uint32_t fwt )
 {
     ReturnCode ret;
     uint8_t    directCmd;
@@ -2518,7 +2958,7 @@ ReturnCode rfalISO14443ATransceiveShortFrame( rfal14443AShortFrameCmd txCmd, uin
     st25r3911ExecuteCommand( directCmd );
     
     /* Wait for TXE */
-    if( st25r3911WaitForInterruptsTimed( ST25R3911_IRQ_MASK_TXE, (uint16_t)MAX( rfalConv1fcToMs( fwt ), RFAL_ST25R3911_SW_TMR_MIN_1MS ) ) == 0U)
+    if( st25r3911WaitForInterruptsTimed_us( ST25R3911_IRQ_MASK_TXE, MAX( rfalConv1fcToUs( fwt ), RFAL_ST25R3911_SW_TMR_MIN_1US ) ) == 0U)
     {
         ret = ERR_IO;
     }
@@ -2551,6 +2991,19 @@ ReturnCode rfalISO14443ATransceiveShortFrame( rfal14443AShortFrameCmd txCmd, uin
 
 /*******************************************************************************/
 ReturnCode rfalISO14443ATransceiveAnticollisionFrame( uint8_t *buf, uint8_t *bytesToSend, uint8_t *bitsToSend, uint16_t *rxLength, uint32_t fwt )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalISO14443ATransceiveAnticollisionFrameLocked( buf, bytesToSend, bitsToSend, rxLength, fwt );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalISO14443ATransceiveAnticollisionFrameLocked( uint8_t *buf, uint8_t *bytesToSend, uint8_t *bitsToSend, uint16_t *rxLength, uint32_t fwt )
 {
     ReturnCode            ret;
     rfalTransceiveContext ctx;
@@ -2663,6 +3116,19 @@ ReturnCode rfalISO14443ATransceiveAnticollisionFrame( uint8_t *buf, uint8_t *byt
 
 /*******************************************************************************/
 ReturnCode rfalISO15693TransceiveAnticollisionFrame( uint8_t *txBuf, uint8_t txBufLen, uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalISO15693TransceiveAnticollisionFrameLocked( txBuf, txBufLen, rxBuf, rxBufLen, actLen );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalISO15693TransceiveAnticollisionFrameLocked( uint8_t *txBuf, uint8_t txBufLen, uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen )
 {
     ReturnCode            ret;
     rfalTransceiveContext ctx;
@@ -2719,6 +3185,19 @@ ReturnCode rfalISO15693TransceiveEOFAnticollision( uint8_t *rxBuf, uint8_t rxBuf
 
 /*******************************************************************************/
 ReturnCode rfalISO15693TransceiveEOF( uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalISO15693TransceiveEOFLocked( rxBuf, rxBufLen, actLen );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalISO15693TransceiveEOFLocked( uint8_t *rxBuf, uint8_t rxBufLen, uint16_t *actLen )
 {
     ReturnCode ret;
     uint8_t    dummy;
@@ -2747,6 +3226,19 @@ ReturnCode rfalISO15693TransceiveEOF( uint8_t *rxBuf, uint8_t rxBufLen, uint16_t
 
 /*******************************************************************************/
 ReturnCode rfalFeliCaPoll( rfalFeliCaPollSlots slots, uint16_t sysCode, uint8_t reqCode, rfalFeliCaPollRes* pollResList, uint8_t pollResListSize, uint8_t *devicesDetected, uint8_t *collisionsDetected )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalFeliCaPollLocked( slots, sysCode, reqCode, pollResList, pollResListSize, devicesDetected, collisionsDetected );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalFeliCaPollLocked( rfalFeliCaPollSlots slots, uint16_t sysCode, uint8_t reqCode, rfalFeliCaPollRes* pollResList, uint8_t pollResListSize, uint8_t *devicesDetected, uint8_t *collisionsDetected )
 {
     ReturnCode        ret;
     uint8_t           frame[RFAL_FELICA_POLL_REQ_LEN - RFAL_FELICA_LEN_LEN];  // LEN is added by ST25R3911 automatically
@@ -3292,6 +3784,19 @@ ReturnCode rfalListenSetState( rfalLmState newSt )
 
 /*******************************************************************************/
 ReturnCode rfalWakeUpModeStart( const rfalWakeUpConfig *config )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalWakeUpModeStartLocked( config );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalWakeUpModeStartLocked( const rfalWakeUpConfig *config )
 {
     uint8_t                aux;
     uint8_t                reg;
@@ -3428,14 +3933,14 @@ ReturnCode rfalWakeUpModeStart( const rfalWakeUpConfig *config )
         /* Only need to set the reference if not using Auto Average */
         if( !gRFAL.wum.cfg.cap.autoAvg )
         {
-            if( gRFAL.wum.cfg.indPha.reference == RFAL_WUM_REFERENCE_AUTO )
+            if( gRFAL.wum.cfg.cap.reference == RFAL_WUM_REFERENCE_AUTO )
             {
                 st25r3911MeasureCapacitance( &aux );
                 st25r3911WriteRegister( ST25R3911_REG_CAPACITANCE_MEASURE_REF, aux );
             }
             else
             {
-                st25r3911WriteRegister( ST25R3911_REG_CAPACITANCE_MEASURE_REF, gRFAL.wum.cfg.indPha.reference );
+                st25r3911WriteRegister( ST25R3911_REG_CAPACITANCE_MEASURE_REF, gRFAL.wum.cfg.cap.reference );
             }
         }
         
@@ -3464,6 +3969,98 @@ ReturnCode rfalWakeUpModeStart( const rfalWakeUpConfig *config )
 }
 
 
+/*******************************************************************************/
+ReturnCode rfalWakeUpModeCalibrate( rfalWakeUpConfig *config, uint8_t samples )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalWakeUpModeCalibrateLocked( config, samples );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalWakeUpModeCalibrateLocked( rfalWakeUpConfig *config, uint8_t samples )
+{
+    uint8_t  i;
+    uint8_t  meas;
+    uint16_t ampSum;
+    uint16_t phaSum;
+    uint16_t capSum;
+    
+    if( (config == NULL) || (samples == 0U) )
+    {
+        return ERR_PARAM;
+    }
+    
+    /* Measurements are not possible while the Wake-Up timer owns the chip */
+    if( (gRFAL.state < RFAL_STATE_INIT) || (gRFAL.wum.state != RFAL_WUM_STATE_NOT_INIT) )
+    {
+        return ERR_WRONG_STATE;
+    }
+    
+    ampSum = 0;
+    phaSum = 0;
+    capSum = 0;
+    
+    /* Every measurement is done with the field off, as the Wake-Up timer does */
+    rfalFieldOff();
+    
+    /* Measure under the same analog configuration as the Wake-Up timer */
+    rfalSetAnalogConfig( (RFAL_ANALOG_CONFIG_TECH_CHIP | RFAL_ANALOG_CONFIG_CHIP_WAKEUP_ON) );
+    
+    /*******************************************************************************/
+    /* Inductive measurements need the oscillator on */
+    if( config->indAmp.enabled || config->indPha.enabled )
+    {
+        st25r3911OscOn();
+        
+        for( i = 0; i < samples; i++ )
+        {
+            if( config->indAmp.enabled )
+            {
+                st25r3911MeasureAmplitude( &meas );
+                ampSum += meas;
+            }
+            
+            if( config->indPha.enabled )
+            {
+                st25r3911MeasurePhase( &meas );
+                phaSum += meas;
+            }
+        }
+    }
+    
+    /*******************************************************************************/
+    /* Capacitive measurement needs the sensor calibrated with the oscillator off  */
+    if( config->cap.enabled )
+    {
+        st25r3911ClrRegisterBits( ST25R3911_REG_OP_CONTROL, (ST25R3911_REG_OP_CONTROL_en | ST25R3911_REG_OP_CONTROL_tx_en) );
+        st25r3911CalibrateCapacitiveSensor( NULL );
+        
+        for( i = 0; i < samples; i++ )
+        {
+            st25r3911MeasureCapacitance( &meas );
+            capSum += meas;
+        }
+        
+        st25r3911OscOn();
+    }
+    
+    rfalSetAnalogConfig( (RFAL_ANALOG_CONFIG_TECH_CHIP | RFAL_ANALOG_CONFIG_CHIP_WAKEUP_OFF) );
+    
+    /* Rounded averages, RFAL_WUM_REFERENCE_AUTO is not a reference */
+    config->indAmp.reference = (uint8_t)MIN( ((ampSum + (samples / 2U)) / samples), (RFAL_WUM_REFERENCE_AUTO - 1U) );
+    config->indPha.reference = (uint8_t)MIN( ((phaSum + (samples / 2U)) / samples), (RFAL_WUM_REFERENCE_AUTO - 1U) );
+    config->cap.reference    = (uint8_t)MIN( ((capSum + (samples / 2U)) / samples), (RFAL_WUM_REFERENCE_AUTO - 1U) );
+    
+    return ERR_NONE;
+}
+
+
 /*******************************************************************************/
 bool rfalWakeUpModeHasWoke( void )
 {   
@@ -3519,6 +4116,19 @@ static void rfalRunWakeUpModeWorker( void )
 
 /*******************************************************************************/
 ReturnCode rfalWakeUpModeStop( void )
+{
+    ReturnCode ret;
+    
+    platformProtectWorker();
+    ret = rfalWakeUpModeStopLocked( );
+    platformUnprotectWorker();
+    
+    return ret;
+}
+
+
+/*******************************************************************************/
+static ReturnCode rfalWakeUpModeStopLocked( void )
 {
     if( gRFAL.wum.state == RFAL_WUM_STATE_NOT_INIT )
     {
@@ -3574,6 +4184,20 @@ ReturnCode rfalChipReadReg( uint16_t reg, uint8_t* values, uint8_t len )
 }
 
 
+/*******************************************************************************/
+void rfalChipBatchStart( void )
+{
+    st25r3911BatchStart();
+}
+
+
+/*******************************************************************************/
+void rfalChipBatchCommit( void )
+{
+    st25r3911BatchCommit();
+}
+
+
 /*******************************************************************************/
 ReturnCode rfalChipExecCmd( uint16_t cmd )
 {
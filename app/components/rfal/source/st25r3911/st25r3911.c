@@ -501,17 +501,23 @@ ReturnCode st25r3911PerformCollisionAvoidance( uint8_t FieldONCmd, uint8_t pdThr
 
 ReturnCode st25r3911GetRegsDump(uint8_t* resRegDump, uint8_t* sizeRegDump)
 {
-    uint8_t regIt;
-    uint8_t regDump[ST25R3911_REG_IC_IDENTITY+1U];
+    uint8_t  regIt;
+    uint8_t  regDump[ST25R3911_REG_IC_IDENTITY+1U];
+    uint64_t known;
     
     if(!sizeRegDump || !resRegDump)
     {
         return ERR_PARAM;
     }
     
+    /* Configuration registers come from the shadow, only the rest is read from the chip */
+    known = st25r3911ShadowDump( regDump, (uint8_t)SIZEOF_ARRAY(regDump) );
     for( regIt = ST25R3911_REG_IO_CONF1; regIt < SIZEOF_ARRAY(regDump); regIt++ )
     {
-        st25r3911ReadRegister(regIt, &regDump[regIt] );
+        if( (known & ((uint64_t)1U << regIt)) == 0U )
+        {
+            st25r3911ReadRegister(regIt, &regDump[regIt] );
+        }
     }
     
     *sizeRegDump = MIN(*sizeRegDump, regIt);
@@ -563,6 +563,9 @@ extern ReturnCode st25r3911StreamConfigure(const struct st25r3911StreamConfig *c
 /*! 
  *****************************************************************************
  *  \brief  Retrieves all  internal registers from st25r3911
+ *
+ *  Configuration registers are taken from the register shadow, see 
+ *  st25r3911ShadowDump(), only volatile and unknown ones are read.
  */
 extern ReturnCode st25r3911GetRegsDump(uint8_t* resRegDump, uint8_t* sizeRegDump);
 
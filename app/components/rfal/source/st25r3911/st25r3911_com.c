@@ -60,6 +60,62 @@
 #define ST25R3911_CMD_LEN     (1U)                           /*!< ST25R3911 CMD length                                           */
 #define ST25R3911_BUF_LEN     (ST25R3911_CMD_LEN+ST25R3911_FIFO_DEPTH)  /*!< ST25R3911 communication buffer: CMD + FIFO length   */
 
+#define ST25R3911_SHADOW_LEN  (ST25R3911_REG_IC_IDENTITY + 1U)  /*!< Number of registers covered by the shadow                  */
+#define ST25R3911_TEST_REG_LEN (64U)                         /*!< Number of test registers covered by the shadow                 */
+#define ST25R3911_BATCH_GAP   (2U)                           /*!< Max unchanged registers rewritten to merge two bursts          */
+
+#define ST25R3911_REG_BIT(r)  ((uint64_t)1U << (r))          /*!< Register bit in the shadow bitmaps                             */
+
+/*! Registers the chip updates on its own: never cached, never deferred, always accessed on the bus.
+ *  Any register not listed here is considered configuration, only changed by the host or Set Default */
+#define ST25R3911_VOLATILE_REGS  ( ST25R3911_REG_BIT(ST25R3911_REG_IRQ_MAIN)                    \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_IRQ_TIMER_NFC)               \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_IRQ_ERROR_WUP)               \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_FIFO_RX_STATUS1)             \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_FIFO_RX_STATUS2)             \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_COLLISION_STATUS)            \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_NUM_TX_BYTES1)               \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_NUM_TX_BYTES2)               \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_NFCIP1_BIT_RATE)             \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_AD_RESULT)                   \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_ANT_CAL_RESULT)              \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_AM_MOD_DEPTH_RESULT)         \
+                                 | ST25R3911_REG_BIT(0x28U)                                     \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_REGULATOR_RESULT)            \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_RSSI_RESULT)                 \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_GAIN_RED_STATE)              \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_CAP_SENSOR_RESULT)           \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_AUX_DISPLAY)                 \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_AMPLITUDE_MEASURE_AA_RESULT) \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_AMPLITUDE_MEASURE_RESULT)    \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_PHASE_MEASURE_AA_RESULT)     \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_PHASE_MEASURE_RESULT)        \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_CAPACITANCE_MEASURE_AA_RESULT) \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_CAPACITANCE_MEASURE_RESULT)  \
+                                 | ST25R3911_REG_BIT(0x3EU)                                     \
+                                 | ST25R3911_REG_BIT(ST25R3911_REG_IC_IDENTITY) )
+
+#define st25r3911IsRegCacheable(r)  ( ((r) < ST25R3911_SHADOW_LEN) && ((ST25R3911_VOLATILE_REGS & ST25R3911_REG_BIT(r)) == 0U) )  /*!< Register may be shadowed */
+
+/*
+******************************************************************************
+* LOCAL DATA TYPES
+******************************************************************************
+*/
+
+/*! Shadow of the configuration registers plus the writes pending in an open batch */
+typedef struct
+{
+    uint8_t   value[ST25R3911_SHADOW_LEN];    /*!< Last value known to be in the chip                */
+    uint8_t   pending[ST25R3911_SHADOW_LEN];  /*!< Value to be written on batch commit               */
+    uint64_t  valid;                          /*!< Registers whose value[] matches the chip          */
+    uint64_t  dirty;                          /*!< Registers with a pending[] write                  */
+    uint8_t   testValue[ST25R3911_TEST_REG_LEN]; /*!< Last value known to be in the test registers  */
+    uint64_t  testValid;                      /*!< Test registers whose testValue[] matches the chip */
+    uint8_t   batchDepth;                     /*!< Nesting level of st25r3911BatchStart()            */
+    void*     batchOwner;                     /*!< Task which opened the batch                       */
+}t_st25r3911Shadow;
+
 /*
 ******************************************************************************
 * LOCAL VARIABLES
@@ -70,11 +126,22 @@
 static uint8_t comBuf[ST25R3911_BUF_LEN];    /*!< ST25R3911 communication buffer            */
 #endif /* ST25R391X_COM_SINGLETXRX */
 
+static t_st25r3911Shadow st25r3911Shadow;   /*!< ST25R3911 register shadow                 */
+static ReturnCode        st25r3911ComError; /*!< First bus error since last fetched        */
+
 /*
 ******************************************************************************
 * LOCAL FUNCTION PROTOTYPES
 ******************************************************************************
 */
+static void st25r3911ShadowUpdate( uint8_t reg, const uint8_t* values, uint8_t length );
+static void st25r3911ShadowTestUpdate( uint8_t reg, uint8_t value );
+static bool st25r3911BatchIsOwner( void );
+static void st25r3911BatchMerge( uint8_t reg, const uint8_t* values, uint8_t length );
+static bool st25r3911BatchDefer( uint8_t reg, uint8_t clr_mask, uint8_t set_mask );
+static void st25r3911BatchFlush( void );
+static bool st25r3911ComResult( int32_t ret );
+static void st25r3911ShadowForget( uint8_t reg, uint8_t length );
 
 static inline void st25r3911CheckFieldSetLED(uint8_t value)
 {
@@ -104,20 +171,50 @@ void st25r3911ReadRegister(uint8_t reg, uint8_t* value)
     uint8_t  buf[2];
 #endif  /* ST25R391X_COM_SINGLETXRX */
   
+    /* The shadow is shared with the IRQ context, it is only touched under the lock */
     platformProtectST25R391xComm();
-    platformSpiSelect();
-  
-    buf[0] = (reg | ST25R3911_READ_MODE);
-    buf[1] = 0;
-  
-    platformSpiTxRx(buf, buf, 2);
-  
-    if(value != NULL)
+    
+    /* A write still pending in our batch is what the chip will hold */
+    if( (reg < ST25R3911_SHADOW_LEN) && ((st25r3911Shadow.dirty & ST25R3911_REG_BIT(reg)) != 0U) && st25r3911BatchIsOwner() )
     {
-      *value = buf[1];
+        if(value != NULL)
+        {
+            *value = st25r3911Shadow.pending[reg];
+        }
+    }
+    /* Configuration registers only change through us, no need to ask the chip */
+    else if( st25r3911IsRegCacheable(reg) && ((st25r3911Shadow.valid & ST25R3911_REG_BIT(reg)) != 0U) )
+    {
+        if(value != NULL)
+        {
+            *value = st25r3911Shadow.value[reg];
+        }
+    }
+    else
+    {
+        platformSpiSelect();
+      
+        buf[0] = (reg | ST25R3911_READ_MODE);
+        buf[1] = 0;
+      
+        /* Nothing read on a bus error, the shadow keeps what it knew */
+        if( !st25r3911ComResult( platformSpiTxRx(buf, buf, 2) ) )
+        {
+            buf[1] = 0x00U;
+        }
+        else
+        {
+            st25r3911ShadowUpdate( reg, &buf[1], 1 );
+        }
+      
+        if(value != NULL)
+        {
+          *value = buf[1];
+        }
+        
+        platformSpiDeselect();
     }
     
-    platformSpiDeselect();
     platformUnprotectST25R391xComm();
 
     return;
@@ -126,6 +223,7 @@ void st25r3911ReadRegister(uint8_t reg, uint8_t* value)
 
 void st25r3911ReadMultipleRegisters(uint8_t reg, uint8_t* values, uint8_t length)
 {
+    bool    ok;
 #if !defined(ST25R391X_COM_SINGLETXRX)
     uint8_t cmd = (reg | ST25R3911_READ_MODE);
 #endif  /* !ST25R391X_COM_SINGLETXRX */
@@ -133,24 +231,45 @@ void st25r3911ReadMultipleRegisters(uint8_t reg, uint8_t* values, uint8_t length
     if (length > 0U)
     {
         platformProtectST25R391xComm();
+        
+        /* Pending writes in the range must reach the chip first, if they are ours */
+        if( (reg < ST25R3911_SHADOW_LEN) && ((st25r3911Shadow.dirty >> reg) != 0U) )
+        {
+            st25r3911BatchFlush();
+        }
+        
         platformSpiSelect();
   
-#ifdef ST25R391X_COM_SINGLETXRX
+#if defined(ST25R391X_COM_CMDPHASE)
+        
+        ok = st25r3911ComResult( platformSpiCmdTxRx(cmd, NULL, values, length) );                           /* Command and data as a single SPI call, straight into the output buffer */
+        
+#elif defined(ST25R391X_COM_SINGLETXRX)
   
         ST_MEMSET( comBuf, 0x00, MIN( (ST25R3911_CMD_LEN + (uint32_t)length), ST25R3911_BUF_LEN ) );
         comBuf[0] = (reg | ST25R3911_READ_MODE);
         
-        platformSpiTxRx(comBuf, comBuf, MIN( (ST25R3911_CMD_LEN + length), ST25R3911_BUF_LEN ) );               /* Transceive as a single SPI call                        */
+        ok = st25r3911ComResult( platformSpiTxRx(comBuf, comBuf, MIN( (ST25R3911_CMD_LEN + length), ST25R3911_BUF_LEN ) ) );  /* Transceive as a single SPI call */
         ST_MEMCPY( values, &comBuf[ST25R3911_CMD_LEN], MIN( length, ST25R3911_BUF_LEN - ST25R3911_CMD_LEN ) );  /* Copy from local buf to output buffer and skip cmd byte */
   
 #else  /* ST25R391X_COM_SINGLETXRX */
   
         /* Since the result comes one byte later, let's first transmit the adddress with discarding the result */
-        platformSpiTxRx(&cmd, NULL, ST25R3911_CMD_LEN);
-        platformSpiTxRx(NULL, values, length);  
+        ok = st25r3911ComResult( platformSpiTxRx(&cmd, NULL, ST25R3911_CMD_LEN) );
+        ok = (st25r3911ComResult( platformSpiTxRx(NULL, values, length) ) && ok);
   
 #endif  /* ST25R391X_COM_SINGLETXRX */
 
+        /* Nothing read on a bus error, the shadow keeps what it knew */
+        if( ok )
+        {
+            st25r3911ShadowUpdate( reg, values, length );
+        }
+        else
+        {
+            ST_MEMSET( values, 0x00, length );
+        }
+        
         platformSpiDeselect();
         platformUnprotectST25R391xComm();
     }
@@ -168,20 +287,41 @@ void st25r3911ReadTestRegister(uint8_t reg, uint8_t* value)
 #endif  /* ST25R391X_COM_SINGLETXRX */
 
     platformProtectST25R391xComm();
-    platformSpiSelect();
-
-    buf[0] = ST25R3911_CMD_TEST_ACCESS;
-    buf[1] = (reg | ST25R3911_READ_MODE);
-    buf[2] = 0x00;
-  
-    platformSpiTxRx(buf, buf, 3);
     
-    if(value != NULL)
+    st25r3911BatchFlush();
+    
+    if( (reg < ST25R3911_TEST_REG_LEN) && ((st25r3911Shadow.testValid & ST25R3911_REG_BIT(reg)) != 0U) )
     {
-      *value = buf[2];
+        if(value != NULL)
+        {
+            *value = st25r3911Shadow.testValue[reg];
+        }
+    }
+    else
+    {
+        platformSpiSelect();
+
+        buf[0] = ST25R3911_CMD_TEST_ACCESS;
+        buf[1] = (reg | ST25R3911_READ_MODE);
+        buf[2] = 0x00;
+      
+        if( !st25r3911ComResult( platformSpiTxRx(buf, buf, 3) ) )
+        {
+            buf[2] = 0x00U;
+        }
+        else
+        {
+            st25r3911ShadowTestUpdate( reg, buf[2] );
+        }
+        
+        if(value != NULL)
+        {
+          *value = buf[2];
+        }
+        
+        platformSpiDeselect();
     }
     
-    platformSpiDeselect();
     platformUnprotectST25R391xComm();
 
     return;
@@ -196,13 +336,19 @@ void st25r3911WriteTestRegister(uint8_t reg, uint8_t value)
 #endif  /* ST25R391X_COM_SINGLETXRX */
     
     platformProtectST25R391xComm();
+    
+    st25r3911BatchFlush();
+    
     platformSpiSelect();
 
     buf[0] = ST25R3911_CMD_TEST_ACCESS;
     buf[1] = (reg | ST25R3911_WRITE_MODE);
     buf[2] = value;
   
-    platformSpiTxRx(buf, NULL, 3);
+    if( st25r3911ComResult( platformSpiTxRx(buf, NULL, 3) ) )
+    {
+        st25r3911ShadowTestUpdate( reg, value );
+    }
   
     platformSpiDeselect();
     platformUnprotectST25R391xComm();
@@ -224,14 +370,28 @@ void st25r3911WriteRegister(uint8_t reg, uint8_t value)
     }    
     
     platformProtectST25R391xComm();
-    platformSpiSelect();
-
-    buf[0] = reg | ST25R3911_WRITE_MODE;
-    buf[1] = value;
     
-    platformSpiTxRx(buf, NULL, 2);
+    if( !st25r3911BatchDefer( reg, 0xFFU, value ) )
+    {
+        platformSpiSelect();
+
+        buf[0] = reg | ST25R3911_WRITE_MODE;
+        buf[1] = value;
+        
+        /* After a failed write the chip content is unknown, read it again next time */
+        if( st25r3911ComResult( platformSpiTxRx(buf, NULL, 2) ) )
+        {
+            st25r3911BatchMerge( reg, &buf[1], 1 );
+            st25r3911ShadowUpdate( reg, &buf[1], 1 );
+        }
+        else
+        {
+            st25r3911ShadowForget( reg, 1 );
+        }
+        
+        platformSpiDeselect();
+    }
     
-    platformSpiDeselect();
     platformUnprotectST25R391xComm();
 
     return;
@@ -239,11 +399,7 @@ void st25r3911WriteRegister(uint8_t reg, uint8_t value)
 
 void st25r3911ClrRegisterBits( uint8_t reg, uint8_t clr_mask )
 {
-    uint8_t tmp;
-
-    st25r3911ReadRegister(reg, &tmp);
-    tmp &= ~clr_mask;
-    st25r3911WriteRegister(reg, tmp);
+    st25r3911ModifyRegister(reg, clr_mask, 0x00U);
     
     return;
 }
@@ -251,11 +407,7 @@ void st25r3911ClrRegisterBits( uint8_t reg, uint8_t clr_mask )
 
 void st25r3911SetRegisterBits( uint8_t reg, uint8_t set_mask )
 {
-    uint8_t tmp;
-
-    st25r3911ReadRegister(reg, &tmp);
-    tmp |= set_mask;
-    st25r3911WriteRegister(reg, tmp);
+    st25r3911ModifyRegister(reg, 0x00U, set_mask);
     
     return;
 }
@@ -268,14 +420,30 @@ void st25r3911ChangeRegisterBits(uint8_t reg, uint8_t valueMask, uint8_t value)
 void st25r3911ModifyRegister(uint8_t reg, uint8_t clr_mask, uint8_t set_mask)
 {
     uint8_t tmp;
+    uint8_t old;
 
-    st25r3911ReadRegister(reg, &tmp);
+    /* Read-modify-write must not interleave with the IRQ context */
+    platformProtectST25R391xComm();
+    
+    if( !st25r3911BatchDefer( reg, clr_mask, set_mask ) )
+    {
+        /* Served from the shadow for configuration registers, no bus read */
+        st25r3911ReadRegister(reg, &tmp);
+        old = tmp;
 
-    /* mask out the bits we don't want to change */
-    tmp &= ~clr_mask;
-    /* set the new value */
-    tmp |= set_mask;
-    st25r3911WriteRegister(reg, tmp);
+        /* mask out the bits we don't want to change */
+        tmp &= ~clr_mask;
+        /* set the new value */
+        tmp |= set_mask;
+        
+        /* The chip already holds the value, save the write */
+        if( (tmp != old) || !st25r3911IsRegCacheable(reg) )
+        {
+            st25r3911WriteRegister(reg, tmp);
+        }
+    }
+    
+    platformUnprotectST25R391xComm();
 
     return;
 }
@@ -285,6 +453,8 @@ void st25r3911ChangeTestRegisterBits( uint8_t reg, uint8_t valueMask, uint8_t va
     uint8_t    rdVal;
     uint8_t    wrVal;
     
+    platformProtectST25R391xComm();
+    
     /* Read current reg value */
     st25r3911ReadTestRegister(reg, &rdVal);
     
@@ -292,14 +462,20 @@ void st25r3911ChangeTestRegisterBits( uint8_t reg, uint8_t valueMask, uint8_t va
     wrVal  = (rdVal & ~valueMask);
     wrVal |= (value & valueMask);
     
-    /* Write new reg value */
-    st25r3911WriteTestRegister(reg, wrVal );
+    if( wrVal != rdVal )
+    {
+        /* Write new reg value */
+        st25r3911WriteTestRegister(reg, wrVal );
+    }
+    
+    platformUnprotectST25R391xComm();
     
     return;
 }
 
 void st25r3911WriteMultipleRegisters(uint8_t reg, const uint8_t* values, uint8_t length)
 { 
+    bool    ok;
 #if !defined(ST25R391X_COM_SINGLETXRX)
     uint8_t cmd = (reg | ST25R3911_WRITE_MODE);
 #endif  /* !ST25R391X_COM_SINGLETXRX */
@@ -313,22 +489,40 @@ void st25r3911WriteMultipleRegisters(uint8_t reg, const uint8_t* values, uint8_t
     {
         /* make this operation atomic */
         platformProtectST25R391xComm();
+        
+        /* Keep the write order: anything pending goes out first */
+        st25r3911BatchFlush();
+        
         platformSpiSelect();
     
-#ifdef ST25R391X_COM_SINGLETXRX
+#if defined(ST25R391X_COM_CMDPHASE)
+        
+        ok = st25r3911ComResult( platformSpiCmdTxRx( cmd, values, NULL, length ) );
+        
+#elif defined(ST25R391X_COM_SINGLETXRX)
       
         comBuf[0] = (reg | ST25R3911_WRITE_MODE);
         ST_MEMCPY( &comBuf[ST25R3911_CMD_LEN], values, MIN( length, ST25R3911_BUF_LEN - ST25R3911_CMD_LEN ) );
 
-        platformSpiTxRx( comBuf, NULL, MIN( (ST25R3911_CMD_LEN + length), ST25R3911_BUF_LEN ) );
+        ok = st25r3911ComResult( platformSpiTxRx( comBuf, NULL, MIN( (ST25R3911_CMD_LEN + length), ST25R3911_BUF_LEN ) ) );
       
 #else  /*ST25R391X_COM_SINGLETXRX*/    
     
-        platformSpiTxRx( &cmd, NULL, ST25R3911_CMD_LEN );
-        platformSpiTxRx( values, NULL, length );
+        ok = st25r3911ComResult( platformSpiTxRx( &cmd, NULL, ST25R3911_CMD_LEN ) );
+        ok = (st25r3911ComResult( platformSpiTxRx( values, NULL, length ) ) && ok);
     
 #endif  /*ST25R391X_COM_SINGLETXRX*/    
     
+        if( ok )
+        {
+            st25r3911BatchMerge( reg, values, length );
+            st25r3911ShadowUpdate( reg, values, length );
+        }
+        else
+        {
+            st25r3911ShadowForget( reg, length );
+        }
+        
         platformSpiDeselect();
         platformUnprotectST25R391xComm();
     }
@@ -346,19 +540,26 @@ void st25r3911WriteFifo(const uint8_t* values, uint8_t length)
     if (length > 0U)
     {  
         platformProtectST25R391xComm();
+        
+        st25r3911BatchFlush();
+        
         platformSpiSelect();
   
-#ifdef ST25R391X_COM_SINGLETXRX
+#if defined(ST25R391X_COM_CMDPHASE)
+        
+        (void)st25r3911ComResult( platformSpiCmdTxRx( cmd, values, NULL, length ) );
+        
+#elif defined(ST25R391X_COM_SINGLETXRX)
   
         comBuf[0] = ST25R3911_FIFO_LOAD;
         ST_MEMCPY( &comBuf[ST25R3911_CMD_LEN], values, MIN( length, ST25R3911_BUF_LEN - ST25R3911_CMD_LEN ) );
 
-        platformSpiTxRx( comBuf, NULL, MIN( (ST25R3911_CMD_LEN + length), ST25R3911_BUF_LEN ) );
+        (void)st25r3911ComResult( platformSpiTxRx( comBuf, NULL, MIN( (ST25R3911_CMD_LEN + length), ST25R3911_BUF_LEN ) ) );
   
 #else  /*ST25R391X_COM_SINGLETXRX*/
   
-        platformSpiTxRx( &cmd, NULL, ST25R3911_CMD_LEN );
-        platformSpiTxRx( values, NULL, length );
+        (void)st25r3911ComResult( platformSpiTxRx( &cmd, NULL, ST25R3911_CMD_LEN ) );
+        (void)st25r3911ComResult( platformSpiTxRx( values, NULL, length ) );
   
 #endif  /*ST25R391X_COM_SINGLETXRX*/
   
@@ -378,20 +579,27 @@ void st25r3911ReadFifo(uint8_t* buf, uint8_t length)
     if(length > 0U)
     {
         platformProtectST25R391xComm();
+        
+        st25r3911BatchFlush();
+        
         platformSpiSelect();
 
-#ifdef ST25R391X_COM_SINGLETXRX
+#if defined(ST25R391X_COM_CMDPHASE)
+        
+        (void)st25r3911ComResult( platformSpiCmdTxRx( cmd, NULL, buf, length ) );                           /* Command and data as a single SPI call, straight into the output buffer */
+        
+#elif defined(ST25R391X_COM_SINGLETXRX)
       
         ST_MEMSET( comBuf, 0x00, MIN( (ST25R3911_CMD_LEN + (uint32_t)length), ST25R3911_BUF_LEN ) );
         comBuf[0] = ST25R3911_FIFO_READ;
       
-        platformSpiTxRx( comBuf, comBuf, MIN( (ST25R3911_CMD_LEN + length), ST25R3911_BUF_LEN ) );          /* Transceive as a single SPI call                        */
+        (void)st25r3911ComResult( platformSpiTxRx( comBuf, comBuf, MIN( (ST25R3911_CMD_LEN + length), ST25R3911_BUF_LEN ) ) );  /* Transceive as a single SPI call */
         ST_MEMCPY( buf, &comBuf[ST25R3911_CMD_LEN], MIN( length, ST25R3911_BUF_LEN - ST25R3911_CMD_LEN ) ); /* Copy from local buf to output buffer and skip cmd byte */
   
 #else  /*ST25R391X_COM_SINGLETXRX*/
   
-        platformSpiTxRx( &cmd, NULL, ST25R3911_CMD_LEN );
-        platformSpiTxRx( NULL, buf, length );
+        (void)st25r3911ComResult( platformSpiTxRx( &cmd, NULL, ST25R3911_CMD_LEN ) );
+        (void)st25r3911ComResult( platformSpiTxRx( NULL, buf, length ) );
   
 #endif  /*ST25R391X_COM_SINGLETXRX*/
       
@@ -405,6 +613,7 @@ void st25r3911ReadFifo(uint8_t* buf, uint8_t length)
 void st25r3911ExecuteCommand( uint8_t cmd )
 {
     uint8_t tmpCmd;                                    /* MISRA 17.8 */
+    bool    ok;
     
 #ifdef PLATFORM_LED_FIELD_PIN
     if ( (cmd >= ST25R3911_CMD_TRANSMIT_WITH_CRC) && (cmd <= ST25R3911_CMD_RESPONSE_RF_COLLISION_0))
@@ -416,9 +625,20 @@ void st25r3911ExecuteCommand( uint8_t cmd )
     tmpCmd = (cmd | ST25R3911_CMD_MODE);
 
     platformProtectST25R391xComm();
+    
+    /* Commands act on the configuration, it has to be in place */
+    st25r3911BatchFlush();
+    
     platformSpiSelect();
     
-    platformSpiTxRx( &tmpCmd, NULL, ST25R3911_CMD_LEN );
+    /* Not knowing whether the command ran, the shadow is dropped as if it did */
+    ok = st25r3911ComResult( platformSpiTxRx( &tmpCmd, NULL, ST25R3911_CMD_LEN ) );
+    
+    /* Set Default and Analog Preset rewrite registers behind our back */
+    if( !ok || (cmd == ST25R3911_CMD_SET_DEFAULT) || (cmd == ST25R3911_CMD_ANALOG_PRESET) )
+    {
+        st25r3911ShadowInvalidate();
+    }
     
     platformSpiDeselect();
     platformUnprotectST25R391xComm();
@@ -429,10 +649,24 @@ void st25r3911ExecuteCommand( uint8_t cmd )
 
 void st25r3911ExecuteCommands(const uint8_t *cmds, uint8_t length)
 {
+    uint8_t i;
+    bool    ok;
+    
     platformProtectST25R391xComm();
+    
+    st25r3911BatchFlush();
+    
     platformSpiSelect();
     
-    platformSpiTxRx( cmds, NULL, length );
+    ok = st25r3911ComResult( platformSpiTxRx( cmds, NULL, length ) );
+    
+    for( i = 0; i < length; i++ )
+    {
+        if( !ok || (cmds[i] == ST25R3911_CMD_SET_DEFAULT) || (cmds[i] == ST25R3911_CMD_ANALOG_PRESET) )
+        {
+            st25r3911ShadowInvalidate();
+        }
+    }
     
     platformSpiDeselect();
     platformUnprotectST25R391xComm();
@@ -440,6 +674,100 @@ void st25r3911ExecuteCommands(const uint8_t *cmds, uint8_t length)
     return;
 }
 
+void st25r3911BatchStart( void )
+{
+    platformProtectST25R391xComm();
+    
+    if( st25r3911Shadow.batchDepth == 0U )
+    {
+        st25r3911Shadow.batchOwner = platformGetTaskId();
+        st25r3911Shadow.batchDepth = 1U;
+    }
+    else if( st25r3911BatchIsOwner() )
+    {
+        st25r3911Shadow.batchDepth++;
+    }
+    else
+    {
+        /* One batch at a time: another task keeps writing straight to the bus */
+    }
+    
+    platformUnprotectST25R391xComm();
+}
+
+
+void st25r3911BatchCommit( void )
+{
+    platformProtectST25R391xComm();
+    
+    if( st25r3911BatchIsOwner() )
+    {
+        /* Only the outermost commit writes, nested ones just close their scope */
+        if( st25r3911Shadow.batchDepth == 1U )
+        {
+            st25r3911BatchFlush();
+        }
+        
+        st25r3911Shadow.batchDepth--;
+    }
+    
+    platformUnprotectST25R391xComm();
+}
+
+
+void st25r3911ShadowInvalidate( void )
+{
+    platformProtectST25R391xComm();
+    st25r3911Shadow.valid     = 0U;
+    st25r3911Shadow.testValid = 0U;
+    platformUnprotectST25R391xComm();
+}
+
+
+ReturnCode st25r3911ComGetError( void )
+{
+    ReturnCode ret;
+    
+    platformProtectST25R391xComm();
+    ret               = st25r3911ComError;
+    st25r3911ComError = ERR_NONE;
+    platformUnprotectST25R391xComm();
+    
+    return ret;
+}
+
+
+uint64_t st25r3911ShadowDump( uint8_t* values, uint8_t length )
+{
+    uint8_t  r;
+    uint64_t known;
+    
+    known = 0U;
+    
+    platformProtectST25R391xComm();
+    for( r = 0; (r < length) && (r < ST25R3911_SHADOW_LEN); r++ )
+    {
+        if( (st25r3911Shadow.dirty & ST25R3911_REG_BIT(r)) != 0U )
+        {
+            values[r] = st25r3911Shadow.pending[r];
+            known    |= ST25R3911_REG_BIT(r);
+        }
+        else if( (st25r3911Shadow.valid & ST25R3911_REG_BIT(r)) != 0U )
+        {
+            values[r] = st25r3911Shadow.value[r];
+            known    |= ST25R3911_REG_BIT(r);
+        }
+        else
+        {
+            values[r] = 0x00U;
+        }
+    }
+    platformUnprotectST25R391xComm();
+    
+    return known;
+}
+
+
 bool st25r3911IsRegValid( uint8_t reg )
 {
     if( !(( (int16_t)reg >= (int16_t)ST25R3911_REG_IO_CONF1) && (reg <= ST25R3911_REG_CAPACITANCE_MEASURE_RESULT)) &&  (reg != ST25R3911_REG_IC_IDENTITY)  )
@@ -455,3 +783,276 @@ bool st25r3911IsRegValid( uint8_t reg )
 ******************************************************************************
 */
 
+/*! 
+ *****************************************************************************
+ *  \brief  Update the shadow after a register access on the bus
+ *
+ *  \param[in]  reg    : Address of the first register accessed
+ *  \param[in]  values : Values now held by the chip
+ *  \param[in]  length : Number of registers accessed
+ *****************************************************************************
+ */
+static void st25r3911ShadowUpdate( uint8_t reg, const uint8_t* values, uint8_t length )
+{
+    uint8_t i;
+    uint8_t r;
+    
+    for( i = 0; i < length; i++ )
+    {
+        r = (reg + i);
+        if( st25r3911IsRegCacheable(r) )
+        {
+            st25r3911Shadow.value[r] = values[i];
+            st25r3911Shadow.valid   |= ST25R3911_REG_BIT(r);
+        }
+    }
+}
+
+
+/*! 
+ *****************************************************************************
+ *  \brief  Drop registers from the shadow after a failed write
+ *
+ *  \param[in]  reg    : Address of the first register written
+ *  \param[in]  length : Number of registers written
+ *****************************************************************************
+ */
+static void st25r3911ShadowForget( uint8_t reg, uint8_t length )
+{
+    uint8_t i;
+    
+    for( i = 0; (i < length) && ((reg + i) < ST25R3911_SHADOW_LEN); i++ )
+    {
+        st25r3911Shadow.valid &= ~ST25R3911_REG_BIT(reg + i);
+    }
+}
+
+
+/*! 
+ *****************************************************************************
+ *  \brief  Update the test register shadow after an access on the bus
+ *
+ *  \param[in]  reg   : Address of the test register accessed
+ *  \param[in]  value : Value now held by the chip
+ *****************************************************************************
+ */
+static void st25r3911ShadowTestUpdate( uint8_t reg, uint8_t value )
+{
+    if( reg < ST25R3911_TEST_REG_LEN )
+    {
+        st25r3911Shadow.testValue[reg] = value;
+        st25r3911Shadow.testValid     |= ST25R3911_REG_BIT(reg);
+    }
+}
+
+
+/*! 
+ *****************************************************************************
+ *  \brief  Check whether the calling task opened the current batch
+ *
+ *  \return true  : A batch is open and it belongs to the caller
+ *  \return false : No batch open or opened by another task
+ *****************************************************************************
+ */
+static bool st25r3911BatchIsOwner( void )
+{
+    return ( (st25r3911Shadow.batchDepth != 0U) && (st25r3911Shadow.batchOwner == platformGetTaskId()) );
+}
+
+
+/*! 
+ *****************************************************************************
+ *  \brief  Carry a write from another task into the open batch
+ *
+ *  Bits another task changed on the bus are changed alike in the pending
+ *  writes of the batch owner, so the commit does not undo them. To be 
+ *  called before the shadow is updated with the written values.
+ *
+ *  \param[in]  reg    : Address of the first register written
+ *  \param[in]  values : Values written
+ *  \param[in]  length : Number of registers written
+ *****************************************************************************
+ */
+static void st25r3911BatchMerge( uint8_t reg, const uint8_t* values, uint8_t length )
+{
+    uint8_t i;
+    uint8_t r;
+    uint8_t changed;
+    
+    if( (st25r3911Shadow.batchDepth == 0U) || st25r3911BatchIsOwner() )
+    {
+        return;
+    }
+    
+    for( i = 0; i < length; i++ )
+    {
+        r = (reg + i);
+        if( (r < ST25R3911_SHADOW_LEN) && ((st25r3911Shadow.dirty & ST25R3911_REG_BIT(r)) != 0U) )
+        {
+            changed = (((st25r3911Shadow.valid & ST25R3911_REG_BIT(r)) != 0U) ? (st25r3911Shadow.value[r] ^ values[i]) : 0xFFU);
+            
+            st25r3911Shadow.pending[r] &= ~changed;
+            st25r3911Shadow.pending[r] |= (values[i] & changed);
+        }
+    }
+}
+
+
+/*! 
+ *****************************************************************************
+ *  \brief  Defer a register change into the open batch
+ *
+ *  The new value is computed from the pending write, else from the shadow,
+ *  else from a single bus read which also fills the shadow.
+ *
+ *  \param[in]  reg      : Address of the register
+ *  \param[in]  clr_mask : Bits to be cleared
+ *  \param[in]  set_mask : Bits to be set
+ *
+ *  \return true  : Change deferred, nothing to be done on the bus now
+ *  \return false : No batch open or register not cacheable, caller goes to the bus
+ *****************************************************************************
+ */
+static bool st25r3911BatchDefer( uint8_t reg, uint8_t clr_mask, uint8_t set_mask )
+{
+    uint8_t tmp;
+    
+    if( (st25r3911Shadow.batchDepth == 0U) || !st25r3911IsRegCacheable(reg) )
+    {
+        return false;
+    }
+    
+    /* Another task goes to the bus */
+    if( !st25r3911BatchIsOwner() )
+    {
+        return false;
+    }
+    
+    if( (st25r3911Shadow.dirty & ST25R3911_REG_BIT(reg)) != 0U )
+    {
+        tmp = st25r3911Shadow.pending[reg];
+    }
+    else if( (st25r3911Shadow.valid & ST25R3911_REG_BIT(reg)) != 0U )
+    {
+        tmp = st25r3911Shadow.value[reg];
+    }
+    else
+    {
+        st25r3911ReadRegister( reg, &tmp );
+    }
+    
+    tmp &= ~clr_mask;
+    tmp |= set_mask;
+    
+    st25r3911Shadow.pending[reg] = tmp;
+    st25r3911Shadow.dirty       |= ST25R3911_REG_BIT(reg);
+    
+    return true;
+}
+
+
+/*! 
+ *****************************************************************************
+ *  \brief  Write out the pending batch
+ *
+ *  Registers whose pending value is already in the chip are skipped. The
+ *  rest is coalesced into multi-register bursts, merging runs separated by
+ *  up to ST25R3911_BATCH_GAP registers of known value by rewriting those.
+ *****************************************************************************
+ */
+static void st25r3911BatchFlush( void )
+{
+    uint8_t  buf[ST25R3911_SHADOW_LEN];
+    uint64_t write;
+    uint64_t known;
+    uint8_t  depth;
+    uint8_t  start;
+    uint8_t  end;
+    uint8_t  gap;
+    uint8_t  r;
+    
+    /* Only the task which opened the batch writes it out, any other
+     * (e.g. the IRQ context reading IRQ_MAIN) leaves it open           */
+    if( (st25r3911Shadow.dirty == 0U) || !st25r3911BatchIsOwner() )
+    {
+        return;
+    }
+    
+    /* Registers that really change */
+    write = 0U;
+    for( r = 0; r < ST25R3911_SHADOW_LEN; r++ )
+    {
+        if( ((st25r3911Shadow.dirty & ST25R3911_REG_BIT(r)) != 0U) && 
+            (((st25r3911Shadow.valid & ST25R3911_REG_BIT(r)) == 0U) || (st25r3911Shadow.value[r] != st25r3911Shadow.pending[r])) )
+        {
+            write |= ST25R3911_REG_BIT(r);
+        }
+        buf[r] = (((st25r3911Shadow.dirty & ST25R3911_REG_BIT(r)) != 0U) ? st25r3911Shadow.pending[r] : st25r3911Shadow.value[r]);
+    }
+    known = (st25r3911Shadow.valid | st25r3911Shadow.dirty);
+    
+    /* Close the batch while writing so the bursts below go straight to the bus */
+    depth                      = st25r3911Shadow.batchDepth;
+    st25r3911Shadow.batchDepth = 0U;
+    st25r3911Shadow.dirty      = 0U;
+    
+    r = 0;
+    while( r < ST25R3911_SHADOW_LEN )
+    {
+        if( (write & ST25R3911_REG_BIT(r)) == 0U )
+        {
+            r++;
+            continue;
+        }
+        
+        start = r;
+        end   = r;
+        gap   = 0;
+        for( r = (start + 1U); r < ST25R3911_SHADOW_LEN; r++ )
+        {
+            if( (write & ST25R3911_REG_BIT(r)) != 0U )
+            {
+                end = r;
+                gap = 0;
+            }
+            else if( ((known & ST25R3911_REG_BIT(r)) != 0U) && (gap < ST25R3911_BATCH_GAP) )
+            {
+                gap++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        
+        st25r3911WriteMultipleRegisters( start, &buf[start], (end - start + 1U) );
+        r = (end + 1U);
+    }
+    
+    st25r3911Shadow.batchDepth = depth;
+}
+
+
+/*! 
+ *****************************************************************************
+ *  \brief  Check the result of a bus transfer
+ *
+ *  A failed transfer is latched as ERR_IO until st25r3911ComGetError()
+ *  fetches it, so callers of the void accessors still learn about it.
+ *
+ *  \param[in]  ret : Value returned by the platform SPI transfer, 0 on success
+ *
+ *  \return true  : Transfer done
+ *  \return false : Transfer failed
+ *****************************************************************************
+ */
+static bool st25r3911ComResult( int32_t ret )
+{
+    if( ret != 0 )
+    {
+        st25r3911ComError = ERR_IO;
+        return false;
+    }
+    return true;
+}
+
@@ -802,6 +802,82 @@ extern void st25r3911ExecuteCommands(const uint8_t *cmds, uint8_t length);
  */
 extern bool st25r3911IsRegValid( uint8_t reg );
 
+/*! 
+ *****************************************************************************
+ *  \brief  Start a batch of register writes
+ *
+ *  Until the matching st25r3911BatchCommit(), writes and bit changes on
+ *  configuration registers are only recorded. Volatile registers (IRQ,
+ *  FIFO status, displays) still go to the bus immediately. Direct commands,
+ *  FIFO and test register accesses write the pending batch out first so
+ *  the chip sees the configuration in order. Batches can be nested.
+ *  
+ *  The batch belongs to the calling task: accesses from any other task
+ *  (e.g. the IRQ context) neither see nor write out the pending changes,
+ *  they go straight to the bus.
+ *
+ *****************************************************************************
+ */
+extern void st25r3911BatchStart( void );
+
+/*! 
+ *****************************************************************************
+ *  \brief  Commit a batch of register writes
+ *
+ *  Closes the scope opened by st25r3911BatchStart(). The outermost commit
+ *  skips registers which already hold their new value and writes the rest
+ *  in as few multi-register bursts as possible.
+ *
+ *****************************************************************************
+ */
+extern void st25r3911BatchCommit( void );
+
+/*! 
+ *****************************************************************************
+ *  \brief  Forget the register shadow
+ *
+ *  Every register is read from the chip again on next access. Needed when
+ *  the chip configuration changed outside this module (e.g. power cycle).
+ *  Set Default and Analog Preset do it on their own.
+ *
+ *****************************************************************************
+ */
+extern void st25r3911ShadowInvalidate( void );
+
+/*! 
+ *****************************************************************************
+ *  \brief  Fetch the latched bus error
+ *
+ *  Register, FIFO and command accesses do not return a status. A failed
+ *  SPI transfer is latched instead and kept until fetched here; the 
+ *  fetch clears it. The shadow is not updated from a failed transfer.
+ *
+ *  \return ERR_IO   : At least one SPI transfer failed since last call
+ *  \return ERR_NONE : No error
+ *
+ *****************************************************************************
+ */
+extern ReturnCode st25r3911ComGetError( void );
+
+/*! 
+ *****************************************************************************
+ *  \brief  Dump the register shadow
+ *
+ *  Copies what is known of the register content without any bus access,
+ *  so it is safe to call while a transceive is ongoing. Registers pending
+ *  in a batch are reported with their pending value.
+ *
+ *  \param[out] values : Buffer for the registers, starting at address 0
+ *  \param[in]  length : Buffer length
+ *
+ *  \return Bitmap of the registers in values that are known, bit n for 
+ *          register n. Volatile and not yet accessed registers are 0 in 
+ *          values and not flagged.
+ *
+ *****************************************************************************
+ */
+extern uint64_t st25r3911ShadowDump( uint8_t* values, uint8_t length );
+
 #endif /* ST25R3911_COM_H */
 
 /**
@@ -66,6 +66,8 @@ typedef struct
 {
     void      (*prevCallback)(void); /*!< call back function for 3911 interrupt               */
     void      (*callback)(void);     /*!< call back function for 3911 interrupt               */
+    st25r3911IrqHook hook;           /*!< hook run on the IRQs read, before they are stored   */
+    uint32_t  hookMask;              /*!< IRQs the hook is run for                            */
     uint32_t  status;                /*!< latest interrupt status                             */
     uint32_t  mask;                  /*!< Interrupt mask. Negative mask = ST25R3911 mask regs */
 }t_st25r3911Interrupt;
@@ -90,6 +92,8 @@ void st25r3911InitInterrupts( void )
     
     st25r3911interrupt.callback     = NULL;
     st25r3911interrupt.prevCallback = NULL;
+    st25r3911interrupt.hook         = NULL;
+    st25r3911interrupt.hookMask     = 0;
     st25r3911interrupt.status       = 0;
     st25r3911interrupt.mask         = 0;
     
@@ -123,7 +127,7 @@ void st25r3911CheckForReceivedInterrupts( void )
     ST_MEMSET( iregs, (int32_t)(ST25R3911_IRQ_MASK_ALL & 0xFFU), ST25R3911_INT_REGS_LEN );  /* MISRA 10.3 */
         
     /* In case the IRQ is Edge (not Level) triggered read IRQs until done */
-    while( platformGpioIsHigh( ST25R391X_INT_PORT, ST25R391X_INT_PIN ) )
+    while( platformIrqST25R3911PinIsHigh() )
     {
         st25r3911ReadMultipleRegisters(ST25R3911_REG_IRQ_MAIN, iregs, sizeof(iregs));
        
@@ -148,8 +152,17 @@ void st25r3911CheckForReceivedInterrupts( void )
         irqStatus  = (uint32_t)iregs[0];
         irqStatus |= (uint32_t)iregs[1]<<8;
         irqStatus |= (uint32_t)iregs[2]<<16;
+        
+        /* Time critical IRQs are served right here, those consumed are not forwarded */
+        if( (st25r3911interrupt.hook != NULL) && ((irqStatus & st25r3911interrupt.hookMask) != 0U) )
+        {
+            irqStatus &= ~st25r3911interrupt.hook( irqStatus );
+        }
+        
         /* forward all interrupts, even masked ones to application. */
+        platformProtectST25R391xIrqStatus();
         st25r3911interrupt.status |= irqStatus;
+        platformUnprotectST25R391xIrqStatus();
     }
 }
 
@@ -177,18 +190,40 @@ void st25r3911ModifyInterrupts(uint32_t clr_mask, uint32_t set_mask)
 
 uint32_t st25r3911WaitForInterruptsTimed(uint32_t mask, uint16_t tmo)
 {
-    uint32_t tmr;
+    return st25r3911WaitForInterruptsTimed_us( mask, ((uint32_t)tmo * 1000U) );
+}
+
+uint32_t st25r3911WaitForInterruptsTimed_us(uint32_t mask, uint32_t tmo_us)
+{
+    uint64_t deadline;
+    uint64_t now;
     uint32_t status;
-   
-    tmr = platformTimerCreate(tmo);
+    
+    deadline = platformGetTimeUs() + tmo_us;
+    
+    /* Register before checking the status, an IRQ landing in between still wakes us */
+    platformIrqST25R3911WaitBegin();
     do 
     {
         status = (st25r3911interrupt.status & mask);
-    } while( (!platformTimerIsExpired(tmr)) && (status == 0U) );
+        if( status != 0U )
+        {
+            break;
+        }
+        
+        now = platformGetTimeUs();
+        if( (tmo_us != 0U) && (now >= deadline) )
+        {
+            break;
+        }
+        
+        /* Sleep until the IRQ task signals a drained burst or the deadline fires */
+        platformIrqST25R3911Wait( (tmo_us != 0U) ? (uint32_t)(deadline - now) : 0U );
+    } while( true );
+    platformIrqST25R3911WaitEnd();
 
-    status = st25r3911interrupt.status & mask;
-    
     platformProtectST25R391xIrqStatus();
+    status = st25r3911interrupt.status & mask;
     st25r3911interrupt.status &= ~status;
     platformUnprotectST25R391xIrqStatus();
     
@@ -237,6 +272,13 @@ void st25r3911IRQCallbackSet( void (*cb)(void) )
     st25r3911interrupt.callback     = cb;
 }
 
+void st25r3911IRQHookSet( uint32_t mask, st25r3911IrqHook hook )
+{
+    st25r3911interrupt.hook     = NULL;
+    st25r3911interrupt.hookMask = mask;
+    st25r3911interrupt.hook     = hook;
+}
+
 void st25r3911IRQCallbackRestore( void )
 {
     st25r3911interrupt.callback     = st25r3911interrupt.prevCallback;
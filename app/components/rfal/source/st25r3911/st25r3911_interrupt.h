@@ -101,6 +101,14 @@
 #define ST25R3911_IRQ_MASK_TIM             (0x02U)               /*!< additional interrupts in ST25R3911_REG_IRQ_TIMER_NFC         */
 #define ST25R3911_IRQ_MASK_ERR             (0x01U)               /*!< additional interrupts in ST25R3911_REG_IRQ_ERROR_WUP         */
 
+/*
+******************************************************************************
+* GLOBAL TYPES
+******************************************************************************
+*/
+
+/*! IRQ hook: gets the IRQs just read and returns those it has fully handled */
+typedef uint32_t (*st25r3911IrqHook)(uint32_t irqs);
 
 /*
 ******************************************************************************
@@ -128,6 +136,25 @@
  */
 extern uint32_t st25r3911WaitForInterruptsTimed(uint32_t mask, uint16_t tmo);
 
+/*! 
+ *****************************************************************************
+ *  \brief  Wait until an ST25R3911 interrupt occurs, microsecond timeout
+ *
+ *  Same as st25r3911WaitForInterruptsTimed() but with the timeout given in
+ *  microseconds. The calling task blocks until the IRQ task reports one of
+ *  the interrupts in \a mask or the deadline passes, it does not poll.
+ *
+ *  \param[in] mask   : mask indicating the interrupts to wait for.
+ *  \param[in] tmo_us : time in microseconds until timeout occurs. If set
+ *                      to 0 the functions waits forever.
+ *
+ *  \return : 0 if timeout occurred otherwise a mask indicating the cleared
+ *              interrupts.
+ *
+ *****************************************************************************
+ */
+extern uint32_t st25r3911WaitForInterruptsTimed_us(uint32_t mask, uint32_t tmo_us);
+
 /*! 
  *****************************************************************************
  *  \brief  Get status for the given interrupt
@@ -237,6 +264,21 @@ extern void st25r3911IRQCallbackSet(void (*cb)(void));
  */
 extern void st25r3911IRQCallbackRestore(void);
 
+/*! 
+ *****************************************************************************
+ *  \brief  Sets a hook run in the IRQ context on every IRQ read
+ *
+ *  The hook is called whenever any of the IRQs in \a mask is read, before
+ *  the IRQs are stored. IRQs it returns are consumed and never seen by
+ *  #st25r3911GetInterrupt or #st25r3911WaitForInterruptsTimed.
+ *
+ *  \param[in] mask : IRQs the hook is called for
+ *  \param[in] hook : hook to be called, NULL to remove it
+ *
+ *****************************************************************************
+ */
+extern void st25r3911IRQHookSet(uint32_t mask, st25r3911IrqHook hook);
+
 #endif /* ST25R3911_ISR_H */
 
 /**
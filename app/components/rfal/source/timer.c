@@ -0,0 +1,135 @@
+/******************************************************************************
+  * \attention
+  *
+  * <h2><center>&copy; COPYRIGHT 2016 STMicroelectronics</center></h2>
+  *
+  * Licensed under ST MYLIBERTY SOFTWARE LICENSE AGREEMENT (the "License");
+  * You may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at:
+  *
+  *        www.st.com/myliberty
+  *
+  * Unless required by applicable law or agreed to in writing, software 
+  * distributed under the License is distributed on an "AS IS" BASIS, 
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+  * AND SPECIFICALLY DISCLAIMING THE IMPLIED WARRANTIES OF MERCHANTABILITY,
+  * FITNESS FOR A PARTICULAR PURPOSE, AND NON-INFRINGEMENT.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+******************************************************************************/
+
+/*
+ *      PROJECT:   ST25R391x firmware
+ *      Revision:
+ *      LANGUAGE:  ISO C99
+ */
+
+/*! \file timer.c
+ *
+ *  \brief SW Timer implementation
+ *
+ *  Timers are absolute deadlines in microseconds on a 64 bit monotonic
+ *  clock (esp_timer on the target). A 64 bit deadline does not wrap during
+ *  the lifetime of the device, so a timer left untouched for a long time
+ *  still reads as expired.
+ *
+ */
+
+/*
+******************************************************************************
+* INCLUDES
+******************************************************************************
+*/
+#include "timer.h"
+
+/*
+******************************************************************************
+* LOCAL DEFINES
+******************************************************************************
+*/
+#define TIMER_US_IN_MS          1000U   /*!< Microseconds in a millisecond */
+
+/*
+******************************************************************************
+* LOCAL VARIABLES
+******************************************************************************
+*/
+static uint64_t timerPlatformClock( void );
+
+static timerClockSource timerClock = timerPlatformClock;   /*!< Clock the timers are based on */
+static uint64_t         timerStopwatchValue;               /*!< Stopwatch start time (us)     */
+
+/*
+******************************************************************************
+* GLOBAL FUNCTIONS
+******************************************************************************
+*/
+
+/*******************************************************************************/
+uint64_t timerCalculateTimer( uint16_t time )
+{
+    return timerCalculateTimer_us( (uint32_t)time * TIMER_US_IN_MS );
+}
+
+/*******************************************************************************/
+uint64_t timerCalculateTimer_us( uint32_t time_us )
+{
+    return ( timerClock() + time_us );
+}
+
+/*******************************************************************************/
+bool timerIsExpired( uint64_t timer )
+{
+    return ( timerClock() >= timer );
+}
+
+/*******************************************************************************/
+uint64_t timerRemaining_us( uint64_t timer )
+{
+    uint64_t now = timerClock();
+    
+    return ( (now >= timer) ? 0U : (timer - now) );
+}
+
+/*******************************************************************************/
+void timerDelay( uint16_t time )
+{
+    platformDelay( time );
+}
+
+/*******************************************************************************/
+void timerStopwatchStart( void )
+{
+    timerStopwatchValue = timerClock();
+}
+
+/*******************************************************************************/
+uint32_t timerStopwatchMeasure( void )
+{
+    return ( timerStopwatchMeasure_us() / TIMER_US_IN_MS );
+}
+
+/*******************************************************************************/
+uint32_t timerStopwatchMeasure_us( void )
+{
+    return (uint32_t)( timerClock() - timerStopwatchValue );
+}
+
+/*******************************************************************************/
+void timerSetClockSource( timerClockSource clock )
+{
+    timerClock = ( (clock != NULL) ? clock : timerPlatformClock );
+}
+
+/*
+******************************************************************************
+* LOCAL FUNCTIONS
+******************************************************************************
+*/
+
+/*******************************************************************************/
+static uint64_t timerPlatformClock( void )
+{
+    return platformGetTimeUs();
+}
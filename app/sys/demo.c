@@ -61,6 +61,14 @@
 #include "rfal_st25tb.h"
 #include "rfal_nfcDep.h"
 #include "rfal_isoDep.h"
+#include "sys_nfc_isodep.h"
+#include "sys_nfc_poll.h"
+#include "sys_nfc_wakeup.h"
+#include "sys_nfc_presence.h"
+#include "sys_nfc_nfcv.h"
+#include "sys_nfc_nfcv_inv.h"
+#include "sys_nfc_nfcb_inv.h"
+#include "sys_nfc_nfca_cache.h"
 
 /*
 ******************************************************************************
@@ -69,16 +77,13 @@
 */
 
 /* Definition of possible states the demo state machine could have */
-#define DEMO_ST_FIELD_OFF			        0
-#define DEMO_ST_POLL_ACTIVE_TECH      1
-#define DEMO_ST_POLL_PASSIV_TECH      2
-#define DEMO_ST_WAIT_WAKEUP	          3
+#define DEMO_ST_POLL                  0
+#define DEMO_ST_WAIT_WAKEUP	          1
 
 #define DEMO_BUF_LEN                  255
+#define DEMO_APDU_RX_LEN              32
 #define DEMO_NFCV_BLOCK_LEN           4
-
-/* macro to cycle through states */
-#define	NEXT_STATE()		             {state++; state %= sizeof(stateArray);}
+#define DEMO_NFCV_DUMP_LEN            256
 
 
 
@@ -89,21 +94,26 @@
  ******************************************************************************
  */
 
-/* State array of all possible states to be executed one after each other */
-static uint8_t stateArray[] = { DEMO_ST_FIELD_OFF,
-                                DEMO_ST_POLL_ACTIVE_TECH,
-                                DEMO_ST_POLL_PASSIV_TECH,
-                                DEMO_ST_WAIT_WAKEUP
-                              };
-
 /* P2P communication data */
 static uint8_t NFCID3[] = {0x01, 0xFE, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A};
 static uint8_t GB[] = {0x46, 0x66, 0x6d, 0x01, 0x01, 0x11, 0x02, 0x02, 0x07, 0x80, 0x03, 0x02, 0x00, 0x03, 0x04, 0x01, 0x32, 0x07, 0x01, 0x03};
     
+/* NFC-V memory dump */
+static uint8_t nfcvDump[DEMO_NFCV_DUMP_LEN];
+
 /* APDUs communication data */    
 static uint8_t ndefSelectApp[] = { 0x00, 0xA4, 0x04, 0x00, 0x07, 0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01, 0x00 };
 static uint8_t ccSelectFile[] = { 0x00, 0xA4, 0x00, 0x0C, 0x02, 0xE1, 0x03};
 static uint8_t readBynary[] = { 0x00, 0xB0, 0x00, 0x00, 0x0F };
+
+/* APDUs exchanged in turn with every ISO-DEP session, each only after the previous answered 90 00 */
+static const struct {
+    const uint8_t *apdu;
+    uint16_t       len;
+} demoApduSeq[] = { { ndefSelectApp, sizeof(ndefSelectApp) },
+                    { ccSelectFile,  sizeof(ccSelectFile)  },
+                    { readBynary,    sizeof(readBynary)    }
+                  };
 /*static uint8_t ppseSelectApp[] = { 0x00, 0xA4, 0x04, 0x00, 0x0E, 0x32, 0x50, 0x41, 0x59, 0x2E, 0x53, 0x59, 0x53, 0x2E, 0x44, 0x44, 0x46, 0x30, 0x31, 0x00 };*/
 
 /* P2P communication data */    
@@ -141,8 +151,15 @@ static union {
     rfalNfcDepDevice  nfcDepDev;                                         /* NFC-DEP Device details                          */
 }gDevProto;
 
-static bool doWakeUp = false;                /*!< by default do not perform Wake-Up               */
-static uint8_t state = DEMO_ST_FIELD_OFF;    /*!< Actual state, starting with RF field turned off */
+/*! APDU sequence of each ISO-DEP session, the sessions take turns               */
+static struct {
+    sys_nfc_isodep_apdu_t  apdu;                                         /* APDU in progress                                */
+    uint8_t                rxBuf[DEMO_APDU_RX_LEN];                      /* Response buffer                                 */
+    uint8_t                step;                                         /* Index in demoApduSeq                            */
+}gSessionApdu[SYS_NFC_ISODEP_MAX_SESSIONS];
+
+static bool doWakeUp = SYS_NFC_WAKEUP_ENABLE;/*!< Wake-Up in between rounds that found nothing    */
+static uint8_t state = DEMO_ST_POLL;         /*!< Actual state, starting with polling             */
   
 
 
@@ -164,6 +181,34 @@ static ReturnCode demoNfcDepBlockingTxRx( rfalNfcDepDevice *nfcDepDev, const uin
 static ReturnCode demoIsoDepBlockingTxRx( rfalIsoDepDevice *isoDepDev, const uint8_t *txBuf, uint16_t txBufSize, uint8_t *rxBuf, uint16_t rxBufSize, uint16_t *rxActLen );
 static void demoSendNdefUri( void );
 static void demoSendAPDUs( void );
+static void demoSendSessionAPDUs( void );
+static void demoQueueSessionAPDU( uint8_t session );
+static void demoSessionApduDone( sys_nfc_isodep_apdu_t *apdu, void *arg );
+static void demoFieldOff( void );
+
+
+/*!
+ *****************************************************************************
+ * \brief Demo Init
+ *
+ *  Hands the technology polls over to the poll scheduler and sets up 
+ *  the Wake-Up mode. Must be called before the NFC worker task starts
+ *****************************************************************************
+ */
+void demoInit( void )
+{
+  static const sys_nfc_poll_fn_t pollers[SYS_NFC_POLL_TECH_MAX] = {
+      [SYS_NFC_POLL_TECH_AP2P]   = demoPollAP2P,
+      [SYS_NFC_POLL_TECH_NFCA]   = demoPollNFCA,
+      [SYS_NFC_POLL_TECH_NFCB]   = demoPollNFCB,
+      [SYS_NFC_POLL_TECH_ST25TB] = demoPollST25TB,
+      [SYS_NFC_POLL_TECH_NFCF]   = demoPollNFCF,
+      [SYS_NFC_POLL_TECH_NFCV]   = demoPollNFCV
+  };
+  
+  sys_nfc_poll_init( pollers, demoFieldOff );
+  sys_nfc_wakeup_init( NULL );
+}
 
 
 /*!
@@ -171,86 +216,105 @@ static void demoSendAPDUs( void );
  * \brief Demo Cycle
  *
  *  This function executes the actual state of the demo state machine. 
+ *  The poll scheduler decides which technology is polled and when, 
+ *  Wake-Up mode takes over once a round found nothing if enabled: 
+ *  field off and the ESP32 asleep until the chip detects a card.
  *  Must be called cyclically
+ *
+ *  \return time in us until the next call is due, 0 for right away
  *****************************************************************************
  */
-void demoCycle( void )
+uint32_t demoCycle( void )
 {
-  bool found = false;
+  bool found;
   
+#if (PLATFORM_USER_BUTTON_PIN >= 0)
   /* Check if USER button is pressed */
   if( platformGpioIsLow(PLATFORM_USER_BUTTON_PORT, PLATFORM_USER_BUTTON_PIN))
   {
 			doWakeUp = !doWakeUp;             /* enable/disable wakeup */
-			state = DEMO_ST_FIELD_OFF;        /* restart loop          */
+    
+			if( state == DEMO_ST_WAIT_WAKEUP )
+			{
+				sys_nfc_wakeup_stop();
+			}
+			state = DEMO_ST_POLL;             /* restart loop          */
+			sys_nfc_poll_trigger();
     
 			/* Debounce button */
 			while( platformGpioIsLow(PLATFORM_USER_BUTTON_PORT, PLATFORM_USER_BUTTON_PIN) );
 	}
+#endif /* PLATFORM_USER_BUTTON_PIN */
   
-  switch( stateArray[state] )
+  switch( state )
   {
-    case DEMO_ST_FIELD_OFF:
-    
-      platformLedOff(PLATFORM_LED_A_PORT, PLATFORM_LED_A_PIN);
-      platformLedOff(PLATFORM_LED_B_PORT, PLATFORM_LED_B_PIN);
-      platformLedOff(PLATFORM_LED_F_PORT, PLATFORM_LED_F_PIN);
-      platformLedOff(PLATFORM_LED_V_PORT, PLATFORM_LED_V_PIN);
-      platformLedOff(PLATFORM_LED_AP2P_PORT, PLATFORM_LED_AP2P_PIN);
-      platformLedOff(PLATFORM_LED_FIELD_PORT, PLATFORM_LED_FIELD_PIN);
+    case DEMO_ST_POLL:
     
-      rfalFieldOff();
-      rfalWakeUpModeStop();
-      platformDelay(300);
-    
-      /* If WakeUp is to be executed, enable Wake-Up mode */
-      if( doWakeUp )
+      /* In between rounds the field is off, keep polling while devices are around */
+      if( doWakeUp && sys_nfc_poll_is_idle() )
       {
-        platformLog("Going to Wakeup mode.\r\n");
+        found = sys_nfc_poll_round_found();
+        sys_nfc_wakeup_report( found );
         
-        rfalWakeUpModeStart( NULL );
-        state = DEMO_ST_WAIT_WAKEUP;
-        break;
+        if( !found )
+        {
+          if( sys_nfc_wakeup_start() == ERR_NONE )
+          {
+            platformLog("Going to Wakeup mode.\r\n");
+            
+            state = DEMO_ST_WAIT_WAKEUP;
+            return sys_nfc_wakeup_cycle();
+          }
+          
+          platformLog("Wakeup mode failed, polling only.\r\n");
+          doWakeUp = false;
+        }
       }
-    
-      NEXT_STATE();
-      break;
-
-
-    case DEMO_ST_POLL_ACTIVE_TECH:
-      demoPollAP2P();
-      platformDelay(40);
-      NEXT_STATE();
-      break;
-
-    case DEMO_ST_POLL_PASSIV_TECH:
-      found |= demoPollNFCA();
-      found |= demoPollNFCB();
-      found |= demoPollST25TB();
-      found |= demoPollNFCF();
-      found |= demoPollNFCV();
-    
-      platformDelay(300);
-      state = DEMO_ST_FIELD_OFF;
-      break;
+      
+      return sys_nfc_poll_cycle();
       
     case DEMO_ST_WAIT_WAKEUP:
       
       /* Check if Wake-Up Mode has been awaked */
-      if( rfalWakeUpModeHasWoke() )
+      if( sys_nfc_wakeup_has_woke() )
       {
         /* If awake, go directly to Poll */
-        rfalWakeUpModeStop();
-        state = DEMO_ST_POLL_ACTIVE_TECH;
+        sys_nfc_wakeup_stop();
+        state = DEMO_ST_POLL;
+        
+        sys_nfc_poll_trigger();
+        return sys_nfc_poll_cycle();
       }
-      break;
+      return sys_nfc_wakeup_cycle();
 
     default:
-      break;
+      state = DEMO_ST_POLL;
+      return 0;
   }
 }
 
 
+/*!
+ *****************************************************************************
+ * \brief Field Off
+ *
+ *  Run by the poll scheduler once the field went off at the end of a round
+ *****************************************************************************
+ */
+static void demoFieldOff( void )
+{
+  platformLedOff(PLATFORM_LED_A_PORT, PLATFORM_LED_A_PIN);
+  platformLedOff(PLATFORM_LED_B_PORT, PLATFORM_LED_B_PIN);
+  platformLedOff(PLATFORM_LED_F_PORT, PLATFORM_LED_F_PIN);
+  platformLedOff(PLATFORM_LED_V_PORT, PLATFORM_LED_V_PIN);
+  platformLedOff(PLATFORM_LED_AP2P_PORT, PLATFORM_LED_AP2P_PIN);
+  platformLedOff(PLATFORM_LED_FIELD_PORT, PLATFORM_LED_FIELD_PIN);
+  
+  /* ISO-DEP sessions do not survive the field */
+  sys_nfc_isodep_reset();
+}
+
+
 /*!
  *****************************************************************************
  * \brief Poll NFC-AP2P
@@ -323,13 +387,15 @@ bool demoPollAP2P( void )
  * \brief Poll NFC-A
  *
  * Configures the RFAL to NFC-A (ISO14443A) communication and polls for a nearby 
- * NFC-A device. 
- * If a device is found turns On a LED and logs its UID.
+ * NFC-A devices, up to SYS_NFC_ISODEP_MAX_SESSIONS. 
+ * If a device is found turns On a LED and logs their UIDs.
  *
  * Additionally, if the Device supports NFC-DEP protocol (P2P) it will activate 
  * the device and try to send an URI record.
- * If the device supports ISO-DEP protocol (ISO144443-4) it will 
- * activate the device and try exchange some APDUs with PICC.
+ * Otherwise the devices supporting ISO-DEP protocol (ISO144443-4) are all 
+ * activated, each with its own DID, and exchange some APDUs in turn.
+ * The devices are then kept for presence checks until they leave the field,
+ * they are not discovered nor served again meanwhile.
  * 
  * 
  *  \return true    : NFC-A device found
@@ -350,34 +416,39 @@ bool demoPollNFCA( void )
   err = rfalNfcaPollerTechnologyDetection( RFAL_COMPLIANCE_MODE_NFC, &sensRes );
   if(err == ERR_NONE) 
   {
-    rfalNfcaListenDevice nfcaDevList[1];
+    rfalNfcaListenDevice nfcaDevList[SYS_NFC_ISODEP_MAX_SESSIONS];
     uint8_t                   devCnt;
 
-    err = rfalNfcaPollerFullCollisionResolution( RFAL_COMPLIANCE_MODE_NFC, 1, nfcaDevList, &devCnt);
+    /* Cards seen in the last cycles are selected by their UID, the others resolved bit by bit */
+    err = sys_nfc_nfca_cache_resolve( SYS_NFC_ISODEP_MAX_SESSIONS, nfcaDevList, &devCnt );
 
     if ( (err == ERR_NONE) && (devCnt > 0) ) 
     {
       found = true;
-      devIt = 0;
       
       platformLedOn(PLATFORM_LED_A_PORT, PLATFORM_LED_A_PIN);
         
-      /* Check if it is Topaz aka T1T */
-      if( nfcaDevList[devIt].type == RFAL_NFCA_T1T ) 
-      {
-        /********************************************/
-        /* NFC-A T1T card found                     */
-        /* NFCID/UID is contained in: t1tRidRes.uid */
-        platformLog("ISO14443A/Topaz (NFC-A T1T) TAG found. UID: %s\r\n", hex2Str(nfcaDevList[devIt].ridRes.uid, RFAL_T1T_UID_LEN));
-      }
-      else
+      for( devIt = 0; devIt < devCnt; devIt++ )
       {
-        /*********************************************/
-        /* NFC-A device found                        */
-        /* NFCID/UID is contained in: nfcaDev.nfcId1 */
-        platformLog("ISO14443A/NFC-A card found. UID: %s\r\n", hex2Str(nfcaDevList[0].nfcId1, nfcaDevList[0].nfcId1Len));
+        /* Check if it is Topaz aka T1T */
+        if( nfcaDevList[devIt].type == RFAL_NFCA_T1T ) 
+        {
+          /********************************************/
+          /* NFC-A T1T card found                     */
+          /* NFCID/UID is contained in: t1tRidRes.uid */
+          platformLog("ISO14443A/Topaz (NFC-A T1T) TAG found. UID: %s\r\n", hex2Str(nfcaDevList[devIt].ridRes.uid, RFAL_T1T_UID_LEN));
+        }
+        else
+        {
+          /*********************************************/
+          /* NFC-A device found                        */
+          /* NFCID/UID is contained in: nfcaDev.nfcId1 */
+          platformLog("ISO14443A/NFC-A card found. UID: %s\r\n", hex2Str(nfcaDevList[devIt].nfcId1, nfcaDevList[devIt].nfcId1Len));
+        }
       }
-       
+      
+      /* The last device found is the one left selected */
+      devIt = (devCnt - 1);
       
       /* Check if device supports P2P/NFC-DEP */
       if( (nfcaDevList[devIt].type == RFAL_NFCA_NFCDEP) || (nfcaDevList[devIt].type == RFAL_NFCA_T4T_NFCDEP)) 
@@ -395,19 +466,23 @@ bool demoPollNFCA( void )
           demoSendNdefUri();
         }
       }
-      /* Check if device supports ISO14443-4/ISO-DEP */
-      else if (nfcaDevList[devIt].type == RFAL_NFCA_T4T)
+      else
       {
-        /* Activate the ISO14443-4 / ISO-DEP layer */
-        
-        rfalIsoDepInitialize();
-        err = rfalIsoDepPollAHandleActivation((rfalIsoDepFSxI)RFAL_ISODEP_FSDI_DEFAULT, RFAL_ISODEP_NO_DID, RFAL_BR_424, &gDevProto.isoDepDev);
-        if( err == ERR_NONE )
+        /* Activate the ISO14443-4 / ISO-DEP layer of every ISO14443-4 card, each with its own DID */
+        if( sys_nfc_isodep_activate_nfca( nfcaDevList, devCnt ) > 0U )
         {
-          platformLog("ISO14443-4/ISO-DEP layer activated. \r\n");
+          platformLog("ISO14443-4/ISO-DEP layer activated on %d card(s). \r\n", sys_nfc_isodep_count());
+          
+          /* Exchange APDUs, the cards take turns */
+          demoSendSessionAPDUs();
           
-          /* Exchange APDUs */
-          demoSendAPDUs();
+          /* Sessions stay open, the cards are checked with R(NAK) until they leave */
+          sys_nfc_presence_keep_isodep();
+        }
+        else if( (devCnt == 1U) && (nfcaDevList[devIt].type != RFAL_NFCA_T1T) )
+        {
+          /* Lone card done with, checked with WUPA until it leaves */
+          sys_nfc_presence_keep_nfca( &nfcaDevList[devIt] );
         }
       }
     }
@@ -445,7 +520,7 @@ bool demoPollNFCB( void )
   rfalFieldOnAndStartGT();      /* Turns the Field On if not already and start GT timer */
 
   
-  err = rfalNfcbPollerCollisionResolution( RFAL_COMPLIANCE_MODE_NFC, 1, &nfcbDev, &devCnt );
+  err = sys_nfc_nfcb_inventory( 1, &nfcbDev, &devCnt );
   if( (err == ERR_NONE) && (devCnt > 0) ) 
   {
     /**********************************************/
@@ -592,6 +667,7 @@ bool demoPollNFCF( void )
  *
  * Configures the RFAL to NFC-V (ISO15693) communication, polls for a nearby 
  * NFC-V device. If a device is found turns On a LED and logs its UID 
+ * It is then kept for presence checks until it leaves the field
  *  
  * 
  *  \return true    : NFC-V device found
@@ -609,6 +685,8 @@ bool demoPollNFCV( void )
   uint16_t              rcvLen;
   uint8_t               blockNum = 1;
   uint8_t               rxBuf[ 1 + DEMO_NFCV_BLOCK_LEN + RFAL_CRC_LEN ];                        /* Flags + Block Data + CRC */
+  sys_nfc_nfcv_info_t   nfcvInfo;
+  uint16_t              dumpCnt;
   //uint8_t               wrData[DEMO_NFCV_BLOCK_LEN] = { 0x11, 0x22, 0x33, 0x99 };             /* Write block example */
   
 
@@ -619,8 +697,8 @@ bool demoPollNFCV( void )
   rfalNfcvPollerInitialize();           /* Initialize for NFC-V */
   rfalFieldOnAndStartGT();              /* Turns the Field On if not already and start GT timer */
 
-  err = rfalNfcvPollerCollisionResolution(1, &nfcvDev, &devCnt);
-  if( (err == ERR_NONE) && (devCnt > 0) )
+  err = sys_nfc_nfcv_inventory(1, &nfcvDev, &devCnt);
+  if( ((err == ERR_NONE) || (err == ERR_NOMEM)) && (devCnt > 0) )
   {
     /******************************************************/
     /* NFC-V card found                                   */
@@ -662,6 +740,22 @@ bool demoPollNFCV( void )
     
 #endif
 
+    /* Dump the start of the memory, in as few Read Multiple Blocks as the tag takes */
+    err = sys_nfc_nfcv_get_info( nfcvDev.InvRes.UID, &nfcvInfo );
+    if( err == ERR_NONE )
+    {
+      dumpCnt = MIN( nfcvInfo.block_cnt, (sizeof(nfcvDump) / nfcvInfo.block_len) );
+      err = sys_nfc_nfcv_read( &nfcvInfo, 0, dumpCnt, nfcvDump, sizeof(nfcvDump) );
+      platformLog(" Read %d blocks: %s Data: %s\r\n", dumpCnt, (err != ERR_NONE) ? "FAIL": "OK", (err != ERR_NONE) ? "" : hex2Str( nfcvDump, (dumpCnt * nfcvInfo.block_len) ) );
+
+  #if 0 /* Bulk writing example: the same data written back and verified */
+      err = sys_nfc_nfcv_write( &nfcvInfo, 0, dumpCnt, nfcvDump, sizeof(nfcvDump), true );
+      platformLog(" Write %d blocks: %s\r\n", dumpCnt, (err != ERR_NONE) ? "FAIL": "OK" );
+  #endif
+    }
+
+    /* Checked with an inventory masked with its UID until it leaves */
+    sys_nfc_presence_keep_nfcv( nfcvDev.InvRes.UID );
   }
 
   return found;
@@ -789,6 +883,85 @@ void demoSendAPDUs( void )
   }
 }
 
+/*!
+ *****************************************************************************
+ * \brief Exchange APDUs with every ISO-DEP session
+ *
+ * Same APDUs as demoSendAPDUs(), exchanged with all the activated cards. 
+ * The cards take turns, one APDU each, their block numbers are kept in 
+ * between.
+ * 
+ *****************************************************************************
+ */
+static void demoSendSessionAPDUs( void )
+{
+  uint8_t session;
+  
+  for( session = 0; session < SYS_NFC_ISODEP_MAX_SESSIONS; session++ )
+  {
+    if( sys_nfc_isodep_device( session ) != NULL )
+    {
+      gSessionApdu[session].step = 0;
+      demoQueueSessionAPDU( session );
+    }
+  }
+  
+  rfalWorker();
+  while( sys_nfc_isodep_service() )
+  {
+    platformWorkerWait();
+    rfalWorker();
+  }
+}
+
+/*!
+ *****************************************************************************
+ * \brief Queue the current APDU of a session sequence
+ *
+ * \param[in]  session : session index
+ * 
+ *****************************************************************************
+ */
+static void demoQueueSessionAPDU( uint8_t session )
+{
+  sys_nfc_isodep_apdu_t *apdu = &gSessionApdu[session].apdu;
+  
+  apdu->tx      = demoApduSeq[gSessionApdu[session].step].apdu;
+  apdu->tx_len  = demoApduSeq[gSessionApdu[session].step].len;
+  apdu->rx      = gSessionApdu[session].rxBuf;
+  apdu->rx_size = sizeof(gSessionApdu[session].rxBuf);
+  apdu->cb      = demoSessionApduDone;
+  apdu->arg     = (void*)(uint32_t)session;
+  
+  sys_nfc_isodep_queue( session, apdu );
+}
+
+/*!
+ *****************************************************************************
+ * \brief Session APDU completion
+ *
+ * Logs the exchange and queues the next APDU of the sequence
+ *
+ * \param[in]  apdu : completed APDU
+ * \param[in]  arg  : session index
+ * 
+ *****************************************************************************
+ */
+static void demoSessionApduDone( sys_nfc_isodep_apdu_t *apdu, void *arg )
+{
+  uint8_t session = (uint8_t)(uint32_t)arg;
+  
+  platformLog(" ISO-DEP session %d TxRx %s: - Tx: %s Rx: %s \r\n", session, (apdu->status != ERR_NONE) ? "FAIL": "OK", hex2Str((uint8_t*)apdu->tx, apdu->tx_len), (apdu->status != ERR_NONE) ? "": hex2Str( apdu->rx, apdu->rx_len));
+  
+  if( (apdu->status == ERR_NONE) && (apdu->rx_len >= 2U) && (apdu->rx[apdu->rx_len - 2U] == 0x90) && (apdu->rx[apdu->rx_len - 1U] == 0x00) )
+  {
+    if( ++gSessionApdu[session].step < (sizeof(demoApduSeq) / sizeof(demoApduSeq[0])) )
+    {
+      demoQueueSessionAPDU( session );
+    }
+  }
+}
+
 /*!
  *****************************************************************************
  * \brief ISO-DEP Blocking Transceive 
@@ -821,6 +994,7 @@ void demoSendAPDUs( void )
 ReturnCode demoIsoDepBlockingTxRx( rfalIsoDepDevice *isoDepDev, const uint8_t *txBuf, uint16_t txBufSize, uint8_t *rxBuf, uint16_t rxBufSize, uint16_t *rxActLen )
 {
   ReturnCode               err;
+  rfalTransceiveState      state;
   rfalIsoDepApduTxRxParam  isoDepTxRx;
 
   /* Initialize the ISO-DEP protocol transceive context */
@@ -842,8 +1016,14 @@ ReturnCode demoIsoDepBlockingTxRx( rfalIsoDepDevice *isoDepDev, const uint8_t *t
   /* Perform the ISO-DEP Transceive in a blocking way */
   rfalIsoDepStartApduTransceive( isoDepTxRx );
   do {
+    state = rfalGetTransceiveState();
     rfalWorker();
     err = rfalIsoDepGetApduTransceiveStatus();
+    /* Sleep only when the worker made no progress */
+    if( (err == ERR_BUSY) && (state == rfalGetTransceiveState()) )
+    {
+      platformWorkerWait();
+    }
   } while(err == ERR_BUSY);
 
   platformLog(" ISO-DEP TxRx %s: - Tx: %s Rx: %s \r\n", (err != ERR_NONE) ? "FAIL": "OK", hex2Str((uint8_t*)txBuf, txBufSize), (err != ERR_NONE) ? "": hex2Str( isoDepTxRx.rxBuf->apdu, *rxActLen));
@@ -891,6 +1071,7 @@ ReturnCode demoNfcDepBlockingTxRx( rfalNfcDepDevice *nfcDepDev, const uint8_t *t
 {
   ReturnCode             err;
   bool                   isChaining;
+  rfalTransceiveState    state;
   rfalNfcDepTxRxParam    rfalNfcDepTxRx;
 
 
@@ -912,8 +1093,14 @@ ReturnCode demoNfcDepBlockingTxRx( rfalNfcDepDevice *nfcDepDev, const uint8_t *t
   /* Perform the NFC-DEP Transceive in a blocking way */
   rfalNfcDepStartTransceive( &rfalNfcDepTxRx );
   do {
+    state = rfalGetTransceiveState();
     rfalWorker();
     err = rfalNfcDepGetTransceiveStatus();
+    /* Sleep only when the worker made no progress */
+    if( (err == ERR_BUSY) && (state == rfalGetTransceiveState()) )
+    {
+      platformWorkerWait();
+    }
   } while(err == ERR_BUSY);
 
   //platformLog(" NFC-DEP TxRx %s: - Tx: %s Rx: %s \r\n", (err != ERR_NONE) ? "FAIL": "OK", hex2Str( (uint8_t*)rfalNfcDepTxRx.txBuf, txBufSize), (err != ERR_NONE) ? "": hex2Str( rfalNfcDepTxRx.rxBuf->inf, *rxActLen));
@@ -53,7 +53,8 @@ extern "C" {
 /* Exported macro ------------------------------------------------------------*/
 
 /* Exported functions ------------------------------------------------------- */
-extern void demoCycle(void);
+extern void demoInit(void);
+extern uint32_t demoCycle(void);
 
 #ifdef __cplusplus
 }
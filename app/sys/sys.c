@@ -14,6 +14,7 @@
 #include "platform_common.h"
 #include "bsp.h"
 #include "demo.h"
+#include "sys_nfc.h"
 
 /* Private defines ---------------------------------------------------------- */
 #define EXAMPLE_ESP_WIFI_SSID "A06.11"
@@ -57,15 +58,9 @@ void sys_boot(void)
 
   ESP_LOGI(TAG, "Init ok");
 
-  // Infinite loop
-  while (1)
-  {
-    // Run RFAL Worker
-    rfalWorker();
-
-    // Run Demo Application
-    demoCycle();
-  }
+  // RFAL Worker and Demo Application run in their own task from now on
+  demoInit();
+  ESP_ERROR_CHECK(sys_nfc_init(demoCycle));
 }
 
 void sys_run(void)
@@ -0,0 +1,392 @@
+/**
+ * @file       sys_nfc.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-02
+ * @author     Thuan Le
+ * @brief      NFC worker task, owner of the RFAL
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc.h"
+#include "sys_nfc_xfer.h"
+#include "platform.h"
+#include "rfal_rf.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define SYS_NFC_TASK_NAME     "nfc_worker"
+
+#define SYS_NFC_EVT_IRQ       BIT0    // Chip IRQ burst drained
+#define SYS_NFC_EVT_REQ       BIT1    // Request queued
+#define SYS_NFC_EVT_TMR       BIT2    // Wait timeout
+#define SYS_NFC_EVT_ALL       (SYS_NFC_EVT_IRQ | SYS_NFC_EVT_REQ | SYS_NFC_EVT_TMR)
+
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc";
+
+/* Private macros ----------------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------------- */
+typedef struct
+{
+  sys_nfc_req_fn_t fn;
+  void            *arg;
+  TaskHandle_t     waiter;    // Notified once run, NULL for fire and forget
+  sys_nfc_xfer_t  *xfer;      // Transceive to start instead of fn, NULL for none
+}
+sys_nfc_req_t;
+
+/* Private variables -------------------------------------------------------- */
+static TaskHandle_t       m_task;
+static QueueHandle_t      m_req_queue;
+static EventGroupHandle_t m_evt;
+static esp_timer_handle_t m_wait_tmr;
+static sys_nfc_cycle_fn_t m_cycle;
+static sys_nfc_xfer_t     *m_xfer;    // Transceive in flight, holds the request queue
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static void m_sys_nfc_task(void *arg);
+static void m_sys_nfc_serve_requests(void);
+static void m_sys_nfc_xfer_start(sys_nfc_xfer_t *xfer);
+static void m_sys_nfc_xfer_poll(void);
+static void m_sys_nfc_xfer_complete(ReturnCode status);
+static void m_sys_nfc_irq_cb(void);
+static void m_sys_nfc_wait_expired(void *arg);
+static void m_sys_nfc_worker_wait(void);
+
+/* Function definitions ----------------------------------------------------- */
+esp_err_t sys_nfc_init(sys_nfc_cycle_fn_t cycle)
+{
+  if (NULL != m_task)
+    return ESP_OK;
+
+  m_cycle     = cycle;
+  m_evt       = xEventGroupCreate();
+  m_req_queue = xQueueCreate(SYS_NFC_QUEUE_LEN, sizeof(sys_nfc_req_t));
+  CHECK((NULL != m_evt) && (NULL != m_req_queue), ESP_ERR_NO_MEM);
+
+  // One-shot timer gives the wait us resolution, the tick is 10 ms here
+  esp_timer_create_args_t tmr_cfg =
+  {
+    .callback        = m_sys_nfc_wait_expired,
+    .arg             = NULL,
+    .dispatch_method = ESP_TIMER_TASK,
+    .name            = "nfc_worker_wait"
+  };
+  CHECK(ESP_OK == esp_timer_create(&tmr_cfg, &m_wait_tmr), ESP_ERR_NO_MEM);
+
+  // Every drained IRQ burst wakes the worker
+  rfalSetUpperLayerCallback(m_sys_nfc_irq_cb);
+
+  // RFAL blocking calls made by the worker sleep on its events
+  bsp_nfc_worker_set_wait(m_sys_nfc_worker_wait);
+
+  xTaskCreatePinnedToCore(m_sys_nfc_task, SYS_NFC_TASK_NAME, SYS_NFC_TASK_STACK, NULL,
+                          SYS_NFC_TASK_PRIO, &m_task, SYS_NFC_TASK_CORE);
+  CHECK(NULL != m_task, ESP_ERR_NO_MEM);
+
+  ESP_LOGI(TAG, "Worker running on core %d", SYS_NFC_TASK_CORE);
+
+  return ESP_OK;
+}
+
+esp_err_t sys_nfc_submit(sys_nfc_req_fn_t fn, void *arg, bool wait)
+{
+  sys_nfc_req_t req;
+
+  CHECK(NULL != fn, ESP_ERR_INVALID_ARG);
+  CHECK(NULL != m_task, ESP_ERR_INVALID_STATE);
+
+  // The worker would wait for itself
+  if (xTaskGetCurrentTaskHandle() == m_task)
+  {
+    fn(arg);
+    return ESP_OK;
+  }
+
+  req.fn     = fn;
+  req.arg    = arg;
+  req.waiter = wait ? xTaskGetCurrentTaskHandle() : NULL;
+  req.xfer   = NULL;
+
+  if (pdTRUE != xQueueSend(m_req_queue, &req, 0))
+    return ESP_ERR_TIMEOUT;
+
+  xEventGroupSetBits(m_evt, SYS_NFC_EVT_REQ);
+
+  if (wait)
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+  return ESP_OK;
+}
+
+esp_err_t sys_nfc_xfer_submit(sys_nfc_xfer_t *xfer)
+{
+  sys_nfc_req_t req;
+
+  CHECK(NULL != xfer, ESP_ERR_INVALID_ARG);
+
+  // A rejected transceive reads as completed, a wait on it returns at once
+  xfer->status = ERR_REQUEST;
+  CHECK(NULL != m_task, ESP_ERR_INVALID_STATE);
+
+  // Ready before queued, the worker may complete it before the send returns
+  xfer->status = ERR_BUSY;
+  xfer->done   = xSemaphoreCreateBinaryStatic(&xfer->done_buf);
+
+  req.fn     = NULL;
+  req.arg    = NULL;
+  req.waiter = NULL;
+  req.xfer   = xfer;
+
+  if (pdTRUE != xQueueSend(m_req_queue, &req, 0))
+  {
+    xfer->status = ERR_REQUEST;
+    return ESP_ERR_TIMEOUT;
+  }
+
+  xEventGroupSetBits(m_evt, SYS_NFC_EVT_REQ);
+
+  return ESP_OK;
+}
+
+ReturnCode sys_nfc_xfer_wait(sys_nfc_xfer_t *xfer, TickType_t timeout)
+{
+  // The semaphore keeps a completion that happened before the wait
+  if ((ERR_BUSY == xfer->status) && (pdTRUE != xSemaphoreTake(xfer->done, timeout)))
+    return ERR_BUSY;
+
+  return xfer->status;
+}
+
+esp_err_t sys_nfc_wait(uint32_t timeout_us)
+{
+  esp_err_t err;
+
+  // Only the worker sleeps on the NFC events
+  if ((NULL == m_task) || (xTaskGetCurrentTaskHandle() != m_task))
+    return ESP_ERR_INVALID_STATE;
+
+  if (0 != timeout_us)
+  {
+    err = esp_timer_start_once(m_wait_tmr, timeout_us);
+    if (ESP_OK != err)
+      return err;
+  }
+
+  xEventGroupWaitBits(m_evt, SYS_NFC_EVT_ALL, pdTRUE, pdFALSE, portMAX_DELAY);
+
+  // Woken by an event first, a late expiry would only cause a spurious wake-up
+  if (0 != timeout_us)
+    esp_timer_stop(m_wait_tmr);
+
+  return ESP_OK;
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         NFC worker task
+ *
+ * @param[in]     <arg>         Unused
+ *
+ * @attention     Sleeps whenever there is nothing to do, never spins
+ *
+ * @return        None
+ */
+static void m_sys_nfc_task(void *arg)
+{
+  rfalTransceiveState state;
+  uint32_t            timeout_us;
+  uint32_t            cycle_us;
+
+  while (1)
+  {
+    state = rfalGetTransceiveState();
+    rfalWorker();
+
+    m_sys_nfc_xfer_poll();
+
+    m_sys_nfc_serve_requests();
+
+    // The cycle handler drives the RFAL itself, not while a transceive is in flight
+    if ((NULL != m_cycle) && (NULL == m_xfer))
+      cycle_us = m_cycle();
+    else
+      cycle_us = SYS_NFC_CYCLE_US;
+
+    // Transceive in flight: go again while it progresses, then poll its SW timers.
+    // Otherwise only the cycle handler wants a wake-up, when it asked for.
+    if ((RFAL_TXRX_STATE_IDLE != rfalGetTransceiveState()) || (NULL != m_xfer))
+    {
+      if (state != rfalGetTransceiveState())
+        continue;
+
+      timeout_us = SYS_NFC_BUSY_WAIT_US;
+    }
+    else if (NULL != m_cycle)
+    {
+      if (0 == cycle_us)
+        continue;
+
+      timeout_us = cycle_us;
+    }
+    else
+      timeout_us = 0;
+
+    // Timer not started, a tick rather than a spin
+    if (ESP_OK != sys_nfc_wait(timeout_us))
+      vTaskDelay(1);
+  }
+}
+
+/**
+ * @brief         Run every queued request
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only
+ *
+ * @return        None
+ */
+static void m_sys_nfc_serve_requests(void)
+{
+  sys_nfc_req_t req;
+
+  // A transceive in flight holds the queue, requests behind it keep their order
+  while ((NULL == m_xfer) && (pdTRUE == xQueueReceive(m_req_queue, &req, 0)))
+  {
+    if (NULL != req.xfer)
+    {
+      m_sys_nfc_xfer_start(req.xfer);
+      continue;
+    }
+
+    req.fn(req.arg);
+
+    if (NULL != req.waiter)
+      xTaskNotifyGive(req.waiter);
+  }
+}
+
+/**
+ * @brief         Start a submitted transceive
+ *
+ * @param[in]     <xfer>        Transceive
+ *
+ * @attention     Worker task context only
+ *
+ * @return        None
+ */
+static void m_sys_nfc_xfer_start(sys_nfc_xfer_t *xfer)
+{
+  ReturnCode ret;
+
+  m_xfer = xfer;
+
+  ret = rfalStartTransceive(&xfer->ctx);
+  if (ERR_NONE != ret)
+  {
+    m_sys_nfc_xfer_complete(ret);
+    return;
+  }
+
+  // First step right away, Tx does not wait for the next wake-up
+  rfalWorker();
+  m_sys_nfc_xfer_poll();
+}
+
+/**
+ * @brief         Complete the transceive in flight once the RFAL is done with it
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only
+ *
+ * @return        None
+ */
+static void m_sys_nfc_xfer_poll(void)
+{
+  ReturnCode ret;
+
+  if (NULL == m_xfer)
+    return;
+
+  ret = rfalGetTransceiveStatus();
+  if (ERR_BUSY != ret)
+    m_sys_nfc_xfer_complete(ret);
+}
+
+/**
+ * @brief         Hand the transceive in flight back to its owner
+ *
+ * @param[in]     <status>      Transceive status
+ *
+ * @attention     Worker task context only. The handler may submit the next one,
+ *                the same transceive too.
+ *
+ * @return        None
+ */
+static void m_sys_nfc_xfer_complete(ReturnCode status)
+{
+  sys_nfc_xfer_t    *xfer = m_xfer;
+  sys_nfc_xfer_cb_t cb    = xfer->cb;
+  void              *arg  = xfer->arg;
+
+  m_xfer = NULL;
+
+  // Published before the handler, it may submit the same transceive again
+  xfer->status = status;
+  xSemaphoreGive(xfer->done);
+
+  if (NULL != cb)
+    cb(xfer, status, arg);
+}
+
+/**
+ * @brief         RFAL upper layer callback, run by the NFC IRQ task
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_irq_cb(void)
+{
+  xEventGroupSetBits(m_evt, SYS_NFC_EVT_IRQ);
+}
+
+/**
+ * @brief         Wait timer expiry
+ *
+ * @param[in]     <arg>         Unused
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_wait_expired(void *arg)
+{
+  xEventGroupSetBits(m_evt, SYS_NFC_EVT_TMR);
+}
+
+/**
+ * @brief         RFAL worker wait, a transceive is busy
+ *
+ * @param[in]     None
+ *
+ * @attention     Another task running the RFAL, or the timer not started,
+ *                sleeps a tick, never spins holding the worker lock
+ *
+ * @return        None
+ */
+static void m_sys_nfc_worker_wait(void)
+{
+  if (ESP_OK != sys_nfc_wait(SYS_NFC_BUSY_WAIT_US))
+    vTaskDelay(1);
+}
+
+/* End of file -------------------------------------------------------------- */
@@ -0,0 +1,91 @@
+/**
+ * @file       sys_nfc.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-02
+ * @author     Thuan Le
+ * @brief      NFC worker task, owner of the RFAL
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_H
+#define __SYS_NFC_H
+
+/* Includes ----------------------------------------------------------- */
+#include "platform_common.h"
+
+/* Public defines ----------------------------------------------------- */
+#ifndef SYS_NFC_TASK_CORE
+#define SYS_NFC_TASK_CORE         (1)       // APP CPU, WiFi stays alone on the PRO CPU
+#endif
+#ifndef SYS_NFC_TASK_PRIO
+#define SYS_NFC_TASK_PRIO         (5)       // Above the app, below the NFC IRQ task
+#endif
+#define SYS_NFC_TASK_STACK        (6144)
+#define SYS_NFC_QUEUE_LEN         (8)
+
+#define SYS_NFC_BUSY_WAIT_US      (500)     // Transceive ongoing: SW timers (GT, FDT, missing RXE) resolution
+#define SYS_NFC_CYCLE_US          (10000)   // Cycle handler period while a transceive holds it off
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Request run by the NFC worker task
+ */
+typedef void (*sys_nfc_req_fn_t)(void *arg);
+
+/**
+ * @brief Cycle handler, run by the NFC worker task on every wake-up
+ *
+ * @return Microseconds until it wants to run again, 0 for right away
+ */
+typedef uint32_t (*sys_nfc_cycle_fn_t)(void);
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Start the NFC worker task
+ *
+ * @param[in]     <cycle>       Handler run by the task on every wake-up, NULL for none
+ *
+ * @attention     RFAL must be initialized, the task owns it from now on.
+ *                The handler may run earlier than it asked for.
+ *
+ * @return        ESP_OK on success, ESP_ERR_NO_MEM otherwise
+ */
+esp_err_t sys_nfc_init(sys_nfc_cycle_fn_t cycle);
+
+/**
+ * @brief         Submit a request to the NFC worker task
+ *
+ * @param[in]     <fn>          Request handler
+ *                <arg>         Argument passed to the handler
+ *                <wait>        Block the caller until the request has run
+ *
+ * @attention     Waiting uses the caller task notification. Called from the
+ *                worker itself the request runs inline.
+ *
+ * @return        ESP_OK on success, ESP_ERR_TIMEOUT if the queue is full,
+ *                ESP_ERR_INVALID_STATE if the task is not running
+ */
+esp_err_t sys_nfc_submit(sys_nfc_req_fn_t fn, void *arg, bool wait);
+
+/**
+ * @brief         Block the NFC worker until the next chip IRQ, request or timeout
+ *
+ * @param[in]     <timeout_us>  Timeout in microseconds, 0 waits forever
+ *
+ * @attention     May return early, callers re-check their condition.
+ *                Returns at once from another task or if the task is not running.
+ *
+ * @return        ESP_OK once woken, ESP_ERR_INVALID_STATE from another task,
+ *                error of esp_timer_start_once() otherwise, without waiting
+ */
+esp_err_t sys_nfc_wait(uint32_t timeout_us);
+
+#endif // __SYS_NFC_H
+
+/* End of file -------------------------------------------------------- */
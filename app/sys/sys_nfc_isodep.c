@@ -0,0 +1,426 @@
+/**
+ * @file       sys_nfc_isodep.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-12
+ * @author     Thuan Le
+ * @brief      ISO-DEP sessions, several cards kept active using DIDs
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc_isodep.h"
+#include "platform.h"
+#include "rfal_rf.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define SYS_NFC_ISODEP_NONE   (-1)    // No APDU in flight
+
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc_isodep";
+
+/* Private macros ----------------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------------- */
+typedef struct
+{
+  bool                   active;
+  rfalIsoDepDevice       dev;       // Activation details
+  rfalIsoDepSession      isodep;    // Block number, FWT and frame sizes between APDUs
+  sys_nfc_isodep_apdu_t *head;      // APDU queue, head in flight when the session's turn
+  sys_nfc_isodep_apdu_t *tail;
+}
+sys_nfc_isodep_session_t;
+
+/* Private variables -------------------------------------------------------- */
+static sys_nfc_isodep_session_t m_session[SYS_NFC_ISODEP_MAX_SESSIONS];
+static int8_t                   m_cur  = SYS_NFC_ISODEP_NONE;   // Session with the APDU in flight
+static uint8_t                  m_next = 0;                     // Session whose turn is next
+
+// Only one APDU is in flight at a time, the sessions share the buffers
+static rfalIsoDepApduBufFormat  m_tx_buf;
+static rfalIsoDepApduBufFormat  m_rx_buf;
+static rfalIsoDepBufFormat      m_tmp_buf;
+static uint16_t                 m_rx_len;
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static bool m_sys_nfc_isodep_start_next(void);
+static void m_sys_nfc_isodep_complete(ReturnCode status);
+static ReturnCode m_sys_nfc_isodep_resume(sys_nfc_isodep_session_t *s);
+static void m_sys_nfc_isodep_drop(sys_nfc_isodep_session_t *s);
+
+/* Function definitions ----------------------------------------------------- */
+uint8_t sys_nfc_isodep_activate_nfca(const rfalNfcaListenDevice *dev_list, uint8_t dev_cnt)
+{
+  sys_nfc_isodep_session_t *s;
+  rfalNfcaSensRes          sens_res;
+  rfalNfcaSelRes           sel_res;
+  ReturnCode               ret;
+  uint8_t                  pass;
+  uint8_t                  i;
+  uint8_t                  n;
+
+  if (NULL == dev_list)
+    return sys_nfc_isodep_count();
+
+  // The card left selected by the collision resolution first, waking the others would reset it
+  for (pass = 0; pass < 2; pass++)
+  {
+    for (i = 0; i < dev_cnt; i++)
+    {
+      if ((RFAL_NFCA_T4T != dev_list[i].type) || (dev_list[i].isSleep != (1 == pass)))
+        continue;
+
+      // A card ignoring DIDs answers every block without one, it cannot share the field
+      for (n = 0; n < SYS_NFC_ISODEP_MAX_SESSIONS; n++)
+      {
+        if (m_session[n].active && (RFAL_ISODEP_NO_DID == m_session[n].dev.info.DID))
+          return sys_nfc_isodep_count();
+      }
+
+      for (n = 0; (n < SYS_NFC_ISODEP_MAX_SESSIONS) && m_session[n].active; n++) {}
+      if (SYS_NFC_ISODEP_MAX_SESSIONS == n)
+        return SYS_NFC_ISODEP_MAX_SESSIONS;
+
+      s = &m_session[n];
+
+      if (dev_list[i].isSleep)
+      {
+        // Cards already activated may have moved the bit rate on, and ignore WUPA
+        rfalSetBitRate(RFAL_BR_106, RFAL_BR_106);
+        rfalNfcaPollerCheckPresence(RFAL_14443A_SHORTFRAME_CMD_WUPA, &sens_res);
+
+        if (ERR_NONE != rfalNfcaPollerSelect(dev_list[i].nfcId1, dev_list[i].nfcId1Len, &sel_res))
+          continue;
+      }
+
+      rfalIsoDepInitialize();
+      ret = rfalIsoDepPollAHandleActivation((rfalIsoDepFSxI)RFAL_ISODEP_FSDI_DEFAULT, (uint8_t)(n + 1),
+                                            SYS_NFC_ISODEP_MAX_BR, &s->dev);
+      if (ERR_NONE != ret)
+      {
+        ESP_LOGW(TAG, "Activation failed: %d", ret);
+        continue;
+      }
+
+      if ((RFAL_ISODEP_NO_DID == s->dev.info.DID) && (0 != sys_nfc_isodep_count()))
+      {
+        // Sent without DID, only this card takes the DESELECT
+        ESP_LOGW(TAG, "Card without DID support left out");
+        rfalIsoDepDeselect();
+        continue;
+      }
+
+      rfalIsoDepSaveSession(&s->isodep);
+      s->head   = NULL;
+      s->tail   = NULL;
+      s->active = true;
+
+      ESP_LOGI(TAG, "Session %d: DID %d, FWT %u, FSC %d", n, s->dev.info.DID,
+               (unsigned)s->dev.info.FWT, s->dev.info.FSx);
+    }
+  }
+
+  return sys_nfc_isodep_count();
+}
+
+esp_err_t sys_nfc_isodep_queue(uint8_t session, sys_nfc_isodep_apdu_t *apdu)
+{
+  sys_nfc_isodep_session_t *s;
+
+  CHECK((SYS_NFC_ISODEP_MAX_SESSIONS > session) && (NULL != apdu), ESP_ERR_INVALID_ARG);
+  CHECK(sizeof(m_tx_buf.apdu) >= apdu->tx_len, ESP_ERR_INVALID_SIZE);
+
+  s = &m_session[session];
+  CHECK(s->active, ESP_ERR_INVALID_STATE);
+
+  apdu->status = ERR_BUSY;
+  apdu->rx_len = 0;
+  apdu->next   = NULL;
+
+  if (NULL == s->tail)
+    s->head = apdu;
+  else
+    s->tail->next = apdu;
+  s->tail = apdu;
+
+  return ESP_OK;
+}
+
+bool sys_nfc_isodep_service(void)
+{
+  ReturnCode ret;
+  uint8_t    i;
+
+  if ((SYS_NFC_ISODEP_NONE == m_cur) && !m_sys_nfc_isodep_start_next())
+    return false;
+
+  if (SYS_NFC_ISODEP_NONE != m_cur)
+  {
+    ret = rfalIsoDepGetApduTransceiveStatus();
+    if (ERR_BUSY == ret)
+      return true;
+
+    m_sys_nfc_isodep_complete(ret);
+  }
+
+  for (i = 0; i < SYS_NFC_ISODEP_MAX_SESSIONS; i++)
+  {
+    if (m_session[i].active && (NULL != m_session[i].head))
+      return true;
+  }
+
+  return false;
+}
+
+void sys_nfc_isodep_close(void)
+{
+  sys_nfc_isodep_session_t *s;
+  uint8_t                  i;
+
+  // An APDU cut short leaves its card's block number unknown, it is dropped
+  if (SYS_NFC_ISODEP_NONE != m_cur)
+    m_sys_nfc_isodep_complete(ERR_LINK_LOSS);
+
+  for (i = 0; i < SYS_NFC_ISODEP_MAX_SESSIONS; i++)
+  {
+    s = &m_session[i];
+    if (!s->active)
+      continue;
+
+    if (ERR_NONE == m_sys_nfc_isodep_resume(s))
+      rfalIsoDepDeselect();
+
+    m_sys_nfc_isodep_drop(s);
+  }
+
+  rfalIsoDepInitialize();
+}
+
+void sys_nfc_isodep_reset(void)
+{
+  uint8_t i;
+
+  if (SYS_NFC_ISODEP_NONE != m_cur)
+    m_sys_nfc_isodep_complete(ERR_LINK_LOSS);
+
+  for (i = 0; i < SYS_NFC_ISODEP_MAX_SESSIONS; i++)
+    m_sys_nfc_isodep_drop(&m_session[i]);
+
+  rfalIsoDepInitialize();
+}
+
+uint8_t sys_nfc_isodep_presence(void)
+{
+  sys_nfc_isodep_session_t *s;
+  ReturnCode               ret;
+  uint8_t                  i;
+
+  // An APDU in flight proves its card is there well enough
+  if (SYS_NFC_ISODEP_NONE != m_cur)
+    return sys_nfc_isodep_count();
+
+  for (i = 0; i < SYS_NFC_ISODEP_MAX_SESSIONS; i++)
+  {
+    s = &m_session[i];
+    if (!s->active)
+      continue;
+
+    ret = m_sys_nfc_isodep_resume(s);
+    if (ERR_NONE == ret)
+      ret = rfalIsoDepPresenceCheck();
+
+    if (ERR_NONE != ret)
+    {
+      ESP_LOGI(TAG, "Session %d gone: %d", i, ret);
+      m_sys_nfc_isodep_drop(s);
+    }
+  }
+
+  return sys_nfc_isodep_count();
+}
+
+uint8_t sys_nfc_isodep_count(void)
+{
+  uint8_t cnt = 0;
+  uint8_t i;
+
+  for (i = 0; i < SYS_NFC_ISODEP_MAX_SESSIONS; i++)
+  {
+    if (m_session[i].active)
+      cnt++;
+  }
+
+  return cnt;
+}
+
+const rfalIsoDepDevice *sys_nfc_isodep_device(uint8_t session)
+{
+  if ((SYS_NFC_ISODEP_MAX_SESSIONS <= session) || !m_session[session].active)
+    return NULL;
+
+  return &m_session[session].dev;
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Start the APDU of the next session in turn
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        true if an APDU was started or completed at once
+ */
+static bool m_sys_nfc_isodep_start_next(void)
+{
+  sys_nfc_isodep_session_t *s = NULL;
+  rfalIsoDepApduTxRxParam  param;
+  sys_nfc_isodep_apdu_t    *apdu;
+  ReturnCode               ret;
+  uint8_t                  i;
+
+  for (i = 0; i < SYS_NFC_ISODEP_MAX_SESSIONS; i++)
+  {
+    s = &m_session[(m_next + i) % SYS_NFC_ISODEP_MAX_SESSIONS];
+    if (s->active && (NULL != s->head))
+      break;
+  }
+  if (SYS_NFC_ISODEP_MAX_SESSIONS == i)
+    return false;
+
+  m_cur = (int8_t)((m_next + i) % SYS_NFC_ISODEP_MAX_SESSIONS);
+  apdu  = s->head;
+
+  ret = m_sys_nfc_isodep_resume(s);
+  if (ERR_NONE != ret)
+  {
+    m_sys_nfc_isodep_complete(ret);
+    return true;
+  }
+
+  // Frame parameters come from the session, WTX only ever stretches a single block
+  param.txBuf    = &m_tx_buf;
+  param.txBufLen = apdu->tx_len;
+  param.rxBuf    = &m_rx_buf;
+  param.rxLen    = &m_rx_len;
+  param.tmpBuf   = &m_tmp_buf;
+  param.DID      = s->isodep.DID;
+  param.FWT      = s->isodep.FWT;
+  param.dFWT     = s->isodep.dFWT;
+  param.FSx      = s->isodep.FSx;
+  param.ourFSx   = s->isodep.ourFSx;
+
+  memcpy(m_tx_buf.apdu, apdu->tx, apdu->tx_len);
+  m_rx_len = 0;
+
+  ret = rfalIsoDepStartApduTransceive(param);
+  if (ERR_NONE != ret)
+    m_sys_nfc_isodep_complete(ret);
+
+  return true;
+}
+
+/**
+ * @brief         Complete the APDU in flight and pass the turn on
+ *
+ * @param[in]     <status>      APDU status
+ *
+ * @attention     The handler may queue the next APDU
+ *
+ * @return        None
+ */
+static void m_sys_nfc_isodep_complete(ReturnCode status)
+{
+  sys_nfc_isodep_session_t *s    = &m_session[m_cur];
+  sys_nfc_isodep_apdu_t    *apdu = s->head;
+
+  s->head = apdu->next;
+  if (NULL == s->head)
+    s->tail = NULL;
+
+  m_next = (uint8_t)((m_cur + 1) % SYS_NFC_ISODEP_MAX_SESSIONS);
+  m_cur  = SYS_NFC_ISODEP_NONE;
+
+  if (ERR_NONE == status)
+  {
+    apdu->rx_len = (m_rx_len > apdu->rx_size) ? apdu->rx_size : m_rx_len;
+    memcpy(apdu->rx, m_rx_buf.apdu, apdu->rx_len);
+
+    if (m_rx_len > apdu->rx_size)
+      status = ERR_NOMEM;
+
+    rfalIsoDepSaveSession(&s->isodep);
+  }
+  else
+  {
+    // ISO-DEP gave up after its retries, the card is gone or out of step
+    ESP_LOGW(TAG, "Session %d dropped: %d", (int)(s - m_session), status);
+
+    rfalIsoDepInitialize();
+    m_sys_nfc_isodep_drop(s);
+  }
+
+  apdu->status = status;
+  if (NULL != apdu->cb)
+    apdu->cb(apdu, apdu->arg);
+}
+
+/**
+ * @brief         Make a session's card the one being communicated with
+ *
+ * @param[in]     <s>           Session
+ *
+ * @attention     None
+ *
+ * @return        ReturnCode of the RFAL
+ */
+static ReturnCode m_sys_nfc_isodep_resume(sys_nfc_isodep_session_t *s)
+{
+  rfalBitRate tx_br;
+  rfalBitRate rx_br;
+  ReturnCode  ret;
+
+  ret = rfalIsoDepRestoreSession(&s->isodep);
+  if (ERR_NONE != ret)
+    return ret;
+
+  // DRI codes PCD to PICC, DSI PICC to PCD. Only reconfigured when the cards differ.
+  ret = rfalGetBitRate(&tx_br, &rx_br);
+  if ((ERR_NONE == ret) && ((tx_br != s->dev.info.DRI) || (rx_br != s->dev.info.DSI)))
+    ret = rfalSetBitRate(s->dev.info.DRI, s->dev.info.DSI);
+
+  return ret;
+}
+
+/**
+ * @brief         Close a session, its queued APDUs complete with ERR_LINK_LOSS
+ *
+ * @param[in]     <s>           Session
+ *
+ * @attention     Not for the session with the APDU in flight
+ *
+ * @return        None
+ */
+static void m_sys_nfc_isodep_drop(sys_nfc_isodep_session_t *s)
+{
+  sys_nfc_isodep_apdu_t *apdu;
+
+  s->active = false;
+
+  while (NULL != s->head)
+  {
+    apdu    = s->head;
+    s->head = apdu->next;
+
+    apdu->status = ERR_LINK_LOSS;
+    if (NULL != apdu->cb)
+      apdu->cb(apdu, apdu->arg);
+  }
+
+  s->tail = NULL;
+}
+
+/* End of file -------------------------------------------------------------- */
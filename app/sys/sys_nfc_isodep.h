@@ -0,0 +1,157 @@
+/**
+ * @file       sys_nfc_isodep.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-12
+ * @author     Thuan Le
+ * @brief      ISO-DEP sessions, several cards kept active using DIDs
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_ISODEP_H
+#define __SYS_NFC_ISODEP_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc.h"
+#include "rfal_nfca.h"
+#include "rfal_isoDep.h"
+
+/* Public defines ----------------------------------------------------- */
+#define SYS_NFC_ISODEP_MAX_SESSIONS   (4)             // Session n uses DID n + 1, RFAL_ISODEP_DID_MAX at most
+#define SYS_NFC_ISODEP_MAX_BR         (RFAL_BR_424)   // Max bit rate offered in PPS, chosen per card
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef struct sys_nfc_isodep_apdu sys_nfc_isodep_apdu_t;
+
+/**
+ * @brief APDU completion handler, run by the NFC worker task
+ */
+typedef void (*sys_nfc_isodep_cb_t)(sys_nfc_isodep_apdu_t *apdu, void *arg);
+
+/**
+ * @brief APDU exchange, owned by the session from queue to completion
+ */
+struct sys_nfc_isodep_apdu
+{
+  const uint8_t         *tx;        // Command APDU
+  uint16_t               tx_len;
+  uint8_t               *rx;        // Response APDU buffer
+  uint16_t               rx_size;
+  uint16_t               rx_len;    // Response length, valid once completed
+
+  sys_nfc_isodep_cb_t    cb;        // Completion handler, NULL for none
+  void                  *arg;       // Argument passed to the handler
+
+  ReturnCode             status;    // ERR_BUSY until completed
+  sys_nfc_isodep_apdu_t *next;      // Session queue link
+};
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Activate the ISO-DEP cards found by an NFC-A collision resolution
+ *
+ * @param[in]     <dev_list>    Devices found by rfalNfcaPollerFullCollisionResolution()
+ *                <dev_cnt>     Number of devices
+ *
+ * @attention     Worker task context only. Each T4T card gets a free session and
+ *                its DID, sleeping ones are woken up and selected first. A card
+ *                without DID support only gets a session if it is the only one.
+ *
+ * @return        Number of active sessions
+ */
+uint8_t sys_nfc_isodep_activate_nfca(const rfalNfcaListenDevice *dev_list, uint8_t dev_cnt);
+
+/**
+ * @brief         Queue an APDU on a session
+ *
+ * @param[in]     <session>     Session index
+ *                <apdu>        APDU, tx, rx, cb and arg filled in by the caller
+ *
+ * @attention     Worker task context only, completion handlers included.
+ *                apdu and its buffers must stay valid until it completes.
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG, ESP_ERR_INVALID_SIZE
+ *                if tx exceeds the APDU buffer, ESP_ERR_INVALID_STATE if the
+ *                session is not active
+ */
+esp_err_t sys_nfc_isodep_queue(uint8_t session, sys_nfc_isodep_apdu_t *apdu);
+
+/**
+ * @brief         Advance the APDU exchanges
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only, call after rfalWorker(). Sessions with
+ *                queued APDUs take turns, one APDU each. A failed APDU drops its
+ *                session, the APDUs left in its queue complete with ERR_LINK_LOSS.
+ *
+ * @return        true while APDUs are in flight or queued
+ */
+bool sys_nfc_isodep_service(void);
+
+/**
+ * @brief         Deselect every active card and close its session
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only, blocking. Queued APDUs complete
+ *                with ERR_LINK_LOSS.
+ *
+ * @return        None
+ */
+void sys_nfc_isodep_close(void);
+
+/**
+ * @brief         Forget every session without any RF exchange
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only, once the field went off. Queued APDUs
+ *                complete with ERR_LINK_LOSS.
+ *
+ * @return        None
+ */
+void sys_nfc_isodep_reset(void);
+
+/**
+ * @brief         Check that the cards of the active sessions are still in the field
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only, blocking, NFC-A mode set. One R(NAK)
+ *                round trip per card, the sessions of the cards gone are dropped.
+ *
+ * @return        Number of active sessions left
+ */
+uint8_t sys_nfc_isodep_presence(void);
+
+/**
+ * @brief         Get the number of active sessions
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        Number of active sessions
+ */
+uint8_t sys_nfc_isodep_count(void);
+
+/**
+ * @brief         Get the activation details of a session card
+ *
+ * @param[in]     <session>     Session index
+ *
+ * @attention     None
+ *
+ * @return        Device details, NULL if the session is not active
+ */
+const rfalIsoDepDevice *sys_nfc_isodep_device(uint8_t session);
+
+#endif // __SYS_NFC_ISODEP_H
+
+/* End of file -------------------------------------------------------- */
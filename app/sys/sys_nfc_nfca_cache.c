@@ -0,0 +1,390 @@
+/**
+ * @file       sys_nfc_nfca_cache.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-24
+ * @author     Thuan Le
+ * @brief      NFC-A collision resolution selecting the cards seen in the last cycles by their UID first
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc_nfca_cache.h"
+#include "platform.h"
+#include "rfal_rf.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define SYS_NFC_NFCA_CACHE_NONE       (-1)      // No remembered card left to select
+
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc_nfca_cache";
+
+/* Private macros ----------------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------------- */
+/**
+ * @brief Remembered card
+ */
+typedef struct
+{
+  uint8_t         uid[RFAL_NFCA_CASCADE_3_UID_LEN];
+  uint8_t         uid_len;
+  rfalNfcaSensRes sens_res;         // SENS_RES of the field it was found in, if sens_valid
+  bool            sens_valid;       // Every card of that field answered the same SENS_RES
+  uint32_t        seen;             // Last cycle found
+  uint32_t        tried;            // Last cycle selected
+}
+sys_nfc_nfca_cache_entry_t;
+
+/* Private variables -------------------------------------------------------- */
+static sys_nfc_nfca_cache_entry_t m_cache[SYS_NFC_NFCA_CACHE_LEN];    // Most recently seen first
+static uint8_t                    m_cnt;
+static uint32_t                   m_cycle;
+static sys_nfc_nfca_cache_stats_t m_stats;
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static ReturnCode m_sys_nfc_nfca_cache_req(rfal14443AShortFrameCmd cmd, rfalNfcaSensRes *sens_res, bool *clean);
+static ReturnCode m_sys_nfc_nfca_cache_select(rfalNfcaListenDevice *dev, rfalNfcaSensRes *sens_res, bool *clean);
+static int8_t m_sys_nfc_nfca_cache_next(const rfalNfcaSensRes *sens_res, bool clean);
+static bool m_sys_nfc_nfca_cache_found(const rfalNfcaListenDevice *dev_list, uint8_t dev_cnt, const rfalNfcaListenDevice *dev);
+static void m_sys_nfc_nfca_cache_keep(const rfalNfcaListenDevice *dev, bool clean);
+static void m_sys_nfc_nfca_cache_age(void);
+static void m_sys_nfc_nfca_cache_stats_copy(void *arg);
+
+/* Function definitions ----------------------------------------------------- */
+ReturnCode sys_nfc_nfca_cache_resolve(uint8_t dev_limit, rfalNfcaListenDevice *dev_list, uint8_t *dev_cnt)
+{
+  rfalNfcaListenDevice *dev;
+  rfalNfcaSensRes      sens_res;
+  rfalNfcaSensRes      field_sens_res;
+  ReturnCode           ret;
+  int64_t              start;
+  bool                 clean;
+  bool                 field_clean;
+  bool                 coll_pending;
+
+  if ((NULL == dev_list) || (NULL == dev_cnt) || (0 == dev_limit))
+    return ERR_PARAM;
+
+  memset(&m_stats, 0, sizeof(m_stats));
+  memset(dev_list, 0, sizeof(*dev_list) * dev_limit);
+  *dev_cnt = 0;
+
+  m_cycle++;
+  m_sys_nfc_nfca_cache_age();
+
+  start = esp_timer_get_time();
+
+  // The technology detection left the cards asleep
+  ret = m_sys_nfc_nfca_cache_req(RFAL_14443A_SHORTFRAME_CMD_WUPA, &sens_res, &clean);
+  if (ERR_NONE != ret)
+    return ret;
+
+  // No anticollision on T1T, nothing to remember
+  if (clean && rfalNfcaIsSensResT1T(&sens_res))
+    return rfalNfcaPollerFullCollisionResolution(RFAL_COMPLIANCE_MODE_NFC, dev_limit, dev_list, dev_cnt);
+
+  field_sens_res = sens_res;
+  field_clean    = clean;
+
+  while (*dev_cnt < dev_limit)
+  {
+    dev          = &dev_list[*dev_cnt];
+    dev->sensRes = sens_res;
+
+    ret = m_sys_nfc_nfca_cache_select(dev, &sens_res, &clean);
+    if (ERR_TIMEOUT == ret)
+    {
+      // The cards missed were all there was
+      ret = ERR_NONE;
+      break;
+    }
+
+    // Not seen lately, bit by bit
+    if (ERR_NOTFOUND == ret)
+    {
+      ret = rfalNfcaPollerSingleCollisionResolution(dev_limit, &coll_pending, &dev->selRes, dev->nfcId1, &dev->nfcId1Len);
+      if (ERR_NONE != ret)
+        break;
+
+      // A card found before won the anticollision again, the ones left cannot be reached
+      if (m_sys_nfc_nfca_cache_found(dev_list, *dev_cnt, dev))
+      {
+        ret = rfalNfcaPollerSleep();
+        memset(dev, 0, sizeof(*dev));
+        break;
+      }
+
+      m_stats.resolutions++;
+    }
+
+    if (ERR_NONE != ret)
+      break;
+
+    dev->type    = (rfalNfcaListenDeviceType)(dev->selRes.sak & RFAL_NFCA_SEL_RES_CONF_MASK);
+    dev->isSleep = false;
+    (*dev_cnt)++;
+
+    m_sys_nfc_nfca_cache_keep(dev, clean);
+
+    if (*dev_cnt >= dev_limit)
+      break;
+
+    // NFC mode, a card that may not be alone is put to sleep before looking for the next one
+    ret = rfalNfcaPollerSleep();
+    if (ERR_NONE != ret)
+      break;
+
+    dev->isSleep = true;
+
+    ret = m_sys_nfc_nfca_cache_req(RFAL_14443A_SHORTFRAME_CMD_REQA, &sens_res, &clean);
+
+    // The remembered cards woken from HALT went back to it with the SEL_REQ of another one
+    if ((ERR_TIMEOUT == ret) && (m_stats.misses < SYS_NFC_NFCA_CACHE_MISSES_MAX) &&
+        (SYS_NFC_NFCA_CACHE_NONE != m_sys_nfc_nfca_cache_next(&field_sens_res, field_clean)))
+      ret = m_sys_nfc_nfca_cache_req(RFAL_14443A_SHORTFRAME_CMD_WUPA, &sens_res, &clean);
+
+    if (ERR_TIMEOUT == ret)
+    {
+      ret = ERR_NONE;
+      break;
+    }
+
+    if (ERR_NONE != ret)
+      break;
+  }
+
+  m_stats.found   = *dev_cnt;
+  m_stats.cached  = m_cnt;
+  m_stats.time_us = (uint32_t)(esp_timer_get_time() - start);
+
+  ESP_LOGD(TAG, "%d cards: %d selected of %d tried, %d resolved", m_stats.found, m_stats.hits, m_stats.selects, m_stats.resolutions);
+
+  return ret;
+}
+
+esp_err_t sys_nfc_nfca_cache_stats_get(sys_nfc_nfca_cache_stats_t *stats)
+{
+  CHECK(NULL != stats, ESP_ERR_INVALID_ARG);
+
+  return sys_nfc_submit(m_sys_nfc_nfca_cache_stats_copy, stats, true);
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Send REQA or WUPA
+ *
+ * @param[in]     <cmd>         REQA or WUPA
+ *                <sens_res>    SENS_RES received
+ *                <clean>       Every card answered the same SENS_RES
+ *
+ * @attention     Several cards answering is still an answer
+ *
+ * @return        ERR_NONE if a card answered, ERR_TIMEOUT if none did, error of the RFAL otherwise
+ */
+static ReturnCode m_sys_nfc_nfca_cache_req(rfal14443AShortFrameCmd cmd, rfalNfcaSensRes *sens_res, bool *clean)
+{
+  ReturnCode ret;
+  uint16_t   rcvd_len;
+
+  ret = rfalISO14443ATransceiveShortFrame(cmd, (uint8_t *)sens_res, (uint8_t)rfalConvBytesToBits(sizeof(*sens_res)),
+                                          &rcvd_len, RFAL_NFCA_FDTMIN);
+
+  *clean = (ERR_NONE == ret) && (rfalConvBytesToBits(sizeof(*sens_res)) == rcvd_len);
+
+  if ((ERR_RF_COLLISION == ret) || (ERR_CRC == ret) || (ERR_NOMEM == ret) || (ERR_FRAMING == ret) || (ERR_PAR == ret))
+    ret = ERR_NONE;
+
+  return ret;
+}
+
+/**
+ * @brief         Select a remembered card
+ *
+ * @param[in]     <dev>         Card found, its SENS_RES set
+ *                <sens_res>    SENS_RES of the field, updated after a miss
+ *                <clean>       Every card answered the same SENS_RES, updated after a miss
+ *
+ * @attention     A SEL_REQ for a card not in the field sends the others back
+ *                to IDLE, a REQA wakes them again before the next one. The ones
+ *                woken from HALT by a WUPA go back to HALT, a WUPA wakes them
+ *                when no card answers the REQA, the cards found with them
+ *
+ * @return        ERR_NONE if one answered, ERR_NOTFOUND if none did, ERR_TIMEOUT
+ *                if no card is left after a miss, error of the RFAL otherwise
+ */
+static ReturnCode m_sys_nfc_nfca_cache_select(rfalNfcaListenDevice *dev, rfalNfcaSensRes *sens_res, bool *clean)
+{
+  sys_nfc_nfca_cache_entry_t *e;
+  ReturnCode                 ret;
+  int8_t                     idx;
+
+  while (m_stats.misses < SYS_NFC_NFCA_CACHE_MISSES_MAX)
+  {
+    idx = m_sys_nfc_nfca_cache_next(sens_res, *clean);
+    if (SYS_NFC_NFCA_CACHE_NONE == idx)
+      break;
+
+    e        = &m_cache[idx];
+    e->tried = m_cycle;
+    m_stats.selects++;
+
+    if (ERR_NONE == rfalNfcaPollerSelect(e->uid, e->uid_len, &dev->selRes))
+    {
+      memcpy(dev->nfcId1, e->uid, e->uid_len);
+      dev->nfcId1Len = e->uid_len;
+      m_stats.hits++;
+
+      return ERR_NONE;
+    }
+
+    m_stats.misses++;
+
+    ret = m_sys_nfc_nfca_cache_req(RFAL_14443A_SHORTFRAME_CMD_REQA, sens_res, clean);
+    if (ERR_TIMEOUT == ret)
+      ret = m_sys_nfc_nfca_cache_req(RFAL_14443A_SHORTFRAME_CMD_WUPA, sens_res, clean);
+
+    if (ERR_NONE != ret)
+      return ret;
+
+    dev->sensRes = *sens_res;
+  }
+
+  return ERR_NOTFOUND;
+}
+
+/**
+ * @brief         Get the next remembered card to select
+ *
+ * @param[in]     <sens_res>    SENS_RES of the field
+ *                <clean>       Every card answered the same SENS_RES
+ *
+ * @attention     Cards with another SENS_RES than a clean one cannot be in the field
+ *
+ * @return        Index in the cache, SYS_NFC_NFCA_CACHE_NONE if none left
+ */
+static int8_t m_sys_nfc_nfca_cache_next(const rfalNfcaSensRes *sens_res, bool clean)
+{
+  uint8_t i;
+
+  for (i = 0; i < m_cnt; i++)
+  {
+    if (m_cycle == m_cache[i].tried)
+      continue;
+
+    if (clean && m_cache[i].sens_valid && (0 != memcmp(&m_cache[i].sens_res, sens_res, sizeof(*sens_res))))
+      continue;
+
+    return (int8_t)i;
+  }
+
+  return SYS_NFC_NFCA_CACHE_NONE;
+}
+
+/**
+ * @brief         Check if a card was already found in this cycle
+ *
+ * @param[in]     <dev_list>    Cards found
+ *                <dev_cnt>     Number of cards found
+ *                <dev>         Card to look for
+ *
+ * @attention     A WUPA before the next card wakes the ones found too
+ *
+ * @return        true if found, false otherwise
+ */
+static bool m_sys_nfc_nfca_cache_found(const rfalNfcaListenDevice *dev_list, uint8_t dev_cnt, const rfalNfcaListenDevice *dev)
+{
+  uint8_t i;
+
+  for (i = 0; i < dev_cnt; i++)
+  {
+    if ((dev_list[i].nfcId1Len == dev->nfcId1Len) && (0 == memcmp(dev_list[i].nfcId1, dev->nfcId1, dev->nfcId1Len)))
+      return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief         Remember a card found
+ *
+ * @param[in]     <dev>         Card found
+ *                <clean>       Every card answered the SENS_RES of the card
+ *
+ * @attention     Moved first, a new card drops the least recently seen one
+ *                when the cache is full
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfca_cache_keep(const rfalNfcaListenDevice *dev, bool clean)
+{
+  sys_nfc_nfca_cache_entry_t e;
+  uint8_t                    i;
+
+  for (i = 0; i < m_cnt; i++)
+  {
+    if ((m_cache[i].uid_len == dev->nfcId1Len) && (0 == memcmp(m_cache[i].uid, dev->nfcId1, dev->nfcId1Len)))
+      break;
+  }
+
+  if (i < m_cnt)
+  {
+    e = m_cache[i];
+  }
+  else
+  {
+    memset(&e, 0, sizeof(e));
+    memcpy(e.uid, dev->nfcId1, dev->nfcId1Len);
+    e.uid_len = dev->nfcId1Len;
+
+    if (m_cnt < SYS_NFC_NFCA_CACHE_LEN)
+      m_cnt++;
+
+    i = m_cnt - 1;
+  }
+
+  e.seen  = m_cycle;
+  e.tried = m_cycle;
+
+  if (clean)
+  {
+    e.sens_res   = dev->sensRes;
+    e.sens_valid = true;
+  }
+
+  memmove(&m_cache[1], &m_cache[0], sizeof(e) * i);
+  m_cache[0] = e;
+}
+
+/**
+ * @brief         Forget the cards not seen lately
+ *
+ * @param[in]     None
+ *
+ * @attention     The cache is sorted by last seen, the old ones are at the end
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfca_cache_age(void)
+{
+  while ((0 != m_cnt) && ((m_cycle - m_cache[m_cnt - 1].seen) > SYS_NFC_NFCA_CACHE_AGE_MAX))
+    m_cnt--;
+}
+
+/**
+ * @brief         Copy the statistics, run by the NFC worker task
+ *
+ * @param[in]     <arg>         Statistics
+ *
+ * @attention     Between two collision resolutions, never halfway through one
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfca_cache_stats_copy(void *arg)
+{
+  *(sys_nfc_nfca_cache_stats_t *)arg = m_stats;
+}
+
+/* End of file -------------------------------------------------------------- */
@@ -0,0 +1,79 @@
+/**
+ * @file       sys_nfc_nfca_cache.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-24
+ * @author     Thuan Le
+ * @brief      NFC-A collision resolution selecting the cards seen in the last cycles by their UID first
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_NFCA_CACHE_H
+#define __SYS_NFC_NFCA_CACHE_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc.h"
+#include "rfal_nfca.h"
+
+/* Public defines ----------------------------------------------------- */
+#define SYS_NFC_NFCA_CACHE_LEN          (8)       // Cards remembered
+#define SYS_NFC_NFCA_CACHE_AGE_MAX      (32)      // Cycles a card is remembered without being seen
+#define SYS_NFC_NFCA_CACHE_MISSES_MAX   (2)       // SEL_REQ of remembered cards not in the field, per cycle
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Statistics of the last collision resolution, for tuning
+ */
+typedef struct
+{
+  uint8_t  selects;         // Remembered cards selected by their UID
+  uint8_t  hits;            // Of them, the ones that answered
+  uint8_t  misses;          // Of them, the ones not in the field
+  uint8_t  resolutions;     // Cards found bit by bit, new to the cache
+  uint8_t  found;           // Cards found
+  uint8_t  cached;          // Cards remembered once done
+  uint32_t time_us;         // Duration
+}
+sys_nfc_nfca_cache_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Find the NFC-A cards in the field
+ *
+ * @param[in]     <dev_limit>   Most cards to find
+ *                <dev_list>    Cards found, dev_limit entries
+ *                <dev_cnt>     Number of cards found
+ *
+ * @attention     Worker task context only, blocking, NFC-A mode and field on,
+ *                after rfalNfcaPollerTechnologyDetection() in NFC mode.
+ *                Drop-in for rfalNfcaPollerFullCollisionResolution() in NFC
+ *                mode. The cards seen in the last cycles are selected with a
+ *                single SEL_REQ per cascade level, the ones whose SENS_RES
+ *                matches first, and the bitwise anticollision is only run for
+ *                the cards left. Each remembered card not in the field costs
+ *                a SEL_REQ timeout and a SENS_REQ, an ALL_REQ too when no card
+ *                answers it, SYS_NFC_NFCA_CACHE_MISSES_MAX at most per cycle.
+ *
+ * @return        ERR_NONE on success, ERR_PARAM on bad arguments, error of the RFAL otherwise
+ */
+ReturnCode sys_nfc_nfca_cache_resolve(uint8_t dev_limit, rfalNfcaListenDevice *dev_list, uint8_t *dev_cnt);
+
+/**
+ * @brief         Get the statistics of the last collision resolution
+ *
+ * @param[in]     <stats>       Statistics
+ *
+ * @attention     Copied by the worker, blocks until a collision resolution in progress is done
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG, error of sys_nfc_submit() otherwise
+ */
+esp_err_t sys_nfc_nfca_cache_stats_get(sys_nfc_nfca_cache_stats_t *stats);
+
+#endif // __SYS_NFC_NFCA_CACHE_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,225 @@
+/**
+ * @file       sys_nfc_nfcb_inv.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-23
+ * @author     Thuan Le
+ * @brief      NFC-B slotted collision resolution with each round sized from the collisions of the last one
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc_nfcb_inv.h"
+#include "platform.h"
+#include "rfal_rf.h"
+#include "utils.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define SYS_NFC_NFCB_INV_ONE          (16U)     // One card in the estimates, 1/16 card resolution
+#define SYS_NFC_NFCB_INV_SCHOUTE      (38U)     // Cards expected in a collided slot, 2.39
+#define SYS_NFC_NFCB_INV_NONE         (-1)      // No card left awake
+
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc_nfcb_inv";
+
+/* Private macros ----------------------------------------------------------- */
+#define SYS_NFC_NFCB_INV_SLOT_CNT(n)  (1U << (uint8_t)(n))    // Slots of a number of slots identifier
+
+/* Private enumerate/structure ---------------------------------------------- */
+/* Private variables -------------------------------------------------------- */
+static uint16_t                 m_est = SYS_NFC_NFCB_INV_ONE;     // Cards found last time, 1/16 card
+static sys_nfc_nfcb_inv_stats_t m_stats;
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static rfalNfcbSlots m_sys_nfc_nfcb_inv_slots(uint16_t est);
+static bool m_sys_nfc_nfcb_inv_found(rfalNfcbListenDevice *dev_list, uint8_t dev_cnt);
+static void m_sys_nfc_nfcb_inv_stats_copy(void *arg);
+
+/* Function definitions ----------------------------------------------------- */
+ReturnCode sys_nfc_nfcb_inventory(uint8_t dev_limit, rfalNfcbListenDevice *dev_list, uint8_t *dev_cnt)
+{
+  rfalNfcbListenDevice *dev;
+  rfalNfcbSlots        slots;
+  ReturnCode           ret;
+  int64_t              start;
+  int8_t               awake = SYS_NFC_NFCB_INV_NONE;   // Found, not put to sleep yet
+  uint16_t             est   = MAX(m_est, SYS_NFC_NFCB_INV_ONE);
+  uint8_t              slot;
+  uint8_t              singles;
+  uint8_t              collisions;
+  uint8_t              empties;
+
+  if ((NULL == dev_list) || (NULL == dev_cnt) || (0 == dev_limit))
+    return ERR_PARAM;
+
+  memset(&m_stats, 0, sizeof(m_stats));
+  memset(dev_list, 0, sizeof(*dev_list) * dev_limit);
+  *dev_cnt = 0;
+
+  m_stats.estimate = (uint8_t)MIN(m_est / SYS_NFC_NFCB_INV_ONE, UINT8_MAX);
+
+  start = esp_timer_get_time();
+
+  while ((*dev_cnt < dev_limit) && (m_stats.rounds < SYS_NFC_NFCB_INV_ROUNDS_MAX))
+  {
+    slots      = m_sys_nfc_nfcb_inv_slots(est);
+    singles    = 0;
+    collisions = 0;
+    empties    = 0;
+
+    // A card left READY-DECLARED would answer the new round again
+    if (SYS_NFC_NFCB_INV_NONE != awake)
+    {
+      rfalNfcbPollerSleep(dev_list[awake].sensbRes.nfcid0);
+      dev_list[awake].isSleep = true;
+      awake = SYS_NFC_NFCB_INV_NONE;
+    }
+
+    for (slot = 0; slot < SYS_NFC_NFCB_INV_SLOT_CNT(slots); slot++)
+    {
+      dev = &dev_list[*dev_cnt];
+
+      // Slot 1 answers the request, the next ones their SLOT_MARKER
+      if (0 == slot)
+        ret = rfalNfcbPollerCheckPresence((0 == m_stats.rounds) ? RFAL_NFCB_SENS_CMD_ALLB_REQ : RFAL_NFCB_SENS_CMD_SENSB_REQ,
+                                          slots, &dev->sensbRes, &dev->sensbResLen);
+      else
+        ret = rfalNfcbPollerSlotMarker(slot, &dev->sensbRes, &dev->sensbResLen);
+
+      m_stats.slots++;
+
+      if (ERR_TIMEOUT == ret)
+      {
+        empties++;
+        continue;
+      }
+
+      // Corrupted answers are left with no length by the RFAL
+      if ((ERR_NONE == ret) && (0 != dev->sensbResLen))
+      {
+        singles++;
+
+        if (!m_sys_nfc_nfcb_inv_found(dev_list, *dev_cnt))
+          continue;
+
+        if (SYS_NFC_NFCB_INV_NONE != awake)
+        {
+          rfalNfcbPollerSleep(dev_list[awake].sensbRes.nfcid0);
+          dev_list[awake].isSleep = true;
+        }
+
+        awake = (int8_t)*dev_cnt;
+        (*dev_cnt)++;
+
+        if (*dev_cnt >= dev_limit)
+          break;
+      }
+      else if ((ERR_NONE == ret) || (ERR_RF_COLLISION == ret) || (ERR_CRC == ret) || (ERR_FRAMING == ret) || (ERR_PROTO == ret))
+      {
+        collisions++;
+      }
+      else
+      {
+        return ret;
+      }
+    }
+
+    m_stats.rounds++;
+    m_stats.singles    += singles;
+    m_stats.collisions += collisions;
+    m_stats.empties    += empties;
+
+    ESP_LOGD(TAG, "%d slots: %d singles, %d collisions, %d empty", SYS_NFC_NFCB_INV_SLOT_CNT(slots), singles, collisions, empties);
+
+    m_stats.col_pending = (0 != collisions);
+    if (!m_stats.col_pending)
+      break;
+
+    // Only the cards of the collided slots are left, 2.39 each on average
+    est = MAX(collisions * SYS_NFC_NFCB_INV_SCHOUTE, 2 * SYS_NFC_NFCB_INV_ONE);
+  }
+
+  m_stats.found   = *dev_cnt;
+  m_stats.time_us = (uint32_t)(esp_timer_get_time() - start);
+
+  if (m_stats.col_pending && (*dev_cnt < dev_limit))
+    ESP_LOGW(TAG, "Collisions left after %d rounds", m_stats.rounds);
+
+  // Next time starts from what is found, the previous estimate kept if the limit cut it short
+  if ((*dev_cnt < dev_limit) || (m_est < (*dev_cnt * SYS_NFC_NFCB_INV_ONE)))
+    m_est = *dev_cnt * SYS_NFC_NFCB_INV_ONE;
+
+  return ERR_NONE;
+}
+
+esp_err_t sys_nfc_nfcb_inv_stats_get(sys_nfc_nfcb_inv_stats_t *stats)
+{
+  CHECK(NULL != stats, ESP_ERR_INVALID_ARG);
+
+  return sys_nfc_submit(m_sys_nfc_nfcb_inv_stats_copy, stats, true);
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Get the slots of a round
+ *
+ * @param[in]     <est>         Cards estimated left, 1/16 card
+ *
+ * @attention     As many slots as cards is the most cards per slot, up to 16
+ *
+ * @return        Number of slots identifier
+ */
+static rfalNfcbSlots m_sys_nfc_nfcb_inv_slots(uint16_t est)
+{
+  uint8_t n = (uint8_t)RFAL_NFCB_SLOT_NUM_1;
+
+  // Nearest power of two, doubled past 1.5 cards per slot
+  while ((n < (uint8_t)RFAL_NFCB_SLOT_NUM_16) && (((uint32_t)est * 2) > ((uint32_t)SYS_NFC_NFCB_INV_SLOT_CNT(n) * SYS_NFC_NFCB_INV_ONE * 3)))
+    n++;
+
+  return (rfalNfcbSlots)n;
+}
+
+/**
+ * @brief         Check a SENSB_RES for a new card
+ *
+ * @param[in]     <dev_list>    Cards found, the new one last
+ *                <dev_cnt>     Number of cards found before it
+ *
+ * @attention     A card that missed its SLPB_REQ answers again
+ *
+ * @return        true if not found before
+ */
+static bool m_sys_nfc_nfcb_inv_found(rfalNfcbListenDevice *dev_list, uint8_t dev_cnt)
+{
+  uint8_t i;
+
+  for (i = 0; i < dev_cnt; i++)
+  {
+    if (0 == memcmp(dev_list[i].sensbRes.nfcid0, dev_list[dev_cnt].sensbRes.nfcid0, RFAL_NFCB_NFCID0_LEN))
+      return false;
+  }
+
+  dev_list[dev_cnt].isSleep = false;
+
+  return true;
+}
+
+/**
+ * @brief         Copy the statistics, run by the NFC worker task
+ *
+ * @param[in]     <arg>         Statistics
+ *
+ * @attention     Between two collision resolutions, never halfway through one
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcb_inv_stats_copy(void *arg)
+{
+  *(sys_nfc_nfcb_inv_stats_t *)arg = m_stats;
+}
+
+/* End of file -------------------------------------------------------------- */
@@ -0,0 +1,77 @@
+/**
+ * @file       sys_nfc_nfcb_inv.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-23
+ * @author     Thuan Le
+ * @brief      NFC-B slotted collision resolution with each round sized from the collisions of the last one
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_NFCB_INV_H
+#define __SYS_NFC_NFCB_INV_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc.h"
+#include "rfal_nfcb.h"
+
+/* Public defines ----------------------------------------------------- */
+#define SYS_NFC_NFCB_INV_ROUNDS_MAX     (16)      // Rounds before giving up on collisions that do not clear
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Statistics of the last collision resolution, for tuning
+ */
+typedef struct
+{
+  uint8_t  rounds;          // SENSB_REQ sent, ALLB_REQ included
+  uint16_t slots;           // Slots, SLOT_MARKER sent included
+  uint16_t singles;         // Slots with one valid SENSB_RES
+  uint16_t collisions;      // Slots with several answers, or a corrupted one
+  uint16_t empties;         // Slots without answer
+  uint8_t  found;           // Cards found
+  uint8_t  estimate;        // Cards estimated before the resolution
+  bool     col_pending;     // Collisions left when it stopped
+  uint32_t time_us;         // Duration
+}
+sys_nfc_nfcb_inv_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Find the NFC-B cards in the field
+ *
+ * @param[in]     <dev_limit>   Most cards to find
+ *                <dev_list>    Cards found, dev_limit entries
+ *                <dev_cnt>     Number of cards found
+ *
+ * @attention     Worker task context only, blocking, NFC-B mode and field on.
+ *                NFC Forum sequence: ALLB_REQ, then SENSB_REQ rounds, the
+ *                cards found put to sleep with SLPB_REQ but the last one.
+ *                Each round opens as many slots as cards are estimated left,
+ *                from the previous resolution for the first one and from the
+ *                collided slots for the next ones. It stops once a round
+ *                sees no collision.
+ *
+ * @return        ERR_NONE on success, ERR_PARAM on bad arguments, error of the RFAL otherwise
+ */
+ReturnCode sys_nfc_nfcb_inventory(uint8_t dev_limit, rfalNfcbListenDevice *dev_list, uint8_t *dev_cnt);
+
+/**
+ * @brief         Get the statistics of the last collision resolution
+ *
+ * @param[in]     <stats>       Statistics
+ *
+ * @attention     Copied by the worker, blocks until a collision resolution in progress is done
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG, error of sys_nfc_submit() otherwise
+ */
+esp_err_t sys_nfc_nfcb_inv_stats_get(sys_nfc_nfcb_inv_stats_t *stats);
+
+#endif // __SYS_NFC_NFCB_INV_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,627 @@
+/**
+ * @file       sys_nfc_nfcv.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-20
+ * @author     Thuan Le
+ * @brief      NFC-V memory access, Read and Write Multiple Blocks cut in the largest chunks the tag takes
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc_nfcv.h"
+#include "platform.h"
+#include "rfal_rf.h"
+#include "utils.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define SYS_NFC_NFCV_FWT_MS           (20U)                         // Response timeout, as the RFAL NFC-V commands
+#define SYS_NFC_NFCV_PROG_MS          (10U)                         // Programming time of each further block written
+#define SYS_NFC_NFCV_BLOCKS_MAX       (256U)                        // Blocks per request, one byte block count
+#define SYS_NFC_NFCV_SYSINFO_LEN_MAX  (32U)                         // Get System Information response
+#define SYS_NFC_NFCV_REQ_LEN_MAX      (2U + RFAL_NFCV_UID_LEN + 4U + SYS_NFC_NFCV_WRITE_DATA_MAX)
+#define SYS_NFC_NFCV_RES_LEN_MAX      (1U + SYS_NFC_NFCV_DATA_MAX + RFAL_CRC_LEN)
+
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc_nfcv";
+
+/* Private macros ----------------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------------- */
+/**
+ * @brief Block operation
+ */
+typedef enum
+{
+  SYS_NFC_NFCV_OP_READ,         // Read into the buffer
+  SYS_NFC_NFCV_OP_WRITE,        // Write from the buffer
+  SYS_NFC_NFCV_OP_VERIFY        // Read and compare with the buffer
+}
+sys_nfc_nfcv_op_t;
+
+/**
+ * @brief Operation run chunk by chunk
+ */
+typedef struct
+{
+  sys_nfc_nfcv_info_t *info;
+  sys_nfc_nfcv_op_t    op;
+  uint16_t             first;   // First block
+  uint8_t             *buf;     // Block data of the first block
+  sys_nfc_nfcv_perf_t *perf;
+}
+sys_nfc_nfcv_run_t;
+
+/**
+ * @brief Request and its response
+ */
+typedef struct
+{
+  uint16_t first;                             // First block
+  uint16_t cnt;                               // Number of blocks
+  uint16_t req_len;
+  uint16_t rcvd_len;                          // In bits
+  uint32_t fwt;                               // In 1/fc
+  uint8_t  req[SYS_NFC_NFCV_REQ_LEN_MAX];
+  uint8_t  res[SYS_NFC_NFCV_RES_LEN_MAX];
+}
+sys_nfc_nfcv_chunk_t;
+
+/* Private variables -------------------------------------------------------- */
+// One chunk in flight, the other one handled and built again meanwhile
+static sys_nfc_nfcv_chunk_t m_chunk[2];
+static sys_nfc_nfcv_stats_t m_stats;
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static ReturnCode m_sys_nfc_nfcv_run(sys_nfc_nfcv_run_t *run, uint16_t block_cnt);
+static bool m_sys_nfc_nfcv_done(const sys_nfc_nfcv_run_t *run, const sys_nfc_nfcv_chunk_t *c);
+static void m_sys_nfc_nfcv_parse_info(const uint8_t *res, uint16_t len, bool extended, sys_nfc_nfcv_info_t *info);
+static uint16_t *m_sys_nfc_nfcv_chunk_max(sys_nfc_nfcv_info_t *info, sys_nfc_nfcv_op_t op);
+static uint16_t m_sys_nfc_nfcv_chunk_size(sys_nfc_nfcv_info_t *info, sys_nfc_nfcv_op_t op, uint16_t left);
+static void m_sys_nfc_nfcv_build(const sys_nfc_nfcv_run_t *run, sys_nfc_nfcv_chunk_t *c, uint16_t first, uint16_t cnt);
+static ReturnCode m_sys_nfc_nfcv_start(sys_nfc_nfcv_chunk_t *c);
+static ReturnCode m_sys_nfc_nfcv_check(const sys_nfc_nfcv_run_t *run, const sys_nfc_nfcv_chunk_t *c, ReturnCode ret);
+static void m_sys_nfc_nfcv_perf_end(sys_nfc_nfcv_perf_t *perf, uint32_t bytes, int64_t start);
+static void m_sys_nfc_nfcv_stats_copy(void *arg);
+
+/* Function definitions ----------------------------------------------------- */
+ReturnCode sys_nfc_nfcv_get_info(const uint8_t uid[RFAL_NFCV_UID_LEN], sys_nfc_nfcv_info_t *info)
+{
+  uint8_t    res[SYS_NFC_NFCV_SYSINFO_LEN_MAX];
+  uint16_t   rcvd_len;
+  ReturnCode ret;
+
+  if ((NULL == uid) || (NULL == info))
+    return ERR_PARAM;
+
+  memset(info, 0, sizeof(*info));
+  memcpy(info->uid, uid, RFAL_NFCV_UID_LEN);
+
+  ret = rfalNfcvPollerGetSystemInformation(RFAL_NFCV_REQ_FLAG_DEFAULT, uid, res, sizeof(res), &rcvd_len);
+  if (ERR_NONE == ret)
+    m_sys_nfc_nfcv_parse_info(res, rcvd_len, false, info);
+
+  // 256 blocks is also what a larger tag reports, only the extended command tells
+  if ((0 == info->block_cnt) || (SYS_NFC_NFCV_BLOCKS_MAX == info->block_cnt))
+  {
+    if (ERR_NONE == rfalNfcvPollerExtendedGetSystemInformation(RFAL_NFCV_REQ_FLAG_DEFAULT, uid, RFAL_NFCV_SYSINFO_REQ_ALL,
+                                                               res, sizeof(res), &rcvd_len))
+    {
+      m_sys_nfc_nfcv_parse_info(res, rcvd_len, true, info);
+      ret = ERR_NONE;
+    }
+  }
+
+  if (ERR_NONE != ret)
+    return ret;
+
+  if ((0 == info->block_cnt) || (0 == info->block_len))
+    return ERR_NOTSUPP;
+
+  info->extended     = (info->block_cnt > SYS_NFC_NFCV_BLOCKS_MAX);
+  info->chunk_max    = m_sys_nfc_nfcv_chunk_size(info, SYS_NFC_NFCV_OP_READ, info->block_cnt);
+  info->wr_chunk_max = m_sys_nfc_nfcv_chunk_size(info, SYS_NFC_NFCV_OP_WRITE, info->block_cnt);
+
+  ESP_LOGI(TAG, "%d blocks of %d bytes, %d per read", info->block_cnt, info->block_len, info->chunk_max);
+
+  return ERR_NONE;
+}
+
+ReturnCode sys_nfc_nfcv_read(sys_nfc_nfcv_info_t *info, uint16_t first_block, uint16_t block_cnt,
+                             uint8_t *buf, uint32_t buf_size)
+{
+  sys_nfc_nfcv_run_t run;
+  ReturnCode         ret;
+  int64_t            start;
+
+  if ((NULL == info) || (NULL == buf) || (0 == info->block_len) || (0 == info->chunk_max))
+    return ERR_PARAM;
+
+  if (((uint32_t)first_block + block_cnt > info->block_cnt) || ((uint32_t)block_cnt * info->block_len > buf_size))
+    return ERR_PARAM;
+
+  memset(&m_stats.read, 0, sizeof(m_stats.read));
+
+  run.info  = info;
+  run.op    = SYS_NFC_NFCV_OP_READ;
+  run.first = first_block;
+  run.buf   = buf;
+  run.perf  = &m_stats.read;
+
+  start = esp_timer_get_time();
+  ret   = m_sys_nfc_nfcv_run(&run, block_cnt);
+  if (ERR_NONE != ret)
+    return ret;
+
+  m_sys_nfc_nfcv_perf_end(&m_stats.read, (uint32_t)block_cnt * info->block_len, start);
+
+  return ERR_NONE;
+}
+
+ReturnCode sys_nfc_nfcv_write(sys_nfc_nfcv_info_t *info, uint16_t first_block, uint16_t block_cnt,
+                              const uint8_t *data, uint32_t data_len, bool verify)
+{
+  sys_nfc_nfcv_run_t run;
+  ReturnCode         ret;
+  int64_t            start;
+
+  if ((NULL == info) || (NULL == data) || (0 == info->block_len) || (0 == info->chunk_max) || (0 == info->wr_chunk_max))
+    return ERR_PARAM;
+
+  if (((uint32_t)first_block + block_cnt > info->block_cnt) || ((uint32_t)block_cnt * info->block_len > data_len))
+    return ERR_PARAM;
+
+  memset(&m_stats.write, 0, sizeof(m_stats.write));
+
+  // Only read from, as the compare source when verifying
+  run.info  = info;
+  run.op    = SYS_NFC_NFCV_OP_WRITE;
+  run.first = first_block;
+  run.buf   = (uint8_t *)data;
+  run.perf  = &m_stats.write;
+
+  start = esp_timer_get_time();
+  ret   = m_sys_nfc_nfcv_run(&run, block_cnt);
+
+  // Read back in the large read chunks, not block by block as written
+  if ((ERR_NONE == ret) && verify)
+  {
+    run.op = SYS_NFC_NFCV_OP_VERIFY;
+    ret    = m_sys_nfc_nfcv_run(&run, block_cnt);
+  }
+
+  if (ERR_NONE != ret)
+    return ret;
+
+  m_sys_nfc_nfcv_perf_end(&m_stats.write, (uint32_t)block_cnt * info->block_len, start);
+
+  ESP_LOGI(TAG, "Wrote %d bytes in %d requests, %d B/s", m_stats.write.bytes, m_stats.write.cmds, m_stats.write.bytes_per_s);
+
+  return ERR_NONE;
+}
+
+esp_err_t sys_nfc_nfcv_stats_get(sys_nfc_nfcv_stats_t *stats)
+{
+  CHECK(NULL != stats, ESP_ERR_INVALID_ARG);
+
+  return sys_nfc_submit(m_sys_nfc_nfcv_stats_copy, stats, true);
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Run an operation chunk by chunk
+ *
+ * @param[in]     <run>         Operation
+ *                <block_cnt>   Number of blocks
+ *
+ * @attention     While the tag answers a chunk, the previous one is handled
+ *                and the next request is built
+ *
+ * @return        ERR_NONE on success, ERR_WRITE if a verification differs,
+ *                error of the RFAL otherwise
+ */
+static ReturnCode m_sys_nfc_nfcv_run(sys_nfc_nfcv_run_t *run, uint16_t block_cnt)
+{
+  sys_nfc_nfcv_chunk_t *cur;
+  sys_nfc_nfcv_chunk_t *other;
+  sys_nfc_nfcv_chunk_t *done = NULL;    // Answered, not handled yet
+  ReturnCode           ret;
+  uint16_t             left  = block_cnt;
+  uint8_t              tries = 0;
+  bool                 same  = true;
+
+  if (0 == block_cnt)
+    return ERR_NONE;
+
+  cur   = &m_chunk[0];
+  other = &m_chunk[1];
+  m_sys_nfc_nfcv_build(run, cur, run->first, m_sys_nfc_nfcv_chunk_size(run->info, run->op, left));
+
+  for (;;)
+  {
+    ret = m_sys_nfc_nfcv_start(cur);
+    if (ERR_NONE != ret)
+      return ret;
+
+    run->perf->cmds++;
+
+    if (NULL != done)
+    {
+      same = m_sys_nfc_nfcv_done(run, done);
+      done = NULL;
+    }
+
+    if (left > cur->cnt)
+      m_sys_nfc_nfcv_build(run, other, cur->first + cur->cnt,
+                           m_sys_nfc_nfcv_chunk_size(run->info, run->op, left - cur->cnt));
+
+    ret = m_sys_nfc_nfcv_check(run, cur, rfalTransceiveBlockingRx());
+
+    // The request in flight is answered before giving up
+    if (!same)
+      break;
+
+    if (ERR_NONE == ret)
+    {
+      left -= cur->cnt;
+      tries = 0;
+      done  = cur;
+
+      if (0 == left)
+        break;
+
+      cur   = other;
+      other = done;
+      continue;
+    }
+
+    run->perf->retries++;
+
+    // A refusal is the tag's limit, anything else may be the field
+    if ((ERR_REQUEST != ret) && (ERR_NOTSUPP != ret) && (++tries < SYS_NFC_NFCV_RETRIES))
+      continue;
+
+    if (cur->cnt <= 1)
+    {
+      ESP_LOGE(TAG, "Block %d failed %d", cur->first, ret);
+      return ret;
+    }
+
+    tries = 0;
+    *m_sys_nfc_nfcv_chunk_max(run->info, run->op) = cur->cnt / 2;
+    ESP_LOGW(TAG, "Block %d failed %d, %d per request", cur->first, ret, cur->cnt / 2);
+
+    m_sys_nfc_nfcv_build(run, cur, cur->first, m_sys_nfc_nfcv_chunk_size(run->info, run->op, left));
+  }
+
+  if ((NULL != done) && !m_sys_nfc_nfcv_done(run, done))
+    same = false;
+
+  if (!same)
+  {
+    ESP_LOGE(TAG, "Verification failed");
+    return ERR_WRITE;
+  }
+
+  return ERR_NONE;
+}
+
+/**
+ * @brief         Handle an answered chunk
+ *
+ * @param[in]     <run>         Operation
+ *                <c>           Chunk
+ *
+ * @attention     None
+ *
+ * @return        false if the blocks read back differ from the buffer
+ */
+static bool m_sys_nfc_nfcv_done(const sys_nfc_nfcv_run_t *run, const sys_nfc_nfcv_chunk_t *c)
+{
+  uint8_t *blocks = run->buf + (size_t)(c->first - run->first) * run->info->block_len;
+  size_t   len    = (size_t)c->cnt * run->info->block_len;
+
+  switch (run->op)
+  {
+  case SYS_NFC_NFCV_OP_READ:
+    memcpy(blocks, &c->res[1], len);
+    break;
+
+  case SYS_NFC_NFCV_OP_VERIFY:
+    return (0 == memcmp(blocks, &c->res[1], len));
+
+  default:
+    break;
+  }
+
+  return true;
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Parse a Get System Information response
+ *
+ * @param[in]     <res>         Response, with the response flags
+ *                <len>         Response length in bytes
+ *                <extended>    Extended Get System Information response
+ *                <info>        Memory information, the fields given are set
+ *
+ * @attention     Fields cut short by a truncated response are left untouched
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcv_parse_info(const uint8_t *res, uint16_t len, bool extended, sys_nfc_nfcv_info_t *info)
+{
+  uint16_t pos = 2 + RFAL_NFCV_UID_LEN;   // Response flags, info flags, UID
+  uint8_t  flags;
+
+  if (len < pos)
+    return;
+
+  flags = res[1];
+
+  if (flags & RFAL_NFCV_SYSINFO_DFSID)
+    pos++;
+
+  if (flags & RFAL_NFCV_SYSINFO_AFI)
+    pos++;
+
+  if (flags & RFAL_NFCV_SYSINFO_MEMSIZE)
+  {
+    // Number of blocks minus one, 2 bytes LSB first if extended, then block size minus one
+    if (extended)
+    {
+      if (len < (pos + 3))
+        return;
+
+      info->block_cnt = (uint16_t)(res[pos] | ((uint16_t)res[pos + 1] << 8)) + 1;
+      pos += 2;
+    }
+    else
+    {
+      if (len < (pos + 2))
+        return;
+
+      info->block_cnt = (uint16_t)res[pos] + 1;
+      pos++;
+    }
+
+    info->block_len = (res[pos] & 0x1F) + 1;
+    pos++;
+  }
+
+  if ((flags & RFAL_NFCV_SYSINFO_ICREF) && (len > pos))
+    info->ic_ref = res[pos];
+}
+
+/**
+ * @brief         Get the chunk limit the tag takes for an operation
+ *
+ * @param[in]     <info>        Memory information
+ *                <op>          Operation
+ *
+ * @attention     None
+ *
+ * @return        Limit, lowered when the tag refuses
+ */
+static uint16_t *m_sys_nfc_nfcv_chunk_max(sys_nfc_nfcv_info_t *info, sys_nfc_nfcv_op_t op)
+{
+  return (SYS_NFC_NFCV_OP_WRITE == op) ? &info->wr_chunk_max : &info->chunk_max;
+}
+
+/**
+ * @brief         Get the blocks of the next chunk
+ *
+ * @param[in]     <info>        Memory information
+ *                <op>          Operation
+ *                <left>        Blocks left
+ *
+ * @attention     The largest that fits the request or response buffer, the command and the tag
+ *
+ * @return        Number of blocks
+ */
+static uint16_t m_sys_nfc_nfcv_chunk_size(sys_nfc_nfcv_info_t *info, sys_nfc_nfcv_op_t op, uint16_t left)
+{
+  uint16_t cnt;
+  uint16_t max = *m_sys_nfc_nfcv_chunk_max(info, op);
+
+  if (SYS_NFC_NFCV_OP_WRITE == op)
+    cnt = MIN(SYS_NFC_NFCV_WRITE_DATA_MAX / info->block_len, SYS_NFC_NFCV_WRITE_BLOCKS);
+  else
+    cnt = MIN(SYS_NFC_NFCV_DATA_MAX / info->block_len, SYS_NFC_NFCV_BLOCKS_MAX);
+
+  cnt = MIN(cnt, left);
+
+  if (0 != max)
+    cnt = MIN(cnt, max);
+
+  return cnt;
+}
+
+/**
+ * @brief         Build an addressed request
+ *
+ * @param[in]     <run>         Operation
+ *                <c>           Chunk
+ *                <first>       First block
+ *                <cnt>         Number of blocks
+ *
+ * @attention     Read or Write Multiple Blocks, Write Single Block for one block.
+ *                Extended commands for 16 bits block numbers.
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcv_build(const sys_nfc_nfcv_run_t *run, sys_nfc_nfcv_chunk_t *c, uint16_t first, uint16_t cnt)
+{
+  const sys_nfc_nfcv_info_t *info  = run->info;
+  bool                       write = (SYS_NFC_NFCV_OP_WRITE == run->op);
+  uint16_t                   len   = 0;
+  uint8_t                    cmd;
+
+  c->first = first;
+  c->cnt   = cnt;
+  c->fwt   = rfalConvMsTo1fc(SYS_NFC_NFCV_FWT_MS);
+
+  if (!write)
+    cmd = info->extended ? RFAL_NFCV_CMD_EXTENDED_READ_MULTIPLE_BLOCK : RFAL_NFCV_CMD_READ_MULTIPLE_BLOCKS;
+  else if (1 == cnt)
+    cmd = info->extended ? RFAL_NFCV_CMD_EXTENDED_WRITE_SINGLE_BLOCK : RFAL_NFCV_CMD_WRITE_SINGLE_BLOCK;
+  else
+    cmd = info->extended ? RFAL_NFCV_CMD_EXTENDED_WRITE_MULTIPLE_BLOCK : RFAL_NFCV_CMD_WRITE_MULTIPLE_BLOCKS;
+
+  c->req[len++] = (uint8_t)(RFAL_NFCV_REQ_FLAG_DEFAULT | RFAL_NFCV_REQ_FLAG_ADDRESS);
+  c->req[len++] = cmd;
+
+  memcpy(&c->req[len], info->uid, RFAL_NFCV_UID_LEN);
+  len += RFAL_NFCV_UID_LEN;
+
+  // Block number, LSB first if extended
+  c->req[len++] = (uint8_t)(first & 0xFF);
+  if (info->extended)
+    c->req[len++] = (uint8_t)(first >> 8);
+
+  // Number of blocks minus one, none for a single block
+  if (!write || (cnt > 1))
+  {
+    c->req[len++] = (uint8_t)((cnt - 1) & 0xFF);
+    if (info->extended)
+      c->req[len++] = (uint8_t)((cnt - 1) >> 8);
+  }
+
+  if (write)
+  {
+    memcpy(&c->req[len], run->buf + (size_t)(first - run->first) * info->block_len, (size_t)cnt * info->block_len);
+    len += cnt * info->block_len;
+
+    // The tag answers once all the blocks are programmed
+    c->fwt = rfalConvMsTo1fc(SYS_NFC_NFCV_FWT_MS + (uint32_t)(cnt - 1) * SYS_NFC_NFCV_PROG_MS);
+  }
+
+  c->req_len = len;
+}
+
+/**
+ * @brief         Send a chunk request
+ *
+ * @param[in]     <c>           Chunk
+ *
+ * @attention     Returns once the request is sent, the response is being received
+ *
+ * @return        ERR_NONE on success, error of the RFAL otherwise
+ */
+static ReturnCode m_sys_nfc_nfcv_start(sys_nfc_nfcv_chunk_t *c)
+{
+  rfalTransceiveContext ctx;
+  rfalTransceiveState   state;
+  ReturnCode            ret;
+
+  rfalCreateByteFlagsTxRxContext(ctx, c->req, c->req_len, c->res, sizeof(c->res), &c->rcvd_len,
+                                 RFAL_TXRX_FLAGS_DEFAULT, c->fwt);
+
+  ret = rfalStartTransceive(&ctx);
+  if (ERR_NONE != ret)
+    return ret;
+
+  // The request is coded and written to the FIFO by the worker
+  do
+  {
+    state = rfalGetTransceiveState();
+    rfalWorker();
+    ret = rfalGetTransceiveStatus();
+
+    // No progress: sleep until the FIFO water level IRQ or TXE
+    if ((ERR_BUSY == ret) && (state == rfalGetTransceiveState()))
+      platformWorkerWait();
+  }
+  while (rfalIsTransceiveInTx() && (ERR_BUSY == ret));
+
+  return rfalIsTransceiveInRx() ? ERR_NONE : ret;
+}
+
+/**
+ * @brief         Check a chunk response
+ *
+ * @param[in]     <run>         Operation
+ *                <c>           Chunk
+ *                <ret>         Transceive status
+ *
+ * @attention     None
+ *
+ * @return        ERR_NONE if it holds all the blocks read or acknowledges the
+ *                write, ERR_NOTSUPP or ERR_REQUEST if the tag refused, ERR_WRITE
+ *                if it failed to program, error of the RFAL otherwise
+ */
+static ReturnCode m_sys_nfc_nfcv_check(const sys_nfc_nfcv_run_t *run, const sys_nfc_nfcv_chunk_t *c, ReturnCode ret)
+{
+  uint16_t len;
+
+  if (ERR_NONE != ret)
+    return ret;
+
+  len = rfalConvBitsToBytes(c->rcvd_len);
+  if (len < 1)
+    return ERR_PROTO;
+
+  if (c->res[0] & RFAL_NFCV_RES_FLAG_ERROR)
+  {
+    if (len < 2)
+      return ERR_PROTO;
+
+    switch (c->res[1])
+    {
+    case RFAL_NFCV_ERROR_CMD_NOT_SUPPORTED:
+    case RFAL_NFCV_ERROR_OPTION_NOT_SUPPORTED:
+      return ERR_NOTSUPP;
+
+    case RFAL_NFCV_ERROR_WRITE_FAILED:
+      return ERR_WRITE;
+
+    default:
+      return ERR_REQUEST;
+    }
+  }
+
+  if (SYS_NFC_NFCV_OP_WRITE == run->op)
+    return ERR_NONE;
+
+  if (len != (1 + (uint32_t)c->cnt * run->info->block_len))
+    return ERR_PROTO;
+
+  return ERR_NONE;
+}
+
+/**
+ * @brief         Complete the throughput of an operation
+ *
+ * @param[in]     <perf>        Throughput
+ *                <bytes>       Bytes read or written
+ *                <start>       Start time
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcv_perf_end(sys_nfc_nfcv_perf_t *perf, uint32_t bytes, int64_t start)
+{
+  perf->bytes       = bytes;
+  perf->time_us     = (uint32_t)(esp_timer_get_time() - start);
+  perf->bytes_per_s = (0 != perf->time_us) ? (uint32_t)(((uint64_t)bytes * 1000000) / perf->time_us) : 0;
+}
+
+/**
+ * @brief         Copy the statistics, run by the NFC worker task
+ *
+ * @param[in]     <arg>         Statistics
+ *
+ * @attention     Between two operations, never halfway through one
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcv_stats_copy(void *arg)
+{
+  *(sys_nfc_nfcv_stats_t *)arg = m_stats;
+}
+
+/* End of file -------------------------------------------------------------- */
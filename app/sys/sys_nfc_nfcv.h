@@ -0,0 +1,136 @@
+/**
+ * @file       sys_nfc_nfcv.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-20
+ * @author     Thuan Le
+ * @brief      NFC-V memory access, Read and Write Multiple Blocks cut in the largest chunks the tag takes
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_NFCV_H
+#define __SYS_NFC_NFCV_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc.h"
+#include "rfal_nfcv.h"
+
+/* Public defines ----------------------------------------------------- */
+#define SYS_NFC_NFCV_DATA_MAX         (252U)      // Data bytes per response, the RFAL decodes a frame of up to 255 bytes
+#define SYS_NFC_NFCV_WRITE_DATA_MAX   (128U)      // Data bytes per write request
+#define SYS_NFC_NFCV_WRITE_BLOCKS     (4U)        // Blocks per Write Multiple Blocks to start with, a common tag limit
+#define SYS_NFC_NFCV_RETRIES          (2)         // Tries of a chunk before it is halved
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Tag memory, from Get System Information
+ */
+typedef struct
+{
+  uint8_t  uid[RFAL_NFCV_UID_LEN];    // As received in the inventory
+  uint16_t block_cnt;                 // Number of blocks
+  uint8_t  block_len;                 // Block size in bytes
+  uint8_t  ic_ref;                    // IC reference, 0 if not given
+  bool     extended;                  // More than 256 blocks, extended commands
+  uint16_t chunk_max;                 // Blocks per Read Multiple Blocks, lowered when the tag refuses
+  uint16_t wr_chunk_max;              // Blocks per Write Multiple Blocks, 1 for Write Single Block
+}
+sys_nfc_nfcv_info_t;
+
+/**
+ * @brief Throughput of the last operation
+ */
+typedef struct
+{
+  uint32_t bytes;                     // Bytes read or written
+  uint32_t time_us;                   // Duration, the verification of a write included
+  uint32_t bytes_per_s;               // Throughput
+  uint16_t cmds;                      // Requests sent
+  uint16_t retries;                   // Requests sent again, refused ones included
+}
+sys_nfc_nfcv_perf_t;
+
+/**
+ * @brief Statistics
+ */
+typedef struct
+{
+  sys_nfc_nfcv_perf_t read;           // Last sys_nfc_nfcv_read()
+  sys_nfc_nfcv_perf_t write;          // Last sys_nfc_nfcv_write()
+}
+sys_nfc_nfcv_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Get the memory size of a tag
+ *
+ * @param[in]     <uid>         Tag UID, as received in the inventory
+ *                <info>        Memory information
+ *
+ * @attention     Worker task context only, blocking, NFC-V mode and field on.
+ *                Get System Information first, the extended one for tags
+ *                over 256 blocks or that do not give their size.
+ *
+ * @return        ERR_NONE on success, error of the RFAL otherwise
+ */
+ReturnCode sys_nfc_nfcv_get_info(const uint8_t uid[RFAL_NFCV_UID_LEN], sys_nfc_nfcv_info_t *info);
+
+/**
+ * @brief         Read blocks into a buffer
+ *
+ * @param[in]     <info>        Memory information, from sys_nfc_nfcv_get_info()
+ *                <first_block> First block
+ *                <block_cnt>   Number of blocks
+ *                <buf>         Output buffer
+ *                <buf_size>    Output buffer size, block_cnt blocks at least
+ *
+ * @attention     Worker task context only, blocking, NFC-V mode and field on.
+ *                A chunk that fails is tried again, then halved. The chunk size
+ *                the tag takes is kept in info for the next reads.
+ *
+ * @return        ERR_NONE on success, ERR_PARAM on a bad range or buffer,
+ *                error of the RFAL otherwise
+ */
+ReturnCode sys_nfc_nfcv_read(sys_nfc_nfcv_info_t *info, uint16_t first_block, uint16_t block_cnt,
+                             uint8_t *buf, uint32_t buf_size);
+
+/**
+ * @brief         Write blocks from a buffer
+ *
+ * @param[in]     <info>        Memory information, from sys_nfc_nfcv_get_info()
+ *                <first_block> First block
+ *                <block_cnt>   Number of blocks
+ *                <data>        Data to write
+ *                <data_len>    Data length, block_cnt blocks at least
+ *                <verify>      Read the blocks back once all are written
+ *
+ * @attention     Worker task context only, blocking, NFC-V mode and field on.
+ *                Write Multiple Blocks where the tag takes it, the next request
+ *                is built while the tag programs. A chunk that fails is tried
+ *                again, then halved down to Write Single Block.
+ *
+ * @return        ERR_NONE on success, ERR_PARAM on a bad range or buffer,
+ *                ERR_WRITE if the data read back differs, error of the RFAL otherwise
+ */
+ReturnCode sys_nfc_nfcv_write(sys_nfc_nfcv_info_t *info, uint16_t first_block, uint16_t block_cnt,
+                              const uint8_t *data, uint32_t data_len, bool verify);
+
+/**
+ * @brief         Get the statistics
+ *
+ * @param[in]     <stats>       Statistics
+ *
+ * @attention     Copied by the worker, blocks until an operation in progress is done
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG, error of sys_nfc_submit() otherwise
+ */
+esp_err_t sys_nfc_nfcv_stats_get(sys_nfc_nfcv_stats_t *stats);
+
+#endif // __SYS_NFC_NFCV_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,420 @@
+/**
+ * @file       sys_nfc_nfcv_inv.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-22
+ * @author     Thuan Le
+ * @brief      NFC-V inventory with the slot count picked from the estimated number of tags
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc_nfcv_inv.h"
+#include "platform.h"
+#include "rfal_rf.h"
+#include "utils.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define SYS_NFC_NFCV_INV_ONE          (16U)     // One tag in the estimates, 1/16 tag resolution
+#define SYS_NFC_NFCV_INV_SCHOUTE      (38U)     // Tags expected in a collided slot, 2.39
+#define SYS_NFC_NFCV_INV_SLOTS        (16U)
+#define SYS_NFC_NFCV_INV_NORES_MS     (4U)      // Slot without a full answer, FDTV,INVENT_NORES
+#define SYS_NFC_NFCV_INV_HDR_BITS     (16U)     // Response flags and DSFID before the UID
+#define SYS_NFC_NFCV_INV_RES_LEN      (10U)     // Response flags, DSFID and UID
+#define SYS_NFC_NFCV_INV_RES_BITS     (rfalConvBytesToBits(SYS_NFC_NFCV_INV_RES_LEN + RFAL_CRC_LEN))
+#define SYS_NFC_NFCV_INV_MASK16_MAX   (RFAL_NFCV_UID_LEN * 8U - 4U)   // Mask bits with 16 slots, the slot takes 4 more
+
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc_nfcv_inv";
+
+/**
+ * @brief Tags in 16 slots given the empty ones, 16 * ln(16 / empty), 0.5 for none
+ */
+static const uint16_t ZERO_ESTIMATE[SYS_NFC_NFCV_INV_SLOTS + 1] =
+{
+  887, 710, 532, 428, 355, 298, 251, 212, 177, 147, 120, 96, 74, 53, 34, 16, 0
+};
+
+/* Private macros ----------------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------------- */
+/**
+ * @brief Mask waiting to be inventoried
+ */
+typedef struct
+{
+  uint8_t  len;                         // In bits
+  uint8_t  val[RFAL_NFCV_UID_LEN];      // UID bits, LSB first
+  uint16_t est;                         // Tags estimated under it, 1/16 tag
+}
+sys_nfc_nfcv_inv_mask_t;
+
+/**
+ * @brief Inventory in progress
+ */
+typedef struct
+{
+  uint8_t               dev_limit;
+  rfalNfcvListenDevice *dev_list;
+  uint8_t              *dev_cnt;
+}
+sys_nfc_nfcv_inv_run_t;
+
+/* Private variables -------------------------------------------------------- */
+static sys_nfc_nfcv_inv_mask_t  m_queue[SYS_NFC_NFCV_INV_QUEUE_LEN];
+static uint8_t                  m_head;
+static uint8_t                  m_count;
+static uint16_t                 m_est = SYS_NFC_NFCV_INV_ONE;     // Tags found last time, 1/16 tag
+static sys_nfc_nfcv_inv_stats_t m_stats;
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static ReturnCode m_sys_nfc_nfcv_inv_round_1(sys_nfc_nfcv_inv_run_t *run, const sys_nfc_nfcv_inv_mask_t *mask);
+static ReturnCode m_sys_nfc_nfcv_inv_round_16(sys_nfc_nfcv_inv_run_t *run, const sys_nfc_nfcv_inv_mask_t *mask);
+static void m_sys_nfc_nfcv_inv_found(sys_nfc_nfcv_inv_run_t *run, const rfalNfcvInventoryRes *res);
+static void m_sys_nfc_nfcv_inv_split(const sys_nfc_nfcv_inv_mask_t *mask, const rfalNfcvInventoryRes *res,
+                                     uint16_t rcvd_len, uint8_t min_len, uint16_t est);
+static void m_sys_nfc_nfcv_inv_push(const uint8_t *val, uint8_t len, uint8_t bit, uint16_t est);
+static void m_sys_nfc_nfcv_inv_stats_copy(void *arg);
+
+/* Function definitions ----------------------------------------------------- */
+ReturnCode sys_nfc_nfcv_inventory(uint8_t dev_limit, rfalNfcvListenDevice *dev_list, uint8_t *dev_cnt)
+{
+  sys_nfc_nfcv_inv_run_t  run;
+  sys_nfc_nfcv_inv_mask_t mask;
+  ReturnCode              ret = ERR_NONE;
+  int64_t                 start;
+
+  if ((NULL == dev_list) || (NULL == dev_cnt) || (0 == dev_limit))
+    return ERR_PARAM;
+
+  memset(&m_stats, 0, sizeof(m_stats));
+  memset(dev_list, 0, sizeof(*dev_list) * dev_limit);
+  *dev_cnt = 0;
+
+  run.dev_limit = dev_limit;
+  run.dev_list  = dev_list;
+  run.dev_cnt   = dev_cnt;
+
+  // The whole UID space, with the tags found last time
+  m_head  = 0;
+  m_count = 1;
+  memset(&m_queue[0], 0, sizeof(m_queue[0]));
+  m_queue[0].est   = m_est;
+  m_stats.estimate = (uint8_t)MIN(m_est / SYS_NFC_NFCV_INV_ONE, UINT8_MAX);
+
+  start = esp_timer_get_time();
+
+  while ((0 != m_count) && (*dev_cnt < dev_limit))
+  {
+    mask   = m_queue[m_head];
+    m_head = (m_head + 1) % SYS_NFC_NFCV_INV_QUEUE_LEN;
+    m_count--;
+
+    if ((mask.est >= (SYS_NFC_NFCV_INV_SLOTS16_MIN * SYS_NFC_NFCV_INV_ONE)) && (mask.len <= SYS_NFC_NFCV_INV_MASK16_MAX))
+      ret = m_sys_nfc_nfcv_inv_round_16(&run, &mask);
+    else
+      ret = m_sys_nfc_nfcv_inv_round_1(&run, &mask);
+
+    if (ERR_NONE != ret)
+      break;
+  }
+
+  m_stats.found   = *dev_cnt;
+  m_stats.time_us = (uint32_t)(esp_timer_get_time() - start);
+
+  // Next time starts from what is found, the previous estimate kept if the limit cut it short
+  if ((*dev_cnt < dev_limit) || (m_est < (*dev_cnt * SYS_NFC_NFCV_INV_ONE)))
+    m_est = *dev_cnt * SYS_NFC_NFCV_INV_ONE;
+
+  // Tags may be left under the masks dropped, the list is not complete
+  if (0 != m_stats.overflows)
+  {
+    ESP_LOGW(TAG, "%d masks dropped", m_stats.overflows);
+    if (ERR_NONE == ret)
+      ret = ERR_NOMEM;
+  }
+
+  ESP_LOGD(TAG, "Found %d of %d estimated, %d+%d rounds, %d slots, %d us",
+           m_stats.found, m_stats.estimate, m_stats.rounds_1, m_stats.rounds_16, m_stats.slots, m_stats.time_us);
+
+  return ret;
+}
+
+esp_err_t sys_nfc_nfcv_inv_stats_get(sys_nfc_nfcv_inv_stats_t *stats)
+{
+  CHECK(NULL != stats, ESP_ERR_INVALID_ARG);
+
+  return sys_nfc_submit(m_sys_nfc_nfcv_inv_stats_copy, stats, true);
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Inventory a mask with 1 slot
+ *
+ * @param[in]     <run>         Inventory
+ *                <mask>        Mask
+ *
+ * @attention     A collision splits the mask on the first UID bit the tags differ on
+ *
+ * @return        ERR_NONE on success, error of the RFAL otherwise
+ */
+static ReturnCode m_sys_nfc_nfcv_inv_round_1(sys_nfc_nfcv_inv_run_t *run, const sys_nfc_nfcv_inv_mask_t *mask)
+{
+  rfalNfcvInventoryRes res;
+  ReturnCode           ret;
+  uint16_t             rcvd_len = 0;
+
+  m_stats.rounds_1++;
+  m_stats.slots++;
+
+  ret = rfalNfcvPollerInventory(RFAL_NFCV_NUM_SLOTS_1, mask->len, mask->val, &res, &rcvd_len);
+
+  switch (ret)
+  {
+  case ERR_TIMEOUT:
+    m_stats.empties++;
+    return ERR_NONE;
+
+  case ERR_NONE:
+    m_stats.singles++;
+    m_sys_nfc_nfcv_inv_found(run, &res);
+    return ERR_NONE;
+
+  case ERR_RF_COLLISION:
+  case ERR_CRC:
+  case ERR_FRAMING:
+  case ERR_PROTO:
+    m_stats.collisions++;
+    platformDelay(SYS_NFC_NFCV_INV_NORES_MS);
+
+    // Two tags at least, and the estimate was short: each half gets twice the mask's,
+    // repeated collisions climb to 16 slots instead of splitting one bit at a time
+    m_sys_nfc_nfcv_inv_split(mask, &res, (ERR_RF_COLLISION == ret) ? rcvd_len : 0, mask->len,
+                             (uint16_t)MIN(MAX(4U * mask->est, 2U * SYS_NFC_NFCV_INV_ONE), UINT16_MAX));
+    return ERR_NONE;
+
+  default:
+    return ret;
+  }
+}
+
+/**
+ * @brief         Inventory a mask with 16 slots
+ *
+ * @param[in]     <run>         Inventory
+ *                <mask>        Mask
+ *
+ * @attention     The tags under the mask are estimated from the singles, the
+ *                collisions and the empty slots. Each collided slot is split
+ *                with its share of the estimate.
+ *
+ * @return        ERR_NONE on success, error of the RFAL otherwise
+ */
+static ReturnCode m_sys_nfc_nfcv_inv_round_16(sys_nfc_nfcv_inv_run_t *run, const sys_nfc_nfcv_inv_mask_t *mask)
+{
+  rfalNfcvInventoryRes res[SYS_NFC_NFCV_INV_SLOTS];
+  uint16_t             rcvd_len[SYS_NFC_NFCV_INV_SLOTS];
+  bool                 collided[SYS_NFC_NFCV_INV_SLOTS];
+  sys_nfc_nfcv_inv_mask_t slot_mask;
+  ReturnCode           ret;
+  uint8_t              slot;
+  uint8_t              singles    = 0;
+  uint8_t              collisions = 0;
+  uint8_t              empties    = 0;
+  uint16_t             est;
+
+  m_stats.rounds_16++;
+
+  for (slot = 0; slot < SYS_NFC_NFCV_INV_SLOTS; slot++)
+  {
+    rcvd_len[slot] = 0;
+    collided[slot] = false;
+
+    if (0 == slot)
+      ret = rfalNfcvPollerInventory(RFAL_NFCV_NUM_SLOTS_16, mask->len, mask->val, &res[slot], &rcvd_len[slot]);
+    else
+      ret = rfalISO15693TransceiveEOFAnticollision((uint8_t *)&res[slot], sizeof(res[slot]), &rcvd_len[slot]);
+
+    m_stats.slots++;
+
+    if (ERR_TIMEOUT == ret)
+    {
+      empties++;
+      platformDelay(SYS_NFC_NFCV_INV_NORES_MS);
+    }
+    else if ((ERR_NONE == ret) && (SYS_NFC_NFCV_INV_RES_BITS == rcvd_len[slot]))
+    {
+      singles++;
+      m_sys_nfc_nfcv_inv_found(run, &res[slot]);
+    }
+    else if ((ERR_NONE == ret) || (ERR_RF_COLLISION == ret) || (ERR_CRC == ret) || (ERR_FRAMING == ret) || (ERR_PROTO == ret))
+    {
+      collisions++;
+      collided[slot] = true;
+
+      if (ERR_RF_COLLISION != ret)
+        rcvd_len[slot] = 0;
+
+      if (rcvd_len[slot] < SYS_NFC_NFCV_INV_RES_BITS)
+        platformDelay(SYS_NFC_NFCV_INV_NORES_MS);
+    }
+    else
+    {
+      return ret;
+    }
+
+    // The remaining slots are not needed, neither are the collided ones
+    if (*run->dev_cnt >= run->dev_limit)
+      break;
+  }
+
+  m_stats.singles    += singles;
+  m_stats.collisions += collisions;
+  m_stats.empties    += empties;
+
+  ESP_LOGD(TAG, "Mask %d bits: %d singles, %d collisions, %d empty", mask->len, singles, collisions, empties);
+
+  if ((0 == collisions) || (*run->dev_cnt >= run->dev_limit))
+    return ERR_NONE;
+
+  // Each collided slot holds 2.39 tags on average, more when few slots are left empty
+  est = singles * SYS_NFC_NFCV_INV_ONE + collisions * SYS_NFC_NFCV_INV_SCHOUTE;
+  est = MAX(est, ZERO_ESTIMATE[empties]);
+  est = (est > (singles * SYS_NFC_NFCV_INV_ONE)) ? (est - (singles * SYS_NFC_NFCV_INV_ONE)) / collisions : 0;
+  est = MAX(est, 2 * SYS_NFC_NFCV_INV_ONE);
+
+  for (slot = 0; slot < SYS_NFC_NFCV_INV_SLOTS; slot++)
+  {
+    if (!collided[slot])
+      continue;
+
+    // The slot number extends the mask by 4 bits
+    slot_mask     = *mask;
+    slot_mask.len = mask->len + 4;
+    slot_mask.val[mask->len / 8] &= (uint8_t)((1U << (mask->len % 8)) - 1);
+    slot_mask.val[mask->len / 8] |= (uint8_t)(slot << (mask->len % 8));
+    if ((mask->len % 8) > 4)
+      slot_mask.val[(mask->len / 8) + 1] = (uint8_t)(slot >> (8 - (mask->len % 8)));
+
+    m_sys_nfc_nfcv_inv_split(&slot_mask, &res[slot], rcvd_len[slot], slot_mask.len, est);
+  }
+
+  return ERR_NONE;
+}
+
+/**
+ * @brief         Add a tag found
+ *
+ * @param[in]     <run>         Inventory
+ *                <res>         Inventory response
+ *
+ * @attention     A tag already in the list, from a corrupted round, is not added again
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcv_inv_found(sys_nfc_nfcv_inv_run_t *run, const rfalNfcvInventoryRes *res)
+{
+  uint8_t i;
+
+  if (*run->dev_cnt >= run->dev_limit)
+    return;
+
+  for (i = 0; i < *run->dev_cnt; i++)
+  {
+    if (0 == memcmp(run->dev_list[i].InvRes.UID, res->UID, RFAL_NFCV_UID_LEN))
+      return;
+  }
+
+  run->dev_list[*run->dev_cnt].InvRes  = *res;
+  run->dev_list[*run->dev_cnt].isSleep = false;
+  (*run->dev_cnt)++;
+}
+
+/**
+ * @brief         Queue the two halves of a collided mask
+ *
+ * @param[in]     <mask>        Mask the tags collided under
+ *                <res>         Inventory response, UID bits received before the collision
+ *                <rcvd_len>    Bits received, 0 if they cannot be trusted
+ *                <min_len>     Mask bits known to be shared
+ *                <est>         Tags estimated under the mask, 1/16 tag
+ *
+ * @attention     The UID bits received before the collision are shared by all
+ *                the tags that answered, the mask is extended with them. The
+ *                next bit is the one they differ on.
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcv_inv_split(const sys_nfc_nfcv_inv_mask_t *mask, const rfalNfcvInventoryRes *res,
+                                     uint16_t rcvd_len, uint8_t min_len, uint16_t est)
+{
+  const uint8_t *val = mask->val;
+  uint8_t        len = min_len;
+
+  if (rcvd_len > (SYS_NFC_NFCV_INV_HDR_BITS + min_len))
+  {
+    val = res->UID;
+    len = (uint8_t)MIN(rcvd_len - SYS_NFC_NFCV_INV_HDR_BITS, RFAL_NFCV_UID_LEN * 8U);
+  }
+
+  // Same UID twice, nothing to split
+  if (len >= (RFAL_NFCV_UID_LEN * 8U))
+    return;
+
+  est = MAX(est / 2, SYS_NFC_NFCV_INV_ONE);
+
+  m_sys_nfc_nfcv_inv_push(val, len, 0, est);
+  m_sys_nfc_nfcv_inv_push(val, len, 1, est);
+}
+
+/**
+ * @brief         Queue a mask
+ *
+ * @param[in]     <val>         UID bits, LSB first
+ *                <len>         Bits of val kept
+ *                <bit>         Bit appended
+ *                <est>         Tags estimated under the mask, 1/16 tag
+ *
+ * @attention     Dropped and counted if the queue is full
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcv_inv_push(const uint8_t *val, uint8_t len, uint8_t bit, uint16_t est)
+{
+  sys_nfc_nfcv_inv_mask_t *mask;
+  uint8_t                  byte = len / 8;
+
+  if (m_count >= SYS_NFC_NFCV_INV_QUEUE_LEN)
+  {
+    m_stats.overflows++;
+    return;
+  }
+
+  mask = &m_queue[(m_head + m_count) % SYS_NFC_NFCV_INV_QUEUE_LEN];
+  m_count++;
+
+  memset(mask->val, 0, sizeof(mask->val));
+  memcpy(mask->val, val, byte);
+
+  mask->val[byte] = (uint8_t)((val[byte] & ((1U << (len % 8)) - 1)) | (bit << (len % 8)));
+  mask->len       = len + 1;
+  mask->est       = est;
+}
+
+/**
+ * @brief         Copy the statistics, run by the NFC worker task
+ *
+ * @param[in]     <arg>         Statistics
+ *
+ * @attention     Between two inventories, never halfway through one
+ *
+ * @return        None
+ */
+static void m_sys_nfc_nfcv_inv_stats_copy(void *arg)
+{
+  *(sys_nfc_nfcv_inv_stats_t *)arg = m_stats;
+}
+
+/* End of file -------------------------------------------------------------- */
@@ -0,0 +1,80 @@
+/**
+ * @file       sys_nfc_nfcv_inv.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-22
+ * @author     Thuan Le
+ * @brief      NFC-V inventory with the slot count picked from the estimated number of tags
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_NFCV_INV_H
+#define __SYS_NFC_NFCV_INV_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc.h"
+#include "rfal_nfcv.h"
+
+/* Public defines ----------------------------------------------------- */
+#define SYS_NFC_NFCV_INV_QUEUE_LEN      (64)      // Masks waiting to be inventoried
+#define SYS_NFC_NFCV_INV_SLOTS16_MIN    (6)       // Tags estimated under a mask from which 16 slots are cheaper than 1
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Statistics of the last inventory, for tuning
+ */
+typedef struct
+{
+  uint16_t rounds_1;        // 1 slot inventories
+  uint16_t rounds_16;       // 16 slots inventories
+  uint16_t slots;           // Slots, 1 per 1 slot inventory
+  uint16_t singles;         // Slots with one answer
+  uint16_t collisions;      // Slots with several answers, or a corrupted one
+  uint16_t empties;         // Slots without answer
+  uint16_t overflows;       // Masks dropped, the queue was full
+  uint8_t  found;           // Tags found
+  uint8_t  estimate;        // Tags estimated before the inventory
+  uint32_t time_us;         // Duration
+}
+sys_nfc_nfcv_inv_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Find the tags in the field
+ *
+ * @param[in]     <dev_limit>   Most tags to find
+ *                <dev_list>    Tags found, dev_limit entries
+ *                <dev_cnt>     Number of tags found
+ *
+ * @attention     Worker task context only, blocking, NFC-V mode and field on.
+ *                The masks to inventory are queued, not recursed into. Each
+ *                one is sent with 1 slot, then split on the first colliding
+ *                UID bit, or with 16 slots when enough tags are estimated
+ *                under it. The estimate starts from the previous inventory
+ *                and is refined by the collided and empty slots of each round,
+ *                a 1 slot collision doubles it for both halves.
+ *
+ * @return        ERR_NONE on success, ERR_PARAM on bad arguments, ERR_NOMEM if masks were
+ *                dropped and tags may be missing from the list, error of the RFAL otherwise
+ */
+ReturnCode sys_nfc_nfcv_inventory(uint8_t dev_limit, rfalNfcvListenDevice *dev_list, uint8_t *dev_cnt);
+
+/**
+ * @brief         Get the statistics of the last inventory
+ *
+ * @param[in]     <stats>       Statistics
+ *
+ * @attention     Copied by the worker, blocks until an inventory in progress is done
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG, error of sys_nfc_submit() otherwise
+ */
+esp_err_t sys_nfc_nfcv_inv_stats_get(sys_nfc_nfcv_inv_stats_t *stats);
+
+#endif // __SYS_NFC_NFCV_INV_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,425 @@
+/**
+ * @file       sys_nfc_poll.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-14
+ * @author     Thuan Le
+ * @brief      Poll scheduler learning which technologies show up
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc_poll.h"
+#include "sys_nfc_presence.h"
+#include "platform.h"
+#include "rfal_rf.h"
+
+/* Private defines ---------------------------------------------------------- */
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc_poll";
+
+/* Private macros ----------------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------------- */
+typedef enum
+{
+  SYS_NFC_POLL_ST_IDLE,           // Field off, waiting for the next round
+  SYS_NFC_POLL_ST_ACTIVE,         // AP2P
+  SYS_NFC_POLL_ST_FIELD_RESET,    // Field off after AP2P
+  SYS_NFC_POLL_ST_PASSIVE         // Passive technologies, best score first
+}
+sys_nfc_poll_state_t;
+
+typedef struct
+{
+  sys_nfc_poll_tech_t   tech;
+  sys_nfc_poll_stats_t *stats;
+}
+sys_nfc_poll_stats_req_t;
+
+/* Private variables -------------------------------------------------------- */
+static sys_nfc_poll_fn_t     m_poll[SYS_NFC_POLL_TECH_MAX];
+static void                  (*m_field_off)(void);
+static sys_nfc_poll_policy_t m_policy = SYS_NFC_POLL_POLICY_DEFAULT;
+static sys_nfc_poll_stats_t  m_stats[SYS_NFC_POLL_TECH_MAX];
+
+static sys_nfc_poll_state_t  m_state;
+static uint32_t              m_round;
+static int64_t               m_round_start;
+static int64_t               m_due;                                 // IDLE and FIELD_RESET end
+static uint8_t               m_order[SYS_NFC_POLL_TECH_MAX];        // Passive technologies of the round
+static uint8_t               m_order_len;
+static uint8_t               m_pos;
+static bool                  m_found = true;                        // Last round found a device
+static bool                  m_round_found;
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static void m_sys_nfc_poll_round_start(void);
+static void m_sys_nfc_poll_round_end(void);
+static bool m_sys_nfc_poll_presence(void);
+static void m_sys_nfc_poll_field_reset(void);
+static bool m_sys_nfc_poll_is_due(sys_nfc_poll_tech_t tech);
+static void m_sys_nfc_poll_run(sys_nfc_poll_tech_t tech);
+static void m_sys_nfc_poll_policy_apply(void *arg);
+static void m_sys_nfc_poll_policy_copy(void *arg);
+static void m_sys_nfc_poll_stats_copy(void *arg);
+
+/* Function definitions ----------------------------------------------------- */
+void sys_nfc_poll_init(const sys_nfc_poll_fn_t poll[SYS_NFC_POLL_TECH_MAX], void (*field_off)(void))
+{
+  uint8_t i;
+
+  for (i = 0; i < SYS_NFC_POLL_TECH_MAX; i++)
+  {
+    m_poll[i] = poll[i];
+
+    // Every technology starts present, those never seen fall back to the duty cycle
+    memset(&m_stats[i], 0, sizeof(m_stats[i]));
+    m_stats[i].score   = m_policy.hit_score;
+    m_stats[i].present = (m_stats[i].score >= m_policy.present_score);
+  }
+
+  m_field_off = field_off;
+  m_state     = SYS_NFC_POLL_ST_IDLE;
+  m_round     = 0;
+  m_due       = 0;
+  m_found     = true;
+}
+
+uint32_t sys_nfc_poll_cycle(void)
+{
+  int64_t now = esp_timer_get_time();
+
+  switch (m_state)
+  {
+  case SYS_NFC_POLL_ST_IDLE:
+    if (now < m_due)
+      return (uint32_t)(m_due - now);
+
+    // A kept device answering in one round trip spares the discovery
+    if (SYS_NFC_PRESENCE_NONE != sys_nfc_presence_kind())
+    {
+      if (m_sys_nfc_poll_presence())
+      {
+        m_due = esp_timer_get_time() + m_policy.presence_us;
+        return m_policy.presence_us;
+      }
+
+      // Gone, the cards left in the field start the discovery from a reset
+      m_sys_nfc_poll_field_reset();
+      return m_policy.field_off_us;
+    }
+
+    m_sys_nfc_poll_round_start();
+    m_state = SYS_NFC_POLL_ST_ACTIVE;
+    // fall through
+
+  case SYS_NFC_POLL_ST_ACTIVE:
+    m_pos   = 0;
+    m_state = SYS_NFC_POLL_ST_PASSIVE;
+
+    if (m_sys_nfc_poll_is_due(SYS_NFC_POLL_TECH_AP2P))
+    {
+      // AP2P turns its own field off, the passive technologies wait for the cards to reset
+      m_sys_nfc_poll_run(SYS_NFC_POLL_TECH_AP2P);
+      rfalFieldOff();
+
+      m_due   = esp_timer_get_time() + m_policy.field_off_us;
+      m_state = SYS_NFC_POLL_ST_FIELD_RESET;
+      return m_policy.field_off_us;
+    }
+    return 0;
+
+  case SYS_NFC_POLL_ST_FIELD_RESET:
+    if (now < m_due)
+      return (uint32_t)(m_due - now);
+
+    m_state = SYS_NFC_POLL_ST_PASSIVE;
+    // fall through
+
+  case SYS_NFC_POLL_ST_PASSIVE:
+    // One technology per step, requests and IRQs are served in between. GTs are applied by the RFAL.
+    if (m_pos < m_order_len)
+    {
+      m_sys_nfc_poll_run((sys_nfc_poll_tech_t)m_order[m_pos++]);
+      return 0;
+    }
+
+    m_sys_nfc_poll_round_end();
+    m_state = SYS_NFC_POLL_ST_IDLE;
+
+    now = esp_timer_get_time();
+    return (m_due > now) ? (uint32_t)(m_due - now) : 0;
+
+  default:
+    m_state = SYS_NFC_POLL_ST_IDLE;
+    return 0;
+  }
+}
+
+void sys_nfc_poll_trigger(void)
+{
+  if (SYS_NFC_POLL_ST_IDLE == m_state)
+    m_due = 0;
+}
+
+bool sys_nfc_poll_is_idle(void)
+{
+  return (SYS_NFC_POLL_ST_IDLE == m_state);
+}
+
+bool sys_nfc_poll_round_found(void)
+{
+  return m_found;
+}
+
+esp_err_t sys_nfc_poll_policy_set(const sys_nfc_poll_policy_t *policy)
+{
+  CHECK(NULL != policy, ESP_ERR_INVALID_ARG);
+  CHECK((0 != policy->absent_every) && (16 > policy->decay_shift) && (0 != policy->presence_us), ESP_ERR_INVALID_ARG);
+
+  return sys_nfc_submit(m_sys_nfc_poll_policy_apply, (void *)policy, true);
+}
+
+esp_err_t sys_nfc_poll_policy_get(sys_nfc_poll_policy_t *policy)
+{
+  CHECK(NULL != policy, ESP_ERR_INVALID_ARG);
+
+  return sys_nfc_submit(m_sys_nfc_poll_policy_copy, policy, true);
+}
+
+esp_err_t sys_nfc_poll_stats_get(sys_nfc_poll_tech_t tech, sys_nfc_poll_stats_t *stats)
+{
+  sys_nfc_poll_stats_req_t req = { .tech = tech, .stats = stats };
+
+  CHECK((SYS_NFC_POLL_TECH_MAX > tech) && (NULL != stats), ESP_ERR_INVALID_ARG);
+
+  return sys_nfc_submit(m_sys_nfc_poll_stats_copy, &req, true);
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Pick and order the passive technologies of the new round
+ *
+ * @param[in]     None
+ *
+ * @attention     Highest score first, default order on a tie
+ *
+ * @return        None
+ */
+static void m_sys_nfc_poll_round_start(void)
+{
+  uint8_t tech;
+  uint8_t i;
+
+  m_round++;
+  m_round_start = esp_timer_get_time();
+  m_order_len   = 0;
+  m_round_found = false;
+
+  for (tech = SYS_NFC_POLL_TECH_NFCA; tech < SYS_NFC_POLL_TECH_MAX; tech++)
+  {
+    if (!m_sys_nfc_poll_is_due((sys_nfc_poll_tech_t)tech))
+      continue;
+
+    // Insertion sort, the list is a handful long
+    for (i = m_order_len; (i > 0) && (m_stats[m_order[i - 1]].score < m_stats[tech].score); i--)
+      m_order[i] = m_order[i - 1];
+
+    m_order[i] = tech;
+    m_order_len++;
+  }
+}
+
+/**
+ * @brief         Close the round: scores decayed, field off and next round due unless a device is kept
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_poll_round_end(void)
+{
+  uint16_t dec;
+  uint8_t  i;
+
+  m_found = m_round_found;
+
+  for (i = 0; i < SYS_NFC_POLL_TECH_MAX; i++)
+  {
+    // At least 1 so that a score always gets back to 0
+    dec = m_stats[i].score >> m_policy.decay_shift;
+    if ((0 == dec) && (0 != m_stats[i].score))
+      dec = 1;
+
+    m_stats[i].score  -= dec;
+    m_stats[i].present = (m_stats[i].score >= m_policy.present_score);
+  }
+
+  // A kept device needs the field, presence checks take over from the rounds
+  if (SYS_NFC_PRESENCE_NONE != sys_nfc_presence_kind())
+  {
+    m_due = esp_timer_get_time() + m_policy.presence_us;
+    return;
+  }
+
+  rfalFieldOff();
+
+  if (NULL != m_field_off)
+    m_field_off();
+
+  // Round period from the round start, a long round still gives the cards their reset
+  m_due = m_round_start + m_policy.round_us;
+  if (m_due < (esp_timer_get_time() + m_policy.field_off_us))
+    m_due = esp_timer_get_time() + m_policy.field_off_us;
+}
+
+/**
+ * @brief         Check the kept device and learn from the outcome
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        true if still there
+ */
+static bool m_sys_nfc_poll_presence(void)
+{
+  sys_nfc_poll_stats_t *stats = &m_stats[sys_nfc_presence_tech()];
+  int64_t              start  = esp_timer_get_time();
+  bool                 present;
+
+  stats->polls++;
+
+  // A loss leaves the last outcome found, the discovery round that follows tells
+  present = sys_nfc_presence_check();
+  if (present)
+  {
+    stats->hits++;
+    stats->score = (stats->score > (UINT16_MAX - m_policy.hit_score)) ? UINT16_MAX : (stats->score + m_policy.hit_score);
+  }
+
+  stats->last_us = (uint32_t)(esp_timer_get_time() - start);
+
+  return present;
+}
+
+/**
+ * @brief         Turn the field off and wait for the cards to reset before the next round
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_poll_field_reset(void)
+{
+  rfalFieldOff();
+
+  if (NULL != m_field_off)
+    m_field_off();
+
+  m_due = esp_timer_get_time() + m_policy.field_off_us;
+}
+
+/**
+ * @brief         Check whether a technology is polled this round
+ *
+ * @param[in]     <tech>        Technology
+ *
+ * @attention     None
+ *
+ * @return        true if polled this round
+ */
+static bool m_sys_nfc_poll_is_due(sys_nfc_poll_tech_t tech)
+{
+  if ((NULL == m_poll[tech]) || (0 == (m_policy.tech_mask & (1U << tech))))
+    return false;
+
+  if (m_stats[tech].score >= m_policy.present_score)
+    return true;
+
+  return (0 == (m_round % m_policy.absent_every));
+}
+
+/**
+ * @brief         Poll a technology and learn from the outcome
+ *
+ * @param[in]     <tech>        Technology
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_poll_run(sys_nfc_poll_tech_t tech)
+{
+  sys_nfc_poll_stats_t *stats = &m_stats[tech];
+  int64_t              start  = esp_timer_get_time();
+
+  stats->polls++;
+
+  if (m_poll[tech]())
+  {
+    stats->hits++;
+    m_round_found = true;
+    stats->score = (stats->score > (UINT16_MAX - m_policy.hit_score)) ? UINT16_MAX : (stats->score + m_policy.hit_score);
+  }
+
+  stats->last_us = (uint32_t)(esp_timer_get_time() - start);
+}
+
+/**
+ * @brief         Apply a policy, run by the NFC worker task
+ *
+ * @param[in]     <arg>         Policy
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_poll_policy_apply(void *arg)
+{
+  uint8_t i;
+
+  m_policy = *(const sys_nfc_poll_policy_t *)arg;
+
+  for (i = 0; i < SYS_NFC_POLL_TECH_MAX; i++)
+    m_stats[i].present = (m_stats[i].score >= m_policy.present_score);
+}
+
+/**
+ * @brief         Copy the policy, run by the NFC worker task
+ *
+ * @param[in]     <arg>         Destination
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_poll_policy_copy(void *arg)
+{
+  *(sys_nfc_poll_policy_t *)arg = m_policy;
+}
+
+/**
+ * @brief         Copy the statistics of a technology, run by the NFC worker task
+ *
+ * @param[in]     <arg>         Statistics request
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static void m_sys_nfc_poll_stats_copy(void *arg)
+{
+  sys_nfc_poll_stats_req_t *req = arg;
+
+  *req->stats = m_stats[req->tech];
+}
+
+/* End of file -------------------------------------------------------------- */
@@ -0,0 +1,199 @@
+/**
+ * @file       sys_nfc_poll.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-14
+ * @author     Thuan Le
+ * @brief      Poll scheduler learning which technologies show up
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_POLL_H
+#define __SYS_NFC_POLL_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc.h"
+
+/* Public defines ----------------------------------------------------- */
+#define SYS_NFC_POLL_FIELD_OFF_US     (5100)    // Field off long enough to reset any card
+
+/**
+ * @brief Default policy: present technologies polled every 50 ms, absent ones every 4th round,
+ *        a kept device checked every 20 ms
+ */
+#define SYS_NFC_POLL_POLICY_DEFAULT                   \
+  {                                                   \
+    .round_us      = 50000,                           \
+    .presence_us   = 20000,                           \
+    .field_off_us  = SYS_NFC_POLL_FIELD_OFF_US,       \
+    .hit_score     = 256,                             \
+    .present_score = 64,                              \
+    .decay_shift   = 5,                               \
+    .absent_every  = 4,                               \
+    .tech_mask     = SYS_NFC_POLL_TECH_ALL            \
+  }
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Technologies, in their default order
+ */
+typedef enum
+{
+  SYS_NFC_POLL_TECH_AP2P,       // Active P2P, always first, leaves the field off
+  SYS_NFC_POLL_TECH_NFCA,
+  SYS_NFC_POLL_TECH_NFCB,
+  SYS_NFC_POLL_TECH_ST25TB,
+  SYS_NFC_POLL_TECH_NFCF,
+  SYS_NFC_POLL_TECH_NFCV,
+  SYS_NFC_POLL_TECH_MAX
+}
+sys_nfc_poll_tech_t;
+
+#define SYS_NFC_POLL_TECH_ALL         ((1U << SYS_NFC_POLL_TECH_MAX) - 1U)
+
+/**
+ * @brief Technology poll handler, run by the NFC worker task
+ *
+ * @return true if a device was found
+ */
+typedef bool (*sys_nfc_poll_fn_t)(void);
+
+/**
+ * @brief Scheduling policy
+ *
+ * Every technology has a score, raised by hit_score on each detection and losing
+ * 1/2^decay_shift of itself every round. Present technologies, score at or above
+ * present_score, are polled every round, highest score first. Absent ones are
+ * polled once every absent_every rounds. Scores start at hit_score.
+ *
+ * A device kept by its poll handler, see sys_nfc_presence.h, holds the rounds off:
+ * the field stays on and it is checked every presence_us, each check counting as
+ * a poll of its technology. The full rounds come back once it is gone.
+ */
+typedef struct
+{
+  uint32_t round_us;        // Round period, the detection latency of a present technology
+  uint32_t presence_us;     // Presence check period of a kept device, its removal latency
+  uint32_t field_off_us;    // Field reset before each round and after AP2P
+  uint16_t hit_score;       // Score added on detection
+  uint16_t present_score;   // Polled every round at or above
+  uint8_t  decay_shift;     // Score loses 1/2^n every round
+  uint8_t  absent_every;    // Absent technology polled once every n rounds, 1 for always
+  uint8_t  tech_mask;       // Technologies polled, bit n for sys_nfc_poll_tech_t n
+}
+sys_nfc_poll_policy_t;
+
+/**
+ * @brief Technology statistics
+ */
+typedef struct
+{
+  uint32_t polls;           // Polls run
+  uint32_t hits;            // Polls that found a device
+  uint32_t last_us;         // Duration of the last poll
+  uint16_t score;           // Current score
+  bool     present;         // Polled every round
+}
+sys_nfc_poll_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Set the technology poll handlers
+ *
+ * @param[in]     <poll>        Poll handler per technology, NULL for unsupported
+ *                <field_off>   Run once the field went off at the end of a round, NULL for none
+ *
+ * @attention     Before the NFC worker task starts. Uses the default policy.
+ *
+ * @return        None
+ */
+void sys_nfc_poll_init(const sys_nfc_poll_fn_t poll[SYS_NFC_POLL_TECH_MAX], void (*field_off)(void));
+
+/**
+ * @brief         Run the next scheduling step
+ *
+ * @param[in]     None
+ *
+ * @attention     NFC worker cycle handler, runs one technology poll at most
+ *
+ * @return        Microseconds until the next step is due, 0 for right away
+ */
+uint32_t sys_nfc_poll_cycle(void);
+
+/**
+ * @brief         Start the next round at once
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only
+ *
+ * @return        None
+ */
+void sys_nfc_poll_trigger(void);
+
+/**
+ * @brief         Check whether the scheduler is in between rounds
+ *
+ * @param[in]     None
+ *
+ * @attention     The field is off in between rounds
+ *
+ * @return        true if in between rounds
+ */
+bool sys_nfc_poll_is_idle(void);
+
+/**
+ * @brief         Check whether the last round found a device
+ *
+ * @param[in]     None
+ *
+ * @attention     true before the first round, the cards present at boot get polled
+ *
+ * @return        true if the last round found a device
+ */
+bool sys_nfc_poll_round_found(void);
+
+/**
+ * @brief         Set the scheduling policy
+ *
+ * @param[in]     <policy>      New policy
+ *
+ * @attention     Applied by the NFC worker task before the call returns.
+ *                Scores are kept.
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG for an invalid policy,
+ *                error of sys_nfc_submit() otherwise
+ */
+esp_err_t sys_nfc_poll_policy_set(const sys_nfc_poll_policy_t *policy);
+
+/**
+ * @brief         Get the scheduling policy
+ *
+ * @param[in]     <policy>      Current policy
+ *
+ * @attention     None
+ *
+ * @return        ESP_OK on success, error of sys_nfc_submit() otherwise
+ */
+esp_err_t sys_nfc_poll_policy_get(sys_nfc_poll_policy_t *policy);
+
+/**
+ * @brief         Get the statistics of a technology
+ *
+ * @param[in]     <tech>        Technology
+ *                <stats>       Statistics
+ *
+ * @attention     None
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG, error of sys_nfc_submit() otherwise
+ */
+esp_err_t sys_nfc_poll_stats_get(sys_nfc_poll_tech_t tech, sys_nfc_poll_stats_t *stats);
+
+#endif // __SYS_NFC_POLL_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,170 @@
+/**
+ * @file       sys_nfc_presence.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-18
+ * @author     Thuan Le
+ * @brief      Presence check of the last activated device, one round trip instead of a discovery
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc_presence.h"
+#include "sys_nfc_isodep.h"
+#include "platform.h"
+#include "rfal_rf.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define SYS_NFC_PRESENCE_NFCV_MASK_LEN    (RFAL_NFCV_UID_LEN * 8U)    // Mask length in bits
+
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc_presence";
+
+/* Private macros ----------------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------------- */
+/* Private variables -------------------------------------------------------- */
+static sys_nfc_presence_kind_t m_kind;
+static uint8_t                 m_uid[RFAL_NFCV_UID_LEN];    // NFC-V UID
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static bool m_sys_nfc_presence_nfca(void);
+static bool m_sys_nfc_presence_nfcv(void);
+
+/* Function definitions ----------------------------------------------------- */
+void sys_nfc_presence_keep_nfca(const rfalNfcaListenDevice *dev)
+{
+  if (NULL == dev)
+  {
+    sys_nfc_presence_forget();
+    return;
+  }
+
+  // In HALT it only answers WUPA, new cards in IDLE answer too and collide.
+  // Halted first, the deselects of a forgotten ISO-DEP session are not for it.
+  rfalNfcaPollerSleep();
+  sys_nfc_presence_forget();
+  m_kind = SYS_NFC_PRESENCE_NFCA;
+}
+
+void sys_nfc_presence_keep_isodep(void)
+{
+  // The sessions are what is kept, they are not reset here
+  m_kind = (0 != sys_nfc_isodep_count()) ? SYS_NFC_PRESENCE_ISODEP : SYS_NFC_PRESENCE_NONE;
+}
+
+void sys_nfc_presence_keep_nfcv(const uint8_t uid[RFAL_NFCV_UID_LEN])
+{
+  sys_nfc_presence_forget();
+
+  if (NULL == uid)
+    return;
+
+  memcpy(m_uid, uid, RFAL_NFCV_UID_LEN);
+  m_kind = SYS_NFC_PRESENCE_NFCV;
+}
+
+bool sys_nfc_presence_check(void)
+{
+  bool present;
+
+  switch (m_kind)
+  {
+  case SYS_NFC_PRESENCE_NFCA:
+    present = m_sys_nfc_presence_nfca();
+    break;
+
+  case SYS_NFC_PRESENCE_ISODEP:
+    rfalNfcaPollerInitialize();
+    present = (0 != sys_nfc_isodep_presence());
+    break;
+
+  case SYS_NFC_PRESENCE_NFCV:
+    present = m_sys_nfc_presence_nfcv();
+    break;
+
+  default:
+    return false;
+  }
+
+  if (!present)
+  {
+    ESP_LOGI(TAG, "Device gone");
+    sys_nfc_presence_forget();
+  }
+
+  return present;
+}
+
+void sys_nfc_presence_forget(void)
+{
+  // A card left in ISO-DEP ignores WUPA, the next discovery would miss it
+  if (SYS_NFC_PRESENCE_ISODEP == m_kind)
+  {
+    rfalNfcaPollerInitialize();
+    sys_nfc_isodep_close();
+  }
+
+  m_kind = SYS_NFC_PRESENCE_NONE;
+}
+
+sys_nfc_presence_kind_t sys_nfc_presence_kind(void)
+{
+  return m_kind;
+}
+
+sys_nfc_poll_tech_t sys_nfc_presence_tech(void)
+{
+  return (SYS_NFC_PRESENCE_NFCV == m_kind) ? SYS_NFC_POLL_TECH_NFCV : SYS_NFC_POLL_TECH_NFCA;
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Check the halted NFC-A card
+ *
+ * @param[in]     None
+ *
+ * @attention     A collision means another card came in, a discovery is due
+ *
+ * @return        true if still there, alone
+ */
+static bool m_sys_nfc_presence_nfca(void)
+{
+  rfalNfcaSensRes sens_res;
+
+  rfalNfcaPollerInitialize();
+
+  if (ERR_NONE != rfalNfcaPollerCheckPresence(RFAL_14443A_SHORTFRAME_CMD_WUPA, &sens_res))
+    return false;
+
+  // Back to HALT for the next check, HLTA has no answer
+  rfalNfcaPollerSleep();
+
+  return true;
+}
+
+/**
+ * @brief         Check the NFC-V card
+ *
+ * @param[in]     None
+ *
+ * @attention     Only the card with this UID answers, protected blocks do not matter
+ *
+ * @return        true if still there
+ */
+static bool m_sys_nfc_presence_nfcv(void)
+{
+  rfalNfcvInventoryRes inv_res;
+  uint16_t             rcvd_len;
+
+  rfalNfcvPollerInitialize();
+
+  if (ERR_NONE != rfalNfcvPollerInventory(RFAL_NFCV_NUM_SLOTS_1, SYS_NFC_PRESENCE_NFCV_MASK_LEN, m_uid, &inv_res, &rcvd_len))
+    return false;
+
+  return (0 == memcmp(inv_res.UID, m_uid, RFAL_NFCV_UID_LEN));
+}
+
+/* End of file -------------------------------------------------------------- */
@@ -0,0 +1,119 @@
+/**
+ * @file       sys_nfc_presence.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-18
+ * @author     Thuan Le
+ * @brief      Presence check of the last activated device, one round trip instead of a discovery
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_PRESENCE_H
+#define __SYS_NFC_PRESENCE_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc_poll.h"
+#include "rfal_nfca.h"
+#include "rfal_nfcv.h"
+
+/* Public defines ----------------------------------------------------- */
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Device kept, with the check used
+ */
+typedef enum
+{
+  SYS_NFC_PRESENCE_NONE,        // Nothing kept, full discovery
+  SYS_NFC_PRESENCE_NFCA,        // NFC-A card in HALT: WUPA answered, HLTA back
+  SYS_NFC_PRESENCE_ISODEP,      // ISO-DEP sessions left open: R(NAK) answered by R(ACK)
+  SYS_NFC_PRESENCE_NFCV         // NFC-V card: inventory masked with its full UID
+}
+sys_nfc_presence_kind_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Keep an NFC-A card done with
+ *
+ * @param[in]     <dev>         Card, the one left selected and alone in the field
+ *
+ * @attention     Worker task context only. The card is put to HALT.
+ *
+ * @return        None
+ */
+void sys_nfc_presence_keep_nfca(const rfalNfcaListenDevice *dev);
+
+/**
+ * @brief         Keep the active ISO-DEP sessions
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only. The sessions stay open for more APDUs.
+ *
+ * @return        None
+ */
+void sys_nfc_presence_keep_isodep(void);
+
+/**
+ * @brief         Keep an NFC-V card
+ *
+ * @param[in]     <uid>         Card UID, as received in the inventory
+ *
+ * @attention     Worker task context only. The card must not be put quiet.
+ *
+ * @return        None
+ */
+void sys_nfc_presence_keep_nfcv(const uint8_t uid[RFAL_NFCV_UID_LEN]);
+
+/**
+ * @brief         Check that the kept device is still in the field
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only, blocking, field on. A device lost is forgotten.
+ *
+ * @return        true if still there
+ */
+bool sys_nfc_presence_check(void);
+
+/**
+ * @brief         Forget the kept device
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only, blocking. ISO-DEP sessions are deselected
+ *                and closed, NFC-A mode is left set. No RF exchange for the others.
+ *
+ * @return        None
+ */
+void sys_nfc_presence_forget(void);
+
+/**
+ * @brief         Get the kind of device kept
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        SYS_NFC_PRESENCE_NONE if nothing is kept
+ */
+sys_nfc_presence_kind_t sys_nfc_presence_kind(void);
+
+/**
+ * @brief         Get the technology of the device kept
+ *
+ * @param[in]     None
+ *
+ * @attention     Only meaningful while a device is kept
+ *
+ * @return        Technology
+ */
+sys_nfc_poll_tech_t sys_nfc_presence_tech(void);
+
+#endif // __SYS_NFC_PRESENCE_H
+
+/* End of file -------------------------------------------------------- */
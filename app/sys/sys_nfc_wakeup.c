@@ -0,0 +1,249 @@
+/**
+ * @file       sys_nfc_wakeup.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-16
+ * @author     Thuan Le
+ * @brief      Low power card detection, field off and ESP32 asleep until the chip wakes up
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "sys_nfc_wakeup.h"
+#include "platform.h"
+#include "bsp.h"
+
+/* Private defines ---------------------------------------------------------- */
+/* Private Constants -------------------------------------------------------- */
+static const char *TAG = "sys_nfc_wakeup";
+
+/* Private macros ----------------------------------------------------------- */
+/* Private enumerate/structure ---------------------------------------------- */
+/* Private variables -------------------------------------------------------- */
+static sys_nfc_wakeup_cfg_t   m_cfg = SYS_NFC_WAKEUP_CFG_DEFAULT;
+static sys_nfc_wakeup_stats_t m_stats;
+static rfalWakeUpConfig       m_rfal_cfg;
+static bool                   m_calibrated;
+static bool                   m_active;
+static bool                   m_woke;             // Woken up, outcome not reported yet
+static uint8_t                m_false_wakes;      // In a row
+static int64_t                m_cal_time;
+
+/* Public variables --------------------------------------------------------- */
+/* Private function prototypes ---------------------------------------------- */
+static void m_sys_nfc_wakeup_rfal_cfg(void);
+static ReturnCode m_sys_nfc_wakeup_calibrate(void);
+static bool m_sys_nfc_wakeup_recal_due(void);
+
+/* Function definitions ----------------------------------------------------- */
+esp_err_t sys_nfc_wakeup_init(const sys_nfc_wakeup_cfg_t *cfg)
+{
+  sys_nfc_wakeup_cfg_t def = SYS_NFC_WAKEUP_CFG_DEFAULT;
+
+  if (NULL == cfg)
+    cfg = &def;
+
+  CHECK(0 != cfg->cal_samples, ESP_ERR_INVALID_ARG);
+
+  m_cfg         = *cfg;
+  m_calibrated  = false;
+  m_false_wakes = 0;
+
+  m_sys_nfc_wakeup_rfal_cfg();
+
+  return ESP_OK;
+}
+
+ReturnCode sys_nfc_wakeup_start(void)
+{
+  ReturnCode ret;
+
+  if (m_active)
+    return ERR_NONE;
+
+  if (!m_calibrated || m_sys_nfc_wakeup_recal_due())
+  {
+    ret = m_sys_nfc_wakeup_calibrate();
+    if (ERR_NONE != ret)
+      return ret;
+  }
+
+  ret = rfalWakeUpModeStart(&m_rfal_cfg);
+  if (ERR_NONE != ret)
+    return ret;
+
+  m_active = true;
+
+  return ERR_NONE;
+}
+
+uint32_t sys_nfc_wakeup_cycle(void)
+{
+  int64_t  now;
+  int64_t  left;
+  uint32_t wait_us;
+
+  if (!m_active || rfalWakeUpModeHasWoke())
+    return 0;
+
+  // The references are measured with the Wake-Up timer stopped
+  if (m_sys_nfc_wakeup_recal_due())
+  {
+    sys_nfc_wakeup_stop();
+    if (ERR_NONE != sys_nfc_wakeup_start())
+      return SYS_NFC_WAKEUP_WAIT_MAX_US;
+  }
+
+  wait_us = SYS_NFC_WAKEUP_WAIT_MAX_US;
+
+  if (0 != m_cfg.recal_period_us)
+  {
+    now  = esp_timer_get_time();
+    left = (m_cal_time + m_cfg.recal_period_us) - now;
+
+    if (left < wait_us)
+      wait_us = (left > 0) ? (uint32_t)left : 0;
+  }
+
+  if (!m_cfg.light_sleep || (0 == wait_us))
+    return wait_us;
+
+  // Chip IRQ or recalibration wakes the ESP32, the IRQ task then wakes the worker
+  bsp_nfc_light_sleep((0 != m_cfg.recal_period_us) ? wait_us : 0);
+
+  return m_sys_nfc_wakeup_recal_due() ? 0 : SYS_NFC_WAKEUP_WAIT_MAX_US;
+}
+
+bool sys_nfc_wakeup_has_woke(void)
+{
+  return (m_active && rfalWakeUpModeHasWoke());
+}
+
+void sys_nfc_wakeup_stop(void)
+{
+  if (!m_active)
+    return;
+
+  if (rfalWakeUpModeHasWoke())
+  {
+    m_stats.wakes++;
+    m_woke = true;
+  }
+
+  rfalWakeUpModeStop();
+  m_active = false;
+}
+
+void sys_nfc_wakeup_report(bool found)
+{
+  if (!m_woke)
+    return;
+
+  m_woke = false;
+
+  if (found)
+  {
+    m_false_wakes = 0;
+    return;
+  }
+
+  m_stats.false_wakes++;
+
+  // Drifted references keep waking the chip up with nothing around
+  if ((0 != m_cfg.false_wake_max) && (++m_false_wakes >= m_cfg.false_wake_max))
+  {
+    ESP_LOGI(TAG, "%d false wake-ups, recalibrating", m_false_wakes);
+    m_calibrated  = false;
+    m_false_wakes = 0;
+  }
+}
+
+esp_err_t sys_nfc_wakeup_stats_get(sys_nfc_wakeup_stats_t *stats)
+{
+  CHECK(NULL != stats, ESP_ERR_INVALID_ARG);
+
+  *stats = m_stats;
+
+  return ESP_OK;
+}
+
+/* Private function --------------------------------------------------------- */
+/**
+ * @brief         Build the RFAL Wake-Up configuration
+ *
+ * @param[in]     None
+ *
+ * @attention     References are filled in by the calibration
+ *
+ * @return        None
+ */
+static void m_sys_nfc_wakeup_rfal_cfg(void)
+{
+  bool inductive = (SYS_NFC_WAKEUP_INDUCTIVE == m_cfg.method);
+
+  memset(&m_rfal_cfg, 0, sizeof(m_rfal_cfg));
+
+  m_rfal_cfg.period  = m_cfg.period;
+  m_rfal_cfg.irqTout = false;
+
+  // The chip does either the inductive measurements or the capacitive one
+  m_rfal_cfg.indAmp.enabled = inductive;
+  m_rfal_cfg.indAmp.delta   = m_cfg.amp_delta;
+  m_rfal_cfg.indPha.enabled = inductive;
+  m_rfal_cfg.indPha.delta   = m_cfg.pha_delta;
+  m_rfal_cfg.cap.enabled    = !inductive;
+  m_rfal_cfg.cap.delta      = m_cfg.cap_delta;
+}
+
+/**
+ * @brief         Measure the references
+ *
+ * @param[in]     None
+ *
+ * @attention     Wake-Up mode stopped, field off
+ *
+ * @return        ERR_NONE on success, error of the RFAL otherwise
+ */
+static ReturnCode m_sys_nfc_wakeup_calibrate(void)
+{
+  ReturnCode ret;
+
+  rfalFieldOff();
+
+  ret = rfalWakeUpModeCalibrate(&m_rfal_cfg, m_cfg.cal_samples);
+  if (ERR_NONE != ret)
+    return ret;
+
+  m_calibrated = true;
+  m_cal_time   = esp_timer_get_time();
+
+  m_stats.calibrations++;
+  m_stats.amp_ref = m_rfal_cfg.indAmp.reference;
+  m_stats.pha_ref = m_rfal_cfg.indPha.reference;
+  m_stats.cap_ref = m_rfal_cfg.cap.reference;
+
+  ESP_LOGI(TAG, "References amp %d pha %d cap %d", m_stats.amp_ref, m_stats.pha_ref, m_stats.cap_ref);
+
+  return ERR_NONE;
+}
+
+/**
+ * @brief         Check whether the periodic recalibration is due
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        true if due
+ */
+static bool m_sys_nfc_wakeup_recal_due(void)
+{
+  if (0 == m_cfg.recal_period_us)
+    return false;
+
+  return (esp_timer_get_time() >= (m_cal_time + m_cfg.recal_period_us));
+}
+
+/* End of file -------------------------------------------------------------- */
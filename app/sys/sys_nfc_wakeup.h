@@ -0,0 +1,178 @@
+/**
+ * @file       sys_nfc_wakeup.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-16
+ * @author     Thuan Le
+ * @brief      Low power card detection, field off and ESP32 asleep until the chip wakes up
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_WAKEUP_H
+#define __SYS_NFC_WAKEUP_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc.h"
+#include "rfal_rf.h"
+
+/* Public defines ----------------------------------------------------- */
+#ifndef SYS_NFC_WAKEUP_ENABLE
+#define SYS_NFC_WAKEUP_ENABLE         (1)         // Wake-Up mode in between rounds that found nothing
+#endif
+#ifndef SYS_NFC_WAKEUP_LIGHT_SLEEP
+#define SYS_NFC_WAKEUP_LIGHT_SLEEP    (0)         // ESP32 light-sleep while waiting, for builds without WiFi only
+#endif
+#define SYS_NFC_WAKEUP_WAIT_MAX_US    (1000000)   // Longest worker wait while waiting, a watchdog on the IRQ
+
+/**
+ * @brief Default configuration: inductive amplitude and phase every 200 ms, recalibrated every minute
+ */
+#define SYS_NFC_WAKEUP_CFG_DEFAULT                    \
+  {                                                   \
+    .period          = RFAL_WUM_PERIOD_200MS,         \
+    .method          = SYS_NFC_WAKEUP_INDUCTIVE,      \
+    .amp_delta       = 2,                             \
+    .pha_delta       = 2,                             \
+    .cap_delta       = 2,                             \
+    .cal_samples     = 8,                             \
+    .false_wake_max  = 3,                             \
+    .recal_period_us = 60000000,                      \
+    .light_sleep     = SYS_NFC_WAKEUP_LIGHT_SLEEP     \
+  }
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Detection method
+ */
+typedef enum
+{
+  SYS_NFC_WAKEUP_INDUCTIVE,     // Antenna amplitude and phase, detects cards
+  SYS_NFC_WAKEUP_CAPACITIVE     // Capacitive sensor, detects anything approaching
+}
+sys_nfc_wakeup_method_t;
+
+/**
+ * @brief Configuration
+ *
+ * References are measured by the firmware, averaged over cal_samples measurements,
+ * instead of the single measurement of the RFAL. They are measured again after
+ * false_wake_max wake-ups in a row found nothing, and every recal_period_us as the
+ * antenna drifts with temperature and battery voltage.
+ */
+typedef struct
+{
+  rfalWumPeriod           period;           // Wake-Up timer period
+  sys_nfc_wakeup_method_t method;
+  uint8_t                 amp_delta;        // Amplitude change that wakes up, inductive
+  uint8_t                 pha_delta;        // Phase change that wakes up, inductive
+  uint8_t                 cap_delta;        // Capacitance change that wakes up, capacitive
+  uint8_t                 cal_samples;      // Measurements averaged per reference
+  uint8_t                 false_wake_max;   // Wake-ups in a row without a card before recalibrating, 0 for never
+  uint32_t                recal_period_us;  // Periodic recalibration, 0 for never
+  bool                    light_sleep;      // ESP32 light-sleep while waiting
+}
+sys_nfc_wakeup_cfg_t;
+
+/**
+ * @brief Statistics
+ */
+typedef struct
+{
+  uint32_t wakes;           // Wake-ups
+  uint32_t false_wakes;     // Wake-ups that found nothing
+  uint32_t calibrations;    // Reference measurements
+  uint8_t  amp_ref;         // Current references
+  uint8_t  pha_ref;
+  uint8_t  cap_ref;
+}
+sys_nfc_wakeup_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Set the configuration
+ *
+ * @param[in]     <cfg>         Configuration, NULL for the default
+ *
+ * @attention     Before the NFC worker task starts. References are measured on the next start.
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG otherwise
+ */
+esp_err_t sys_nfc_wakeup_init(const sys_nfc_wakeup_cfg_t *cfg);
+
+/**
+ * @brief         Enter Wake-Up mode
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only, with the field off. Measures the
+ *                references first when due.
+ *
+ * @return        ERR_NONE on success, error of the RFAL otherwise
+ */
+ReturnCode sys_nfc_wakeup_start(void);
+
+/**
+ * @brief         Run while in Wake-Up mode
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only, as the cycle handler. Recalibrates
+ *                when due and light-sleeps the ESP32 until the chip IRQ.
+ *
+ * @return        Microseconds until it wants to run again, 0 for right away
+ */
+uint32_t sys_nfc_wakeup_cycle(void);
+
+/**
+ * @brief         Check whether the chip woke up
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        true if woken up
+ */
+bool sys_nfc_wakeup_has_woke(void);
+
+/**
+ * @brief         Leave Wake-Up mode
+ *
+ * @param[in]     None
+ *
+ * @attention     Worker task context only
+ *
+ * @return        None
+ */
+void sys_nfc_wakeup_stop(void);
+
+/**
+ * @brief         Report the outcome of the polling that followed a wake-up
+ *
+ * @param[in]     <found>       true if a device was found
+ *
+ * @attention     Worker task context only. Wake-ups in a row that found nothing
+ *                mean the references drifted, they are measured again.
+ *
+ * @return        None
+ */
+void sys_nfc_wakeup_report(bool found);
+
+/**
+ * @brief         Get the statistics
+ *
+ * @param[in]     <stats>       Statistics
+ *
+ * @attention     Snapshot taken without the worker, a field may be one wake-up behind
+ *
+ * @return        ESP_OK on success, ESP_ERR_INVALID_ARG otherwise
+ */
+esp_err_t sys_nfc_wakeup_stats_get(sys_nfc_wakeup_stats_t *stats);
+
+#endif // __SYS_NFC_WAKEUP_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,93 @@
+/**
+ * @file       sys_nfc_xfer.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-09
+ * @author     Thuan Le
+ * @brief      Asynchronous transceive run by the NFC worker task
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __SYS_NFC_XFER_H
+#define __SYS_NFC_XFER_H
+
+/* Includes ----------------------------------------------------------- */
+#include "sys_nfc.h"
+#include "rfal_rf.h"
+
+/* Public defines ----------------------------------------------------- */
+/* Public enumerate/structure ----------------------------------------- */
+typedef struct sys_nfc_xfer sys_nfc_xfer_t;
+
+/**
+ * @brief Transceive completion handler, run by the NFC worker task once the
+ *        status is published, it may submit the same transceive again
+ */
+typedef void (*sys_nfc_xfer_cb_t)(sys_nfc_xfer_t *xfer, ReturnCode status, void *arg);
+
+/**
+ * @brief Asynchronous transceive, owned by the worker from submit to completion
+ */
+struct sys_nfc_xfer
+{
+  rfalTransceiveContext ctx;        // Transceive to run, lengths in bits as for rfalStartTransceive()
+  sys_nfc_xfer_cb_t     cb;         // Completion handler, NULL for none
+  void                 *arg;        // Argument passed to the handler
+
+  volatile ReturnCode   status;     // ERR_BUSY until completed, ERR_REQUEST if rejected
+  SemaphoreHandle_t     done;       // Given on completion
+  StaticSemaphore_t     done_buf;
+};
+
+/* Public macros ------------------------------------------------------ */
+/* Public variables --------------------------------------------------- */
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Submit a transceive to the NFC worker task
+ *
+ * @param[in]     <xfer>        Transceive, ctx, cb and arg filled in by the caller
+ *
+ * @attention     Runs in order with sys_nfc_submit() requests. The request queue
+ *                is held until the transceive completes, the next one can be
+ *                submitted meanwhile. xfer and its buffers must stay valid until then.
+ *                A rejected transceive completes at once with ERR_REQUEST, the
+ *                handler is not run.
+ *
+ * @return        ESP_OK on success, ESP_ERR_TIMEOUT if the queue is full,
+ *                ESP_ERR_INVALID_STATE if the task is not running
+ */
+esp_err_t sys_nfc_xfer_submit(sys_nfc_xfer_t *xfer);
+
+/**
+ * @brief         Wait for a submitted transceive to complete
+ *
+ * @param[in]     <xfer>        Transceive
+ *                <timeout>     Timeout in ticks
+ *
+ * @attention     Completion handler, if any, may still be running when this
+ *                returns. Not from the worker task, it would wait for itself.
+ *
+ * @return        Transceive status, ERR_BUSY on timeout
+ */
+ReturnCode sys_nfc_xfer_wait(sys_nfc_xfer_t *xfer, TickType_t timeout);
+
+/**
+ * @brief         Check whether a submitted transceive has completed
+ *
+ * @param[in]     <xfer>        Transceive
+ *
+ * @attention     None
+ *
+ * @return        true if completed
+ */
+static inline bool sys_nfc_xfer_is_done(const sys_nfc_xfer_t *xfer)
+{
+  return (ERR_BUSY != xfer->status);
+}
+
+#endif // __SYS_NFC_XFER_H
+
+/* End of file -------------------------------------------------------- */
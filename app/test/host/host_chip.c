@@ -0,0 +1,208 @@
+/**
+ * @file       host_chip.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      Simulated ST25R3911 on the SPI bus: registers, read-to-clear IRQs and the IRQ line
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "host_chip.h"
+#include "host_platform.h"
+
+#include <string.h>
+#include <pthread.h>
+
+/* Private defines ---------------------------------------------------------- */
+#define HOST_CHIP_REG_IRQ_MASK        (0x14)    // IRQ_MASK_MAIN..IRQ_MASK_ERROR_WUP
+#define HOST_CHIP_REG_IRQ             (0x17)    // IRQ_MAIN..IRQ_ERROR_WUP, read to clear
+#define HOST_CHIP_IRQ_REGS            (3)
+#define HOST_CHIP_OP_TEST_ACCESS      (0xFC)
+#define HOST_CHIP_OP_FIFO_READ        (0xBF)
+
+/* Private macros ----------------------------------------------------------- */
+#define HOST_CHIP_MODE(op)            ((uint8_t)(op) >> 6)
+#define HOST_CHIP_ADDR(op)            ((uint8_t)(op) & 0x3F)
+
+/* Private variables -------------------------------------------------------- */
+static uint8_t           m_reg[HOST_CHIP_REG_CNT];
+static uint8_t           m_test_reg[HOST_CHIP_REG_CNT];
+static host_chip_stats_t m_stats;
+static pthread_mutex_t   m_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Private function prototypes ---------------------------------------------- */
+static bool m_host_chip_line(void);
+static void m_host_chip_xfer(uint8_t op, const uint8_t *tx, uint8_t *rx, uint16_t len);
+
+/* Function definitions ----------------------------------------------------- */
+int host_chip_spi(uint8_t cmd_bits, uint8_t cmd, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+  bool    before;
+  bool    after;
+  int     ret;
+  uint8_t op;
+
+  pthread_mutex_lock(&m_mutex);
+
+  m_stats.transfers++;
+  ret = m_stats.error;
+
+  if (0 != ret)
+  {
+    pthread_mutex_unlock(&m_mutex);
+    return ret;
+  }
+
+  before = m_host_chip_line();
+
+  // Without a command phase the first byte on the bus is the command
+  if (8 == cmd_bits)
+  {
+    m_host_chip_xfer(cmd, tx, rx, len);
+  }
+  else if (0 != len)
+  {
+    // tx and rx may be the same buffer, take the command before answering
+    op = (NULL != tx) ? tx[0] : 0;
+    if (NULL != rx)
+      rx[0] = 0;
+
+    m_host_chip_xfer(op, (NULL != tx) ? &tx[1] : NULL, (NULL != rx) ? &rx[1] : NULL, len - 1);
+  }
+
+  after = m_host_chip_line();
+
+  pthread_mutex_unlock(&m_mutex);
+
+  // Unmasking a latched IRQ raises the line too
+  if (!before && after)
+    host_irq_edge();
+
+  return 0;
+}
+
+void host_chip_reset(void)
+{
+  pthread_mutex_lock(&m_mutex);
+  memset(m_reg, 0, sizeof(m_reg));
+  memset(m_test_reg, 0, sizeof(m_test_reg));
+  memset(&m_stats, 0, sizeof(m_stats));
+  pthread_mutex_unlock(&m_mutex);
+}
+
+void host_chip_raise(uint32_t irqs)
+{
+  bool before;
+  bool after;
+  int  i;
+
+  pthread_mutex_lock(&m_mutex);
+
+  before = m_host_chip_line();
+  for (i = 0; i < HOST_CHIP_IRQ_REGS; i++)
+    m_reg[HOST_CHIP_REG_IRQ + i] |= (uint8_t)(irqs >> (8 * i));
+  after = m_host_chip_line();
+
+  pthread_mutex_unlock(&m_mutex);
+
+  if (!before && after)
+    host_irq_edge();
+}
+
+bool host_chip_line(void)
+{
+  bool line;
+
+  pthread_mutex_lock(&m_mutex);
+  line = m_host_chip_line();
+  pthread_mutex_unlock(&m_mutex);
+
+  return line;
+}
+
+uint8_t host_chip_reg(uint8_t reg)
+{
+  uint8_t value;
+
+  pthread_mutex_lock(&m_mutex);
+  value = m_reg[reg % HOST_CHIP_REG_CNT];
+  pthread_mutex_unlock(&m_mutex);
+
+  return value;
+}
+
+host_chip_stats_t *host_chip_stats(void)
+{
+  return &m_stats;
+}
+
+/* Private function --------------------------------------------------------- */
+static bool m_host_chip_line(void)
+{
+  int i;
+
+  for (i = 0; i < HOST_CHIP_IRQ_REGS; i++)
+  {
+    if (0 != (m_reg[HOST_CHIP_REG_IRQ + i] & (uint8_t)~m_reg[HOST_CHIP_REG_IRQ_MASK + i]))
+      return true;
+  }
+
+  return false;
+}
+
+static void m_host_chip_xfer(uint8_t op, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+  uint8_t  addr = HOST_CHIP_ADDR(op);
+  uint16_t i;
+
+  if (HOST_CHIP_OP_TEST_ACCESS == op)
+  {
+    // Test register address and mode, then the value
+    if ((len >= 2) && (NULL != tx) && (0 == HOST_CHIP_MODE(tx[0])))
+      m_test_reg[HOST_CHIP_ADDR(tx[0])] = tx[1];
+    if ((len >= 2) && (NULL != rx) && (NULL != tx))
+      rx[1] = m_test_reg[HOST_CHIP_ADDR(tx[0])];
+    return;
+  }
+
+  switch (HOST_CHIP_MODE(op))
+  {
+  case 0:
+    for (i = 0; (i < len) && ((addr + i) < HOST_CHIP_REG_CNT); i++)
+    {
+      m_reg[addr + i] = (NULL != tx) ? tx[i] : 0;
+      m_stats.reg_writes++;
+    }
+    break;
+
+  case 1:
+    if ((addr <= HOST_CHIP_REG_IRQ) && ((addr + len) > HOST_CHIP_REG_IRQ))
+      m_stats.irq_reads++;
+
+    for (i = 0; (i < len) && ((addr + i) < HOST_CHIP_REG_CNT); i++)
+    {
+      if (NULL != rx)
+        rx[i] = m_reg[addr + i];
+
+      if (((addr + i) >= HOST_CHIP_REG_IRQ) && ((addr + i) < (HOST_CHIP_REG_IRQ + HOST_CHIP_IRQ_REGS)))
+        m_reg[addr + i] = 0;
+    }
+    break;
+
+  case 2:
+    // FIFO load or read, the FIFO content is not modelled
+    if ((HOST_CHIP_OP_FIFO_READ == op) && (NULL != rx))
+      memset(rx, 0, len);
+    break;
+
+  default:
+    // Direct commands, not modelled
+    break;
+  }
+}
+
+/* End of file -------------------------------------------------------------- */
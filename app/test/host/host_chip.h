@@ -0,0 +1,110 @@
+/**
+ * @file       host_chip.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      Simulated ST25R3911 on the SPI bus: registers, read-to-clear IRQs and the IRQ line
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __HOST_CHIP_H
+#define __HOST_CHIP_H
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Public defines ----------------------------------------------------- */
+#define HOST_CHIP_REG_CNT       (64)
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Bus activity, for the tests
+ */
+typedef struct
+{
+  uint32_t transfers;       // SPI transactions
+  uint32_t irq_reads;       // Reads covering IRQ_MAIN
+  uint32_t reg_writes;      // Registers written
+  int      error;           // Error returned by the next transfers, 0 for none
+}
+host_chip_stats_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         SPI transaction to the chip
+ *
+ * @param[in]     <cmd_bits>    8 when cmd is sent in a command phase, 0 otherwise
+ *                <cmd>         Command byte
+ *                <tx>          Payload out, NULL for zeros
+ *                <rx>          Payload in, NULL to discard
+ *                <len>         Payload length
+ *
+ * @attention     Same shape as bsp_spi_transmit_receive() / bsp_spi_command_transfer()
+ *
+ * @return        0 on success, host_chip_stats_t.error if set
+ */
+int host_chip_spi(uint8_t cmd_bits, uint8_t cmd, const uint8_t *tx, uint8_t *rx, uint16_t len);
+
+/**
+ * @brief         Reset the chip registers and the bus statistics
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void host_chip_reset(void);
+
+/**
+ * @brief         Latch IRQs in IRQ_MAIN..IRQ_ERROR_WUP, raising the line
+ *
+ * @param[in]     <irqs>        IRQs, bit layout of ST25R3911_IRQ_MASK_*
+ *
+ * @attention     Gives the rising edge to the IRQ task when the line goes high
+ *
+ * @return        None
+ */
+void host_chip_raise(uint32_t irqs);
+
+/**
+ * @brief         Check the IRQ line
+ *
+ * @param[in]     None
+ *
+ * @attention     High while an unmasked IRQ is latched
+ *
+ * @return        true if high
+ */
+bool host_chip_line(void);
+
+/**
+ * @brief         Get a register
+ *
+ * @param[in]     <reg>         Register address
+ *
+ * @attention     None
+ *
+ * @return        Register value
+ */
+uint8_t host_chip_reg(uint8_t reg);
+
+/**
+ * @brief         Access the bus statistics
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        Statistics, writable to inject errors
+ */
+host_chip_stats_t *host_chip_stats(void);
+
+#endif // __HOST_CHIP_H
+
+/* End of file -------------------------------------------------------- */
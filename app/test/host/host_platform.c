@@ -0,0 +1,225 @@
+/**
+ * @file       host_platform.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      Host stand-in for the BSP: locks, clock, deferred IRQ task and simulated IRQ line
+ * @note       The deferred IRQ task mirrors m_bsp_nfc_irq_task() of bsp.c on a pthread
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "host_platform.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+/* Private enumerate/structure ---------------------------------------------- */
+/**
+ * @brief Task notification, as ulTaskNotifyTake() / xTaskNotifyGive()
+ */
+typedef struct
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+  uint32_t        count;
+}
+host_notify_t;
+
+/* Private variables -------------------------------------------------------- */
+static pthread_mutex_t m_lock[HOST_LOCK_CNT];
+static pthread_once_t  m_lock_once = PTHREAD_ONCE_INIT;
+
+static pthread_t       m_irq_task;
+static bool            m_irq_task_on;
+static volatile bool   m_irq_task_stop;
+static host_notify_t   m_irq_notify    = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0 };
+static host_notify_t   m_waiter_notify = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0 };
+static void            (*volatile m_irq_cb)(void);
+static volatile bool   m_waiter;
+static volatile bool   m_sim_pending;
+static volatile uint32_t m_bursts;
+static pthread_mutex_t m_sim_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Private function prototypes ---------------------------------------------- */
+static void m_host_lock_init(void);
+static void *m_host_irq_task(void *arg);
+static void m_host_notify_give(host_notify_t *n);
+static void m_host_notify_take(host_notify_t *n, uint32_t timeout_us);
+
+/* Function definitions ----------------------------------------------------- */
+void host_lock(host_lock_t lock)
+{
+  pthread_once(&m_lock_once, m_host_lock_init);
+  pthread_mutex_lock(&m_lock[lock]);
+}
+
+void host_unlock(host_lock_t lock)
+{
+  pthread_mutex_unlock(&m_lock[lock]);
+}
+
+void *host_task_id(void)
+{
+  return (void *)(uintptr_t)pthread_self();
+}
+
+uint64_t host_time_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+}
+
+void host_delay_us(uint32_t us)
+{
+  struct timespec ts = { .tv_sec = us / 1000000U, .tv_nsec = (long)(us % 1000000U) * 1000 };
+
+  while (0 != nanosleep(&ts, &ts) && (EINTR == errno)) {}
+}
+
+void host_irq_init(void)
+{
+  if (m_irq_task_on)
+    return;
+
+  m_irq_task_stop = false;
+  m_irq_task_on   = (0 == pthread_create(&m_irq_task, NULL, m_host_irq_task, NULL));
+
+  // Line may already be high
+  if (host_chip_line())
+    host_irq_edge();
+}
+
+void host_irq_deinit(void)
+{
+  if (!m_irq_task_on)
+    return;
+
+  m_irq_task_stop = true;
+  m_host_notify_give(&m_irq_notify);
+  pthread_join(m_irq_task, NULL);
+  m_irq_task_on = false;
+}
+
+void host_irq_set_callback(void (*cb)(void))
+{
+  m_irq_cb = cb;
+}
+
+void host_irq_set_waiter(bool on)
+{
+  m_waiter = on;
+}
+
+void host_irq_wait(uint32_t timeout_us)
+{
+  m_host_notify_take(&m_waiter_notify, timeout_us);
+}
+
+bool host_irq_is_high(void)
+{
+  bool sim;
+
+  pthread_mutex_lock(&m_sim_mutex);
+  sim           = m_sim_pending;
+  m_sim_pending = false;
+  pthread_mutex_unlock(&m_sim_mutex);
+
+  return (sim || host_chip_line());
+}
+
+void host_irq_simulate(void)
+{
+  pthread_mutex_lock(&m_sim_mutex);
+  m_sim_pending = true;
+  pthread_mutex_unlock(&m_sim_mutex);
+
+  host_irq_edge();
+}
+
+void host_irq_edge(void)
+{
+  m_host_notify_give(&m_irq_notify);
+}
+
+uint32_t host_irq_bursts(void)
+{
+  return m_bursts;
+}
+
+/* Private function --------------------------------------------------------- */
+static void m_host_lock_init(void)
+{
+  pthread_mutexattr_t attr;
+  int i;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+
+  for (i = 0; i < HOST_LOCK_CNT; i++)
+    pthread_mutex_init(&m_lock[i], (HOST_LOCK_IRQ_STATUS == i) ? NULL : &attr);
+
+  pthread_mutexattr_destroy(&attr);
+}
+
+static void *m_host_irq_task(void *arg)
+{
+  (void)arg;
+
+  while (1)
+  {
+    m_host_notify_take(&m_irq_notify, 0);
+    if (m_irq_task_stop)
+      break;
+
+    if (NULL != m_irq_cb)
+      m_irq_cb();
+
+    m_bursts++;
+
+    if (m_waiter)
+      m_host_notify_give(&m_waiter_notify);
+  }
+
+  return NULL;
+}
+
+static void m_host_notify_give(host_notify_t *n)
+{
+  pthread_mutex_lock(&n->mutex);
+  n->count++;
+  pthread_cond_signal(&n->cond);
+  pthread_mutex_unlock(&n->mutex);
+}
+
+static void m_host_notify_take(host_notify_t *n, uint32_t timeout_us)
+{
+  struct timespec ts;
+  uint64_t        ns;
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ns         = (uint64_t)ts.tv_nsec + ((uint64_t)timeout_us * 1000U);
+  ts.tv_sec += (time_t)(ns / 1000000000U);
+  ts.tv_nsec = (long)(ns % 1000000000U);
+
+  pthread_mutex_lock(&n->mutex);
+  while (0 == n->count)
+  {
+    if (0 == timeout_us)
+      pthread_cond_wait(&n->cond, &n->mutex);
+    else if (ETIMEDOUT == pthread_cond_timedwait(&n->cond, &n->mutex, &ts))
+      break;
+  }
+
+  // Cleared on take, as ulTaskNotifyTake(pdTRUE, ...)
+  n->count = 0;
+  pthread_mutex_unlock(&n->mutex);
+}
+
+/* End of file -------------------------------------------------------------- */
@@ -0,0 +1,183 @@
+/**
+ * @file       host_platform.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      Host stand-in for the BSP: locks, clock, deferred IRQ task and simulated IRQ line
+ * @note       The deferred IRQ task mirrors m_bsp_nfc_irq_task() of bsp.c on a pthread
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __HOST_PLATFORM_H
+#define __HOST_PLATFORM_H
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "host_chip.h"
+
+/* Public enumerate/structure ----------------------------------------- */
+/**
+ * @brief Locks, as bsp_nfc_lock_t
+ */
+typedef enum
+{
+  HOST_LOCK_COMM = 0,       // Recursive
+  HOST_LOCK_IRQ_STATUS,
+  HOST_LOCK_WORKER,         // Recursive
+  HOST_LOCK_CNT
+}
+host_lock_t;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Take/give a lock
+ *
+ * @param[in]     <lock>        Lock
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void host_lock(host_lock_t lock);
+void host_unlock(host_lock_t lock);
+
+/**
+ * @brief         Identify the calling thread
+ *
+ * @param[in]     None
+ *
+ * @attention     As xTaskGetCurrentTaskHandle()
+ *
+ * @return        Thread id
+ */
+void *host_task_id(void);
+
+/**
+ * @brief         Get the monotonic time
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        Time in microseconds
+ */
+uint64_t host_time_us(void);
+
+/**
+ * @brief         Sleep the calling thread
+ *
+ * @param[in]     <us>          Time in microseconds
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void host_delay_us(uint32_t us);
+
+/**
+ * @brief         Start the deferred IRQ task
+ *
+ * @param[in]     None
+ *
+ * @attention     Called again on every init, started once
+ *
+ * @return        None
+ */
+void host_irq_init(void);
+
+/**
+ * @brief         Stop the deferred IRQ task
+ *
+ * @param[in]     None
+ *
+ * @attention     Waits for the task to end
+ *
+ * @return        None
+ */
+void host_irq_deinit(void);
+
+/**
+ * @brief         Set the handler run by the deferred IRQ task
+ *
+ * @param[in]     <cb>          Handler, NULL to detach
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void host_irq_set_callback(void (*cb)(void));
+
+/**
+ * @brief         Register or unregister the waiting thread
+ *
+ * @param[in]     <on>          true to be notified after every drained burst
+ *
+ * @attention     One waiter, as the single RFAL worker on the target
+ *
+ * @return        None
+ */
+void host_irq_set_waiter(bool on);
+
+/**
+ * @brief         Block until the next drained burst or timeout
+ *
+ * @param[in]     <timeout_us>  Timeout in microseconds, 0 waits forever
+ *
+ * @attention     May return early, callers re-check their condition
+ *
+ * @return        None
+ */
+void host_irq_wait(uint32_t timeout_us);
+
+/**
+ * @brief         Check the IRQ line level, a pending simulated pulse included
+ *
+ * @param[in]     None
+ *
+ * @attention     A simulated pulse reads high once
+ *
+ * @return        true if the line is high
+ */
+bool host_irq_is_high(void);
+
+/**
+ * @brief         Raise a simulated pulse and wake the IRQ task, as bsp_nfc_irq_simulate()
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+void host_irq_simulate(void);
+
+/**
+ * @brief         Rising edge of the IRQ line, the GPIO ISR of the target
+ *
+ * @param[in]     None
+ *
+ * @attention     Called by the simulated chip
+ *
+ * @return        None
+ */
+void host_irq_edge(void);
+
+/**
+ * @brief         Get the number of bursts the IRQ task has drained
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        Bursts drained
+ */
+uint32_t host_irq_bursts(void);
+
+#endif // __HOST_PLATFORM_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,116 @@
+/**
+ * @file       platform.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      Host platform for the RFAL, stands in for components/platform/platform.h in the host tests
+ * @note       Same macros as the target platform, mapped on host_platform.c and the simulated chip
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __PLATFORM_NFC_H
+#define __PLATFORM_NFC_H
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "st_errno.h"
+#include "host_platform.h"
+
+/* Public defines ----------------------------------------------------- */
+#define ST25R3911                               (1)
+
+#define ST25R391X_SS_PIN                        (-1)
+#define ST25R391X_SS_PORT                       (-1)
+#define ST25R391X_INT_PIN                       (-1)
+#define ST25R391X_INT_PORT                      (-1)
+
+#define ST25R391X_TAGDETECT_DEF_CALIBRATION      0x7C
+#define ST25R391X_TAGDETECT_CALIBRATE            true
+
+/*
+******************************************************************************
+* RFAL FEATURES CONFIGURATION
+******************************************************************************
+*/
+#define RFAL_FEATURE_LISTEN_MODE               (false)
+#define RFAL_FEATURE_WAKEUP_MODE               (true)
+
+#define RFAL_FEATURE_NFCA                      (true)
+#define RFAL_FEATURE_NFCB                      (true)
+#define RFAL_FEATURE_NFCF                      (true)
+#define RFAL_FEATURE_NFCV                      (true)
+
+#define RFAL_FEATURE_T1T                       (true)
+#define RFAL_FEATURE_T2T                       (true)
+#define RFAL_FEATURE_T4T                       (true)
+#define RFAL_FEATURE_ST25TB                    (true)
+#define RFAL_FEATURE_ST25xV                    (true)
+
+#define RFAL_FEATURE_DYNAMIC_ANALOG_CONFIG     (false)
+#define RFAL_FEATURE_DPO                       (false)
+#define RFAL_FEATURE_ISO_DEP                   (true)
+#define RFAL_FEATURE_ISO_DEP_POLL              (true)
+#define RFAL_FEATURE_ISO_DEP_LISTEN            (false)
+#define RFAL_FEATURE_NFC_DEP                   (true)
+
+#define RFAL_FEATURE_ISO_DEP_IBLOCK_MAX_LEN    (256U)
+#define RFAL_FEATURE_NFC_DEP_BLOCK_MAX_LEN     (254U)
+#define RFAL_FEATURE_NFC_RF_BUF_LEN            (258U)
+
+#define RFAL_FEATURE_ISO_DEP_APDU_MAX_LEN      (1024U)
+#define RFAL_FEATURE_NFC_DEP_PDU_MAX_LEN       (512U)
+
+#ifndef RFAL_FEATURE_CRC_ENGINE
+#define RFAL_FEATURE_CRC_ENGINE                (2U)       // Overridden per object by the CRC tests
+#endif
+
+#define platformLedOn( port, pin )
+#define platformLedOff( port, pin )
+#define platformLedToogle( port, pin )
+#define platformLedsInitialize()
+
+#define platformIrqST25R3911PinIsHigh()        host_irq_is_high()
+
+#define platformTimerCreate(t)                 timerCalculateTimer(t)
+#define platformTimerCreateUs(t)               timerCalculateTimer_us(t)
+#define platformTimerIsExpired(timer)          timerIsExpired(timer)
+#define platformDelay(t)                       host_delay_us((uint32_t)(t) * 1000U)
+#define platformGetTimeUs()                    host_time_us()
+#define platformLog(...)                       printf(__VA_ARGS__)
+#define platformTimerDestroy( timer )
+#define platformErrorHandle()
+
+#define ST25R391X_COM_CMDPHASE
+#define platformSpiSelect()
+#define platformSpiDeselect()
+#define platformSpiTxRx(txBuf, rxBuf, len)            host_chip_spi(0, 0, (txBuf), (rxBuf), (len))
+#define platformSpiCmdTxRx(cmd, txBuf, rxBuf, len)    host_chip_spi(8, (cmd), (txBuf), (rxBuf), (len))
+
+#define platformProtectWorker()                host_lock(HOST_LOCK_WORKER)
+#define platformWorkerWait()                   host_delay_us(500)
+#define platformProtectST25R391xComm()         host_lock(HOST_LOCK_COMM)
+#define platformProtectST25R391xIrqStatus()    host_lock(HOST_LOCK_IRQ_STATUS)
+#define platformIrqST25R3911PinInitialize()    host_irq_init()
+#define platformIrqST25R3911SetCallback(data)  host_irq_set_callback(data)
+#define platformIrqST25R3911WaitBegin()        host_irq_set_waiter(true)
+#define platformIrqST25R3911Wait(us)           host_irq_wait(us)
+#define platformIrqST25R3911WaitEnd()          host_irq_set_waiter(false)
+#define platformGetTaskId()                    host_task_id()
+
+#define platformUnprotectWorker()              host_unlock(HOST_LOCK_WORKER)
+#define platformUnprotectST25R391xComm()       host_unlock(HOST_LOCK_COMM)
+#define platformUnprotectST25R391xIrqStatus()  host_unlock(HOST_LOCK_IRQ_STATUS)
+
+#include "timer.h"
+
+#endif /* __PLATFORM_NFC_H */
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,63 @@
+/**
+ * @file       platform_common.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      Host platform of the sys modules, stands in for components/platform/platform_common.h in the host tests
+ * @note       Only what the sys modules under test use, no FreeRTOS
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __PLATFORM_COMMON_H
+#define __PLATFORM_COMMON_H
+
+/* Includes ----------------------------------------------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Public defines ----------------------------------------------------- */
+#define ESP_OK                      (0)
+#define ESP_FAIL                    (-1)
+#define ESP_ERR_NO_MEM              (0x101)
+#define ESP_ERR_INVALID_ARG         (0x102)
+#define ESP_ERR_INVALID_STATE       (0x103)
+#define ESP_ERR_TIMEOUT             (0x107)
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef int esp_err_t;
+
+/* Public macros ------------------------------------------------------ */
+#define ESP_LOGE(tag, fmt, ...)     printf("E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...)     printf("W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...)     do { (void)(tag); } while (0)
+#define ESP_LOGD(tag, fmt, ...)     do { (void)(tag); } while (0)
+
+#define CHECK(expr, ret)           \
+  do {                             \
+    if (!(expr)) {                 \
+      ESP_LOGE(TAG, "%s", #expr);  \
+      return (ret);                \
+    }                              \
+  } while (0)
+
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Microseconds since start, provided by the test
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        Microseconds
+ */
+int64_t esp_timer_get_time(void);
+
+#endif // __PLATFORM_COMMON_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,206 @@
+/**
+ * @file       test_com.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      ST25R3911 com layer: SPI errors latched as ERR_IO, the shadow kept out of failed transfers
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "platform.h"
+#include "st25r3911_com.h"
+#include "st25r3911.h"
+
+#include <pthread.h>
+
+/* Private defines ---------------------------------------------------------- */
+#define TEST_COM_SPI_FAIL       (-1)        // Any non zero esp_err_t
+
+/* Private function prototypes ---------------------------------------------- */
+static void m_test_com_setup(void);
+static void *m_test_com_irq_context(void *arg);
+static void *m_test_com_other_write(void *arg);
+
+/* Test cases --------------------------------------------------------------- */
+static void test_com_no_error(void)
+{
+  uint8_t value;
+
+  m_test_com_setup();
+
+  st25r3911WriteRegister(ST25R3911_REG_MODE, 0x08);
+  st25r3911ReadRegister(ST25R3911_REG_MODE, &value);
+  st25r3911ExecuteCommand(ST25R3911_CMD_CLEAR_FIFO);
+
+  TEST_ASSERT_EQ(value, 0x08);
+  TEST_ASSERT_EQ(st25r3911ComGetError(), ERR_NONE);
+}
+
+static void test_com_error_latched_until_fetched(void)
+{
+  m_test_com_setup();
+
+  host_chip_stats()->error = TEST_COM_SPI_FAIL;
+  st25r3911ExecuteCommand(ST25R3911_CMD_CLEAR_FIFO);
+  host_chip_stats()->error = 0;
+
+  // Later good transfers do not hide it
+  st25r3911WriteRegister(ST25R3911_REG_MODE, 0x08);
+
+  TEST_ASSERT_EQ(st25r3911ComGetError(), ERR_IO);
+  TEST_ASSERT_EQ(st25r3911ComGetError(), ERR_NONE);
+}
+
+static void test_com_failed_read_not_cached(void)
+{
+  uint8_t  value;
+  uint32_t transfers;
+
+  m_test_com_setup();
+
+  st25r3911WriteRegister(ST25R3911_REG_MODE, 0x08);
+  st25r3911ShadowInvalidate();
+
+  host_chip_stats()->error = TEST_COM_SPI_FAIL;
+  st25r3911ReadRegister(ST25R3911_REG_MODE, &value);
+  host_chip_stats()->error = 0;
+
+  TEST_ASSERT_EQ(value, 0);
+  TEST_ASSERT_EQ(st25r3911ComGetError(), ERR_IO);
+
+  // Still unknown, read from the chip again
+  transfers = host_chip_stats()->transfers;
+  st25r3911ReadRegister(ST25R3911_REG_MODE, &value);
+
+  TEST_ASSERT_EQ(value, 0x08);
+  TEST_ASSERT_EQ(host_chip_stats()->transfers - transfers, 1);
+}
+
+static void test_com_failed_write_not_cached(void)
+{
+  uint8_t  value;
+  uint32_t transfers;
+
+  m_test_com_setup();
+
+  st25r3911WriteRegister(ST25R3911_REG_MODE, 0x08);
+
+  host_chip_stats()->error = TEST_COM_SPI_FAIL;
+  st25r3911WriteRegister(ST25R3911_REG_MODE, 0x10);
+  host_chip_stats()->error = 0;
+
+  TEST_ASSERT_EQ(st25r3911ComGetError(), ERR_IO);
+
+  // Neither the old nor the new value is trusted
+  transfers = host_chip_stats()->transfers;
+  st25r3911ReadRegister(ST25R3911_REG_MODE, &value);
+
+  TEST_ASSERT_EQ(value, 0x08);
+  TEST_ASSERT_EQ(host_chip_stats()->transfers - transfers, 1);
+}
+
+static void test_com_failed_batch(void)
+{
+  m_test_com_setup();
+
+  st25r3911BatchStart();
+  st25r3911WriteRegister(ST25R3911_REG_MODE, 0x08);
+  st25r3911WriteRegister(ST25R3911_REG_MODE + 1, 0x11);
+
+  host_chip_stats()->error = TEST_COM_SPI_FAIL;
+  st25r3911BatchCommit();
+  host_chip_stats()->error = 0;
+
+  TEST_ASSERT_EQ(st25r3911ComGetError(), ERR_IO);
+  TEST_ASSERT_EQ(host_chip_reg(ST25R3911_REG_MODE), 0);
+}
+
+static void test_com_batch_kept_from_other_task(void)
+{
+  pthread_t other;
+
+  m_test_com_setup();
+
+  st25r3911BatchStart();
+  st25r3911WriteRegister(ST25R3911_REG_MODE, 0x08);
+
+  // IRQ_MAIN read and a command from the IRQ context, the batch stays open
+  pthread_create(&other, NULL, m_test_com_irq_context, NULL);
+  pthread_join(other, NULL);
+
+  TEST_ASSERT_EQ(host_chip_reg(ST25R3911_REG_MODE), 0);
+
+  st25r3911BatchCommit();
+
+  TEST_ASSERT_EQ(host_chip_reg(ST25R3911_REG_MODE), 0x08);
+}
+
+static void test_com_batch_other_task_write_kept(void)
+{
+  pthread_t other;
+
+  m_test_com_setup();
+
+  st25r3911BatchStart();
+  st25r3911WriteRegister(ST25R3911_REG_MODE, 0x08);
+
+  pthread_create(&other, NULL, m_test_com_other_write, NULL);
+  pthread_join(other, NULL);
+
+  // Straight to the bus, on top of the chip value
+  TEST_ASSERT_EQ(host_chip_reg(ST25R3911_REG_MODE), 0x01);
+
+  // The commit does not undo it
+  st25r3911BatchCommit();
+  TEST_ASSERT_EQ(host_chip_reg(ST25R3911_REG_MODE), 0x09);
+}
+
+/* Function definitions ----------------------------------------------------- */
+int main(void)
+{
+  TEST_RUN(test_com_no_error);
+  TEST_RUN(test_com_error_latched_until_fetched);
+  TEST_RUN(test_com_failed_read_not_cached);
+  TEST_RUN(test_com_failed_write_not_cached);
+  TEST_RUN(test_com_failed_batch);
+  TEST_RUN(test_com_batch_kept_from_other_task);
+  TEST_RUN(test_com_batch_other_task_write_kept);
+
+  return test_summary();
+}
+
+/* Private function --------------------------------------------------------- */
+static void m_test_com_setup(void)
+{
+  host_chip_reset();
+  st25r3911ShadowInvalidate();
+  st25r3911ComGetError();
+}
+
+static void *m_test_com_irq_context(void *arg)
+{
+  uint8_t irq[3];
+
+  (void)arg;
+
+  st25r3911ReadMultipleRegisters(ST25R3911_REG_IRQ_MAIN, irq, sizeof(irq));
+  st25r3911ExecuteCommand(ST25R3911_CMD_CLEAR_FIFO);
+
+  return NULL;
+}
+
+static void *m_test_com_other_write(void *arg)
+{
+  (void)arg;
+
+  st25r3911SetRegisterBits(ST25R3911_REG_MODE, 0x01);
+
+  return NULL;
+}
+
+/* End of file -------------------------------------------------------------- */
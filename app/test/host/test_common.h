@@ -0,0 +1,95 @@
+/**
+ * @file       test_common.h
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      Minimal assertions and runner shared by the host tests
+ * @note       None
+ * @example    None
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef __TEST_COMMON_H
+#define __TEST_COMMON_H
+
+/* Includes ----------------------------------------------------------- */
+#include <stdio.h>
+#include <stdbool.h>
+
+/* Public macros ------------------------------------------------------ */
+#define TEST_ASSERT(cond)                                                     \
+  do                                                                          \
+  {                                                                           \
+    if (!(cond))                                                              \
+    {                                                                         \
+      printf("  %s:%d: %s\n", __FILE__, __LINE__, #cond);                    \
+      g_test_failed = true;                                                   \
+      return;                                                                 \
+    }                                                                         \
+  } while (0)
+
+#define TEST_ASSERT_EQ(a, b)                                                  \
+  do                                                                          \
+  {                                                                           \
+    unsigned long long _a = (unsigned long long)(a);                          \
+    unsigned long long _b = (unsigned long long)(b);                          \
+    if (_a != _b)                                                             \
+    {                                                                         \
+      printf("  %s:%d: %s == %s (0x%llx != 0x%llx)\n",                       \
+             __FILE__, __LINE__, #a, #b, _a, _b);                             \
+      g_test_failed = true;                                                   \
+      return;                                                                 \
+    }                                                                         \
+  } while (0)
+
+#define TEST_RUN(fn)        test_run(#fn, fn)
+
+/* Public variables --------------------------------------------------- */
+static bool g_test_failed;
+static int  g_test_fails;
+static int  g_test_cnt;
+
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief         Run a test case
+ *
+ * @param[in]     <name>        Test case name
+ *                <fn>          Test case
+ *
+ * @attention     None
+ *
+ * @return        None
+ */
+static inline void test_run(const char *name, void (*fn)(void))
+{
+  g_test_failed = false;
+  fn();
+
+  g_test_cnt++;
+  if (g_test_failed)
+    g_test_fails++;
+
+  printf("%s %s\n", g_test_failed ? "FAIL" : "PASS", name);
+}
+
+/**
+ * @brief         Summary, the exit code of the test program
+ *
+ * @param[in]     None
+ *
+ * @attention     None
+ *
+ * @return        0 if every test case passed, 1 otherwise
+ */
+static inline int test_summary(void)
+{
+  printf("%d/%d passed\n", g_test_cnt - g_test_fails, g_test_cnt);
+
+  return (0 == g_test_fails) ? 0 : 1;
+}
+
+#endif // __TEST_COMMON_H
+
+/* End of file -------------------------------------------------------- */
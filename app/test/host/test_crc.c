@@ -0,0 +1,238 @@
+/**
+ * @file       test_crc.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      CRC CCITT engines: bitwise, 256 entry table and slice-by-4 against a reference, plus a benchmark
+ * @note       rfal_crc.c is built once per engine, its symbols suffixed with the engine name
+ * @example    build/test_crc          run the tests
+ *             build/test_crc bench    run the benchmark
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "platform.h"
+#include "rfal_crc.h"
+
+#include <stdlib.h>
+
+/* Private defines ---------------------------------------------------------- */
+#define TEST_CRC_MAX_LEN        (300)       // Above the longest RFAL frame
+#define TEST_CRC_SEED           (0x3911U)
+#define TEST_CRC_BENCH_LEN      (256)
+#define TEST_CRC_BENCH_ROUNDS   (200000U)
+
+#define TEST_CRC_PRELOAD_A      (0x6363U)   // ISO14443A CRC_A
+#define TEST_CRC_PRELOAD_B      (0xFFFFU)   // ISO14443B CRC_B, ISO15693
+
+/* Private macros ----------------------------------------------------------- */
+#define TEST_CRC_ENGINE_DECLARE(e)                                                          \
+  uint16_t rfalCrcCalculateCcitt_##e(uint16_t preloadValue, const uint8_t *buf, uint16_t length); \
+  uint16_t rfalCrcUpdateCcittByte_##e(uint16_t crc, uint8_t dataByte);                     \
+  void     rfalCrcCcittStart_##e(rfalCrcCcittCtx *ctx, uint16_t preloadValue);             \
+  void     rfalCrcCcittUpdate_##e(rfalCrcCcittCtx *ctx, const uint8_t *buf, uint16_t length); \
+  uint16_t rfalCrcCcittGet_##e(const rfalCrcCcittCtx *ctx);
+
+#define TEST_CRC_ENGINE(e)      { #e, rfalCrcCalculateCcitt_##e, rfalCrcUpdateCcittByte_##e, \
+                                  rfalCrcCcittStart_##e, rfalCrcCcittUpdate_##e, rfalCrcCcittGet_##e }
+
+/* Private enumerate/structure ---------------------------------------------- */
+typedef struct
+{
+  const char *name;
+  uint16_t    (*calculate)(uint16_t preloadValue, const uint8_t *buf, uint16_t length);
+  uint16_t    (*update_byte)(uint16_t crc, uint8_t dataByte);
+  void        (*start)(rfalCrcCcittCtx *ctx, uint16_t preloadValue);
+  void        (*update)(rfalCrcCcittCtx *ctx, const uint8_t *buf, uint16_t length);
+  uint16_t    (*get)(const rfalCrcCcittCtx *ctx);
+}
+test_crc_engine_t;
+
+/* Private function prototypes ---------------------------------------------- */
+TEST_CRC_ENGINE_DECLARE(bitwise)
+TEST_CRC_ENGINE_DECLARE(table)
+TEST_CRC_ENGINE_DECLARE(slice4)
+
+static uint16_t m_test_crc_reference(uint16_t crc, const uint8_t *buf, uint16_t length);
+static void m_test_crc_fill(uint8_t *buf, uint16_t length);
+static void m_test_crc_bench(void);
+
+/* Private variables -------------------------------------------------------- */
+static const test_crc_engine_t m_engine[] =
+{
+  TEST_CRC_ENGINE(bitwise),
+  TEST_CRC_ENGINE(table),
+  TEST_CRC_ENGINE(slice4)
+};
+
+#define TEST_CRC_ENGINE_CNT     (sizeof(m_engine) / sizeof(m_engine[0]))
+
+static const uint8_t m_check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+/* Test cases --------------------------------------------------------------- */
+static void test_crc_check_values(void)
+{
+  size_t i;
+
+  for (i = 0; i < TEST_CRC_ENGINE_CNT; i++)
+  {
+    // CRC-A check value, CRC-B is the complement of X.25
+    TEST_ASSERT_EQ(m_engine[i].calculate(TEST_CRC_PRELOAD_A, m_check, sizeof(m_check)), 0xBF05);
+    TEST_ASSERT_EQ((uint16_t)~m_engine[i].calculate(TEST_CRC_PRELOAD_B, m_check, sizeof(m_check)), 0x906E);
+
+    // ISO14443-3 Annex B: CRC_A of 00 00 is A0 1E
+    TEST_ASSERT_EQ(m_engine[i].calculate(TEST_CRC_PRELOAD_A, (const uint8_t *)"\x00\x00", 2), 0x1EA0);
+  }
+}
+
+static void test_crc_engines_match_reference(void)
+{
+  uint8_t  buf[TEST_CRC_MAX_LEN + 3];
+  uint16_t len;
+  uint16_t preload;
+  uint16_t ref;
+  uint16_t off;
+  size_t   i;
+
+  srand(TEST_CRC_SEED);
+  m_test_crc_fill(buf, sizeof(buf));
+
+  // Every length, every alignment of the slice-by-4 words, random preloads
+  for (len = 0; len <= TEST_CRC_MAX_LEN; len++)
+  {
+    for (off = 0; off < 4; off++)
+    {
+      preload = (uint16_t)rand();
+      ref     = m_test_crc_reference(preload, &buf[off], len);
+
+      for (i = 0; i < TEST_CRC_ENGINE_CNT; i++)
+        TEST_ASSERT_EQ(m_engine[i].calculate(preload, &buf[off], len), ref);
+    }
+  }
+}
+
+static void test_crc_update_byte(void)
+{
+  const uint8_t c3 = 0xC3;
+  uint16_t      crc;
+  uint16_t      v;
+  uint8_t       b;
+  size_t        i;
+
+  // Every CRC low byte against every data byte
+  for (v = 0; v < 256; v++)
+  {
+    b   = (uint8_t)v;
+    crc = (uint16_t)((v * 0x0101U) ^ 0x5AA5U);
+
+    for (i = 0; i < TEST_CRC_ENGINE_CNT; i++)
+    {
+      TEST_ASSERT_EQ(m_engine[i].update_byte(crc, b), m_test_crc_reference(crc, &b, 1));
+      TEST_ASSERT_EQ(m_engine[i].update_byte(v, c3), m_test_crc_reference(v, &c3, 1));
+    }
+  }
+}
+
+static void test_crc_streamed_in_chunks(void)
+{
+  rfalCrcCcittCtx ctx;
+  uint8_t         buf[TEST_CRC_MAX_LEN];
+  uint16_t        pos;
+  uint16_t        chunk;
+  size_t          i;
+
+  srand(TEST_CRC_SEED + 1);
+  m_test_crc_fill(buf, sizeof(buf));
+
+  // As the FIFO drains feed it: chunks of any size, word boundaries anywhere
+  for (i = 0; i < TEST_CRC_ENGINE_CNT; i++)
+  {
+    m_engine[i].start(&ctx, TEST_CRC_PRELOAD_B);
+
+    for (pos = 0; pos < sizeof(buf); pos += chunk)
+    {
+      chunk = (uint16_t)(1 + (rand() % 13));
+      if ((pos + chunk) > sizeof(buf))
+        chunk = (uint16_t)(sizeof(buf) - pos);
+
+      m_engine[i].update(&ctx, &buf[pos], chunk);
+    }
+
+    TEST_ASSERT_EQ(m_engine[i].get(&ctx), m_test_crc_reference(TEST_CRC_PRELOAD_B, buf, sizeof(buf)));
+  }
+}
+
+/* Function definitions ----------------------------------------------------- */
+int main(int argc, char **argv)
+{
+  if ((argc > 1) && (0 == strcmp(argv[1], "bench")))
+  {
+    m_test_crc_bench();
+    return 0;
+  }
+
+  TEST_RUN(test_crc_check_values);
+  TEST_RUN(test_crc_engines_match_reference);
+  TEST_RUN(test_crc_update_byte);
+  TEST_RUN(test_crc_streamed_in_chunks);
+
+  return test_summary();
+}
+
+/* Private function --------------------------------------------------------- */
+static uint16_t m_test_crc_reference(uint16_t crc, const uint8_t *buf, uint16_t length)
+{
+  uint16_t i;
+  int      bit;
+
+  // Straight from the definition: LSB first, polynomial 0x1021 reflected
+  for (i = 0; i < length; i++)
+  {
+    crc ^= buf[i];
+    for (bit = 0; bit < 8; bit++)
+      crc = (crc & 1U) ? (uint16_t)((crc >> 1) ^ 0x8408U) : (uint16_t)(crc >> 1);
+  }
+
+  return crc;
+}
+
+static void m_test_crc_fill(uint8_t *buf, uint16_t length)
+{
+  uint16_t i;
+
+  for (i = 0; i < length; i++)
+    buf[i] = (uint8_t)rand();
+}
+
+static void m_test_crc_bench(void)
+{
+  volatile uint16_t sink = 0;
+  uint8_t           buf[TEST_CRC_BENCH_LEN];
+  uint64_t          t0;
+  uint64_t          us;
+  uint32_t          r;
+  size_t            i;
+
+  srand(TEST_CRC_SEED);
+  m_test_crc_fill(buf, sizeof(buf));
+
+  printf("%u frames of %u bytes\n", TEST_CRC_BENCH_ROUNDS, TEST_CRC_BENCH_LEN);
+
+  for (i = 0; i < TEST_CRC_ENGINE_CNT; i++)
+  {
+    t0 = host_time_us();
+    for (r = 0; r < TEST_CRC_BENCH_ROUNDS; r++)
+      sink ^= m_engine[i].calculate((uint16_t)r, buf, sizeof(buf));
+    us = host_time_us() - t0;
+
+    printf("%-8s %8llu us  %7.1f MB/s  %5.2f ns/byte\n", m_engine[i].name, (unsigned long long)us,
+           ((double)TEST_CRC_BENCH_ROUNDS * TEST_CRC_BENCH_LEN) / (double)us,
+           ((double)us * 1000.0) / ((double)TEST_CRC_BENCH_ROUNDS * TEST_CRC_BENCH_LEN));
+  }
+
+  (void)sink;
+}
+
+/* End of file -------------------------------------------------------------- */
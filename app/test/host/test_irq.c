@@ -0,0 +1,191 @@
+/**
+ * @file       test_irq.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      ST25R3911 IRQ path: simulated IRQ line, deferred IRQ task, st25r3911Isr() and the waiter
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "platform.h"
+#include "st25r3911_interrupt.h"
+#include "st25r3911_com.h"
+
+#include <pthread.h>
+
+/* Private defines ---------------------------------------------------------- */
+#define TEST_IRQ_WAIT_US        (500000U)   // Far above any wake-up latency
+#define TEST_IRQ_TIMEOUT_US     (20000U)
+#define TEST_IRQ_RAISE_DELAY_US (5000U)
+
+/* Private variables -------------------------------------------------------- */
+static uint32_t m_hook_calls;
+
+/* Private function prototypes ---------------------------------------------- */
+static void m_test_irq_setup(void);
+static void *m_test_irq_raise_later(void *arg);
+static uint32_t m_test_irq_hook(uint32_t irqs);
+
+/* Test cases --------------------------------------------------------------- */
+static void test_irq_drained_and_forwarded(void)
+{
+  m_test_irq_setup();
+
+  host_chip_raise(ST25R3911_IRQ_MASK_RXE | ST25R3911_IRQ_MASK_TXE);
+
+  TEST_ASSERT_EQ(st25r3911WaitForInterruptsTimed_us(ST25R3911_IRQ_MASK_RXE, TEST_IRQ_WAIT_US), ST25R3911_IRQ_MASK_RXE);
+
+  // The whole burst is kept, the IRQs not waited for are still there
+  TEST_ASSERT_EQ(st25r3911GetInterrupt(ST25R3911_IRQ_MASK_TXE), ST25R3911_IRQ_MASK_TXE);
+  TEST_ASSERT_EQ(st25r3911GetInterrupt(ST25R3911_IRQ_MASK_ALL), 0);
+  TEST_ASSERT(!host_chip_line());
+}
+
+static void test_irq_three_registers_one_burst(void)
+{
+  uint32_t reads;
+
+  m_test_irq_setup();
+  reads = host_chip_stats()->irq_reads;
+
+  host_chip_raise(ST25R3911_IRQ_MASK_OSC | ST25R3911_IRQ_MASK_NRE | ST25R3911_IRQ_MASK_CRC);
+
+  TEST_ASSERT_EQ(st25r3911WaitForInterruptsTimed_us(ST25R3911_IRQ_MASK_CRC, TEST_IRQ_WAIT_US), ST25R3911_IRQ_MASK_CRC);
+  TEST_ASSERT_EQ(st25r3911GetInterrupt(ST25R3911_IRQ_MASK_OSC | ST25R3911_IRQ_MASK_NRE),
+                 ST25R3911_IRQ_MASK_OSC | ST25R3911_IRQ_MASK_NRE);
+
+  // IRQ_MAIN..IRQ_ERROR_WUP in a single read
+  TEST_ASSERT_EQ(host_chip_stats()->irq_reads - reads, 1);
+}
+
+static void test_irq_wakes_blocked_waiter(void)
+{
+  pthread_t raiser;
+  uint64_t  t0;
+  uint32_t  irqs;
+
+  m_test_irq_setup();
+
+  pthread_create(&raiser, NULL, m_test_irq_raise_later, NULL);
+
+  t0   = host_time_us();
+  irqs = st25r3911WaitForInterruptsTimed_us(ST25R3911_IRQ_MASK_RXE, TEST_IRQ_WAIT_US);
+
+  pthread_join(raiser, NULL);
+
+  TEST_ASSERT_EQ(irqs, ST25R3911_IRQ_MASK_RXE);
+  TEST_ASSERT((host_time_us() - t0) >= TEST_IRQ_RAISE_DELAY_US);
+  TEST_ASSERT((host_time_us() - t0) < TEST_IRQ_WAIT_US);
+}
+
+static void test_irq_timeout(void)
+{
+  uint64_t t0;
+
+  m_test_irq_setup();
+
+  t0 = host_time_us();
+  TEST_ASSERT_EQ(st25r3911WaitForInterruptsTimed_us(ST25R3911_IRQ_MASK_RXE, TEST_IRQ_TIMEOUT_US), 0);
+  TEST_ASSERT((host_time_us() - t0) >= TEST_IRQ_TIMEOUT_US);
+}
+
+static void test_irq_masked_then_enabled(void)
+{
+  m_test_irq_setup();
+
+  st25r3911DisableInterrupts(ST25R3911_IRQ_MASK_RXE);
+  host_chip_raise(ST25R3911_IRQ_MASK_RXE);
+
+  TEST_ASSERT(!host_chip_line());
+  TEST_ASSERT_EQ(st25r3911WaitForInterruptsTimed_us(ST25R3911_IRQ_MASK_RXE, TEST_IRQ_TIMEOUT_US), 0);
+
+  // Unmasking raises the line, the latched IRQ comes through
+  st25r3911EnableInterrupts(ST25R3911_IRQ_MASK_RXE);
+  TEST_ASSERT_EQ(st25r3911WaitForInterruptsTimed_us(ST25R3911_IRQ_MASK_RXE, TEST_IRQ_WAIT_US), ST25R3911_IRQ_MASK_RXE);
+}
+
+static void test_irq_hook_consumes(void)
+{
+  m_test_irq_setup();
+
+  m_hook_calls = 0;
+  st25r3911IRQHookSet(ST25R3911_IRQ_MASK_FWL, m_test_irq_hook);
+
+  host_chip_raise(ST25R3911_IRQ_MASK_FWL | ST25R3911_IRQ_MASK_RXE);
+
+  TEST_ASSERT_EQ(st25r3911WaitForInterruptsTimed_us(ST25R3911_IRQ_MASK_RXE, TEST_IRQ_WAIT_US), ST25R3911_IRQ_MASK_RXE);
+  st25r3911IRQHookSet(ST25R3911_IRQ_MASK_NONE, NULL);
+
+  TEST_ASSERT_EQ(m_hook_calls, 1);
+  TEST_ASSERT_EQ(st25r3911GetInterrupt(ST25R3911_IRQ_MASK_FWL), 0);
+}
+
+static void test_irq_simulated_pulse(void)
+{
+  uint32_t bursts;
+  uint32_t reads;
+  uint64_t t0;
+
+  m_test_irq_setup();
+  bursts = host_irq_bursts();
+  reads  = host_chip_stats()->irq_reads;
+
+  // Runs the whole path once with nothing latched in the chip
+  host_irq_simulate();
+
+  t0 = host_time_us();
+  while ((host_irq_bursts() == bursts) && ((host_time_us() - t0) < TEST_IRQ_WAIT_US))
+    host_delay_us(100);
+
+  TEST_ASSERT_EQ(host_irq_bursts() - bursts, 1);
+  TEST_ASSERT_EQ(host_chip_stats()->irq_reads - reads, 1);
+  TEST_ASSERT_EQ(st25r3911GetInterrupt(ST25R3911_IRQ_MASK_ALL), 0);
+}
+
+/* Function definitions ----------------------------------------------------- */
+int main(void)
+{
+  TEST_RUN(test_irq_drained_and_forwarded);
+  TEST_RUN(test_irq_three_registers_one_burst);
+  TEST_RUN(test_irq_wakes_blocked_waiter);
+  TEST_RUN(test_irq_timeout);
+  TEST_RUN(test_irq_masked_then_enabled);
+  TEST_RUN(test_irq_hook_consumes);
+  TEST_RUN(test_irq_simulated_pulse);
+
+  host_irq_deinit();
+
+  return test_summary();
+}
+
+/* Private function --------------------------------------------------------- */
+static void m_test_irq_setup(void)
+{
+  host_chip_reset();
+  st25r3911InitInterrupts();
+  st25r3911ClearInterrupts();
+}
+
+static void *m_test_irq_raise_later(void *arg)
+{
+  (void)arg;
+
+  host_delay_us(TEST_IRQ_RAISE_DELAY_US);
+  host_chip_raise(ST25R3911_IRQ_MASK_RXE);
+
+  return NULL;
+}
+
+static uint32_t m_test_irq_hook(uint32_t irqs)
+{
+  m_hook_calls++;
+
+  return (irqs & ST25R3911_IRQ_MASK_FWL);
+}
+
+/* End of file -------------------------------------------------------------- */
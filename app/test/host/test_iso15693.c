@@ -0,0 +1,575 @@
+/**
+ * @file       test_iso15693.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      ISO15693 VICC decoder and VCD coder: table driven ones bit-exact with the references
+ * @note       The decoder reference is the former iso15693VICCDecode(), CRC computed after the decode.
+ *             The coder reference codes the whole frame in one go from the ISO15693-2 pulse positions.
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "platform.h"
+#include "rfal_iso15693_2.h"
+#include "rfal_crc.h"
+
+#include <stdlib.h>
+
+/* Private defines ---------------------------------------------------------- */
+#define TEST_ISO15693_MAX_DATA      (40)
+#define TEST_ISO15693_MAX_STREAM    (2 + (TEST_ISO15693_MAX_DATA * 2) + 2)
+#define TEST_ISO15693_SEED          (0x1569U)
+#define TEST_ISO15693_RANDOM_CNT    (20000)
+
+#define TEST_ISO15693_PRELOAD       (0xFFFFU)
+#define TEST_ISO15693_PRELOAD_PICO  (0xE012U)
+
+// VCD coding, ISO15693-2 8.2: one pulse per 2 bits in 1 out of 4, per byte in 1 out of 256
+#define TEST_ISO15693_VCD_SOF_1_4   (0x21)
+#define TEST_ISO15693_VCD_SOF_1_256 (0x81)
+#define TEST_ISO15693_VCD_EOF       (0x04)
+#define TEST_ISO15693_VCD_MAX       (2 + ((TEST_ISO15693_MAX_DATA + 2) * 64))
+
+/* Private enumerate/structure ---------------------------------------------- */
+/**
+ * @brief Decoder output
+ */
+typedef struct
+{
+  ReturnCode err;
+  uint16_t   pos;
+  uint16_t   bits;
+  uint8_t    out[TEST_ISO15693_MAX_DATA + 2];
+}
+test_iso15693_result_t;
+
+/* Private variables -------------------------------------------------------- */
+// Inventory response, flags 00, DSFID 00, UID E0 04 01 50 12 34 56 78, CRC 96AF
+static const uint8_t m_inventory_stream[] =
+{
+  0xB7, 0xAA, 0xAA, 0xAA, 0xAA, 0x52, 0x2D, 0xCD, 0xAC, 0x4C, 0x2B, 0xCB, 0xAA,
+  0xCA, 0xCC, 0xAA, 0xAA, 0xAC, 0xAA, 0x2A, 0x55, 0x35, 0x33, 0xCD, 0xB2, 0x03
+};
+
+static const uint8_t m_inventory_frame[] =
+{
+  0x00, 0x00, 0x78, 0x56, 0x34, 0x12, 0x50, 0x01, 0x04, 0xE0, 0xAF, 0x96
+};
+
+// Read Single Block response, flags 00, block 11 22 33 44, CRC 3E04
+static const uint8_t m_read_stream[] =
+{
+  0xB7, 0xAA, 0xCA, 0xCA, 0x2A, 0x2B, 0x4B, 0x4B, 0xAB, 0xAC, 0xAC, 0xAC, 0x2A,
+  0x55, 0xAB, 0x03
+};
+
+static const uint8_t m_read_frame[] =
+{
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x04, 0x3E
+};
+
+/* Private function prototypes ---------------------------------------------- */
+static void m_test_iso15693_decode(const uint8_t *in, uint16_t in_len, uint16_t out_len,
+                                   uint16_t ignore_bits, bool picopass, test_iso15693_result_t *res);
+static void m_test_iso15693_decode_ref(const uint8_t *in, uint16_t in_len, uint16_t out_len,
+                                       uint16_t ignore_bits, bool picopass, test_iso15693_result_t *res);
+static uint16_t m_test_iso15693_encode(const uint8_t *data, uint16_t len, uint8_t *stream);
+static uint16_t m_test_iso15693_frame(uint8_t *data, uint16_t len, bool picopass);
+static bool m_test_iso15693_same(const test_iso15693_result_t *a, const test_iso15693_result_t *b, uint16_t out_len);
+static void m_test_iso15693_coding(iso15693VcdCoding_t coding);
+static uint16_t m_test_iso15693_vcd_code_ref(iso15693VcdCoding_t coding, const uint8_t *data, uint16_t len,
+                                             bool crc, bool flags, bool picopass, uint8_t *out);
+static ReturnCode m_test_iso15693_vcd_code(const uint8_t *data, uint16_t len, bool crc, bool flags, bool picopass,
+                                           uint16_t chunk, uint8_t *out, uint16_t *out_len, uint16_t *total);
+
+/* Test cases --------------------------------------------------------------- */
+static void test_iso15693_reference_streams(void)
+{
+  test_iso15693_result_t res;
+
+  m_test_iso15693_decode(m_inventory_stream, sizeof(m_inventory_stream), sizeof(res.out), 0, false, &res);
+  TEST_ASSERT_EQ(res.err, ERR_NONE);
+  TEST_ASSERT_EQ(res.pos, sizeof(m_inventory_frame));
+  TEST_ASSERT_EQ(res.bits, sizeof(m_inventory_frame) * 8);
+  TEST_ASSERT(0 == memcmp(res.out, m_inventory_frame, sizeof(m_inventory_frame)));
+
+  m_test_iso15693_decode(m_read_stream, sizeof(m_read_stream), sizeof(res.out), 0, false, &res);
+  TEST_ASSERT_EQ(res.err, ERR_NONE);
+  TEST_ASSERT_EQ(res.pos, sizeof(m_read_frame));
+  TEST_ASSERT(0 == memcmp(res.out, m_read_frame, sizeof(m_read_frame)));
+}
+
+static void test_iso15693_framing_and_short(void)
+{
+  test_iso15693_result_t res;
+  uint8_t                bad[sizeof(m_read_stream)];
+
+  // No SOF
+  memcpy(bad, m_read_stream, sizeof(bad));
+  bad[0] ^= 0x04;
+  m_test_iso15693_decode(bad, sizeof(bad), sizeof(res.out), 0, false, &res);
+  TEST_ASSERT_EQ(res.err, ERR_FRAMING);
+
+  // Output buffer too short: stops at its end, no CRC to check
+  m_test_iso15693_decode(m_read_stream, sizeof(m_read_stream), 3, 0, false, &res);
+  TEST_ASSERT_EQ(res.pos, 3);
+  TEST_ASSERT(0 == memcmp(res.out, m_read_frame, 3));
+
+  // CRC error on a flipped data bit (pair 01 -> 10)
+  memcpy(bad, m_read_stream, sizeof(bad));
+  bad[3] ^= 0x60;
+  m_test_iso15693_decode(bad, sizeof(bad), sizeof(res.out), 0, false, &res);
+  TEST_ASSERT_EQ(res.err, ERR_CRC);
+}
+
+static void test_iso15693_collision_position(void)
+{
+  test_iso15693_result_t res;
+  uint8_t                data[TEST_ISO15693_MAX_DATA];
+  uint8_t                stream[TEST_ISO15693_MAX_STREAM];
+  uint16_t               len;
+  uint16_t               bit;
+  uint16_t               mp;
+
+  memcpy(data, m_inventory_frame, sizeof(m_inventory_frame));
+  len = m_test_iso15693_encode(data, sizeof(m_inventory_frame), stream);
+
+  // Both halves modulated (11) on every data bit in turn
+  for (bit = 0; bit < (sizeof(m_inventory_frame) * 8); bit++)
+  {
+    uint8_t copy[TEST_ISO15693_MAX_STREAM];
+
+    memcpy(copy, stream, len);
+    mp = 5 + (2 * bit);
+    copy[mp / 8]       |= (uint8_t)(1U << (mp % 8));
+    copy[(mp + 1) / 8] |= (uint8_t)(1U << ((mp + 1) % 8));
+
+    m_test_iso15693_decode(copy, len, sizeof(res.out), 0, false, &res);
+    TEST_ASSERT_EQ(res.err, ERR_RF_COLLISION);
+    TEST_ASSERT_EQ(res.bits, bit);
+  }
+}
+
+static void test_iso15693_valid_frames_match_reference(void)
+{
+  test_iso15693_result_t res;
+  test_iso15693_result_t ref;
+  uint8_t                data[TEST_ISO15693_MAX_DATA];
+  uint8_t                stream[TEST_ISO15693_MAX_STREAM];
+  uint16_t               len;
+  uint16_t               stream_len;
+  uint16_t               i;
+  int                    picopass;
+
+  srand(TEST_ISO15693_SEED);
+
+  for (picopass = 0; picopass < 2; picopass++)
+  {
+    for (len = 0; len <= (TEST_ISO15693_MAX_DATA - 2); len++)
+    {
+      for (i = 0; i < len; i++)
+        data[i] = (uint8_t)rand();
+
+      stream_len = m_test_iso15693_encode(data, m_test_iso15693_frame(data, len, picopass), stream);
+
+      m_test_iso15693_decode(stream, stream_len, sizeof(res.out), 0, picopass, &res);
+      m_test_iso15693_decode_ref(stream, stream_len, sizeof(ref.out), 0, picopass, &ref);
+
+      TEST_ASSERT(m_test_iso15693_same(&res, &ref, sizeof(res.out)));
+      TEST_ASSERT_EQ(res.pos, len + 2);
+      TEST_ASSERT_EQ(res.err, ((len + 2) > 2) ? ERR_NONE : ERR_CRC);
+    }
+  }
+}
+
+static void test_iso15693_damaged_frames_match_reference(void)
+{
+  test_iso15693_result_t res;
+  test_iso15693_result_t ref;
+  uint8_t                data[TEST_ISO15693_MAX_DATA];
+  uint8_t                stream[TEST_ISO15693_MAX_STREAM];
+  uint16_t               len;
+  uint16_t               stream_len;
+  uint16_t               out_len;
+  uint16_t               ignore;
+  uint16_t               i;
+  int                    n;
+  int                    k;
+
+  srand(TEST_ISO15693_SEED + 1);
+
+  // Collisions, flipped bits, noise, truncated streams and short output buffers
+  for (n = 0; n < TEST_ISO15693_RANDOM_CNT; n++)
+  {
+    len = (uint16_t)(rand() % (TEST_ISO15693_MAX_DATA - 1));
+    for (i = 0; i < len; i++)
+      data[i] = (uint8_t)rand();
+
+    stream_len = m_test_iso15693_encode(data, m_test_iso15693_frame(data, len, false), stream);
+
+    for (k = rand() % 4; k > 0; k--)
+    {
+      i = (uint16_t)(rand() % (stream_len * 8));
+      if (i >= 5)
+        stream[i / 8] ^= (uint8_t)(1U << (i % 8));
+    }
+
+    if (0 == (rand() % 8))
+    {
+      for (i = 1; i < stream_len; i++)
+        stream[i] = (uint8_t)rand();
+    }
+
+    if (0 == (rand() % 4))
+      stream_len = (uint16_t)(1 + (rand() % stream_len));
+
+    out_len = (0 == (rand() % 4)) ? (uint16_t)(rand() % sizeof(res.out)) : sizeof(res.out);
+    ignore  = (0 == (rand() % 4)) ? (uint16_t)(rand() % 64) : 0;
+
+    m_test_iso15693_decode(stream, stream_len, out_len, ignore, false, &res);
+    m_test_iso15693_decode_ref(stream, stream_len, out_len, ignore, false, &ref);
+
+    TEST_ASSERT(m_test_iso15693_same(&res, &ref, out_len));
+  }
+}
+
+static void test_iso15693_vcd_reference_frame(void)
+{
+  // Inventory request, flags 26, command 01, mask length 00, CRC 0AF6
+  static const uint8_t data[] = { 0x26, 0x01, 0x00 };
+  static const uint8_t coded[] =
+  {
+    0x21, 0x20, 0x08, 0x20, 0x02, 0x08, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x20, 0x08, 0x80, 0x80, 0x20, 0x20, 0x02, 0x02, 0x04
+  };
+  uint8_t  out[TEST_ISO15693_VCD_MAX];
+  uint16_t out_len;
+  uint16_t total;
+
+  m_test_iso15693_coding(ISO15693_VCD_CODING_1_4);
+  TEST_ASSERT_EQ(m_test_iso15693_vcd_code(data, sizeof(data), true, true, false, sizeof(out), out, &out_len, &total), ERR_NONE);
+  TEST_ASSERT_EQ(out_len, sizeof(coded));
+  TEST_ASSERT_EQ(total, sizeof(coded));
+  TEST_ASSERT(0 == memcmp(out, coded, sizeof(coded)));
+
+  // 1 out of 256: the pulse of each byte at its value
+  m_test_iso15693_coding(ISO15693_VCD_CODING_1_256);
+  TEST_ASSERT_EQ(m_test_iso15693_vcd_code(data, sizeof(data), true, true, false, sizeof(out), out, &out_len, &total), ERR_NONE);
+  TEST_ASSERT_EQ(out_len, 2 + (5 * 64));
+  TEST_ASSERT_EQ(out[0], TEST_ISO15693_VCD_SOF_1_256);
+  TEST_ASSERT_EQ(out[1 + (0x26 >> 2)], 0x20);
+  TEST_ASSERT_EQ(out[1 + 64 + (0x01 >> 2)], 0x08);
+  TEST_ASSERT_EQ(out[1 + 128], 0x02);
+  TEST_ASSERT_EQ(out[out_len - 1], TEST_ISO15693_VCD_EOF);
+}
+
+static void test_iso15693_vcd_frames_match_reference(void)
+{
+  static const iso15693VcdCoding_t codings[] = { ISO15693_VCD_CODING_1_4, ISO15693_VCD_CODING_1_256 };
+  static const uint16_t            chunks[]  = { TEST_ISO15693_VCD_MAX, 1, 3, 4, 7, 16, 48, 63, 65 };
+  uint8_t                          data[TEST_ISO15693_MAX_DATA];
+  uint8_t                          out[TEST_ISO15693_VCD_MAX];
+  uint8_t                          ref[TEST_ISO15693_VCD_MAX];
+  uint16_t                         ref_len;
+  uint16_t                         out_len;
+  uint16_t                         total;
+  uint16_t                         len;
+  uint16_t                         i;
+  unsigned                         c;
+  unsigned                         k;
+  unsigned                         opt;
+  bool                             crc;
+  bool                             flags;
+  bool                             picopass;
+
+  srand(TEST_ISO15693_SEED + 2);
+
+  // Whole frame in one call, then resumed across FIFO sized chunks, cut within the symbols
+  for (c = 0; c < (sizeof(codings) / sizeof(codings[0])); c++)
+  {
+    m_test_iso15693_coding(codings[c]);
+
+    for (len = 0; len <= TEST_ISO15693_MAX_DATA; len++)
+    {
+      for (i = 0; i < len; i++)
+        data[i] = (uint8_t)rand();
+
+      for (opt = 0; opt < 8; opt++)
+      {
+        crc      = (0 != (opt & 1U));
+        flags    = (0 != (opt & 2U));
+        picopass = (0 != (opt & 4U));
+
+        ref_len = m_test_iso15693_vcd_code_ref(codings[c], data, len, crc, flags, picopass, ref);
+
+        for (k = 0; k < (sizeof(chunks) / sizeof(chunks[0])); k++)
+        {
+          TEST_ASSERT_EQ(m_test_iso15693_vcd_code(data, len, crc, flags, picopass, chunks[k], out, &out_len, &total), ERR_NONE);
+          TEST_ASSERT_EQ(total, ref_len);
+          TEST_ASSERT_EQ(out_len, ref_len);
+          TEST_ASSERT(0 == memcmp(out, ref, ref_len));
+        }
+      }
+    }
+  }
+
+  m_test_iso15693_coding(ISO15693_VCD_CODING_1_4);
+}
+
+/* Function definitions ----------------------------------------------------- */
+int main(void)
+{
+  TEST_RUN(test_iso15693_reference_streams);
+  TEST_RUN(test_iso15693_framing_and_short);
+  TEST_RUN(test_iso15693_collision_position);
+  TEST_RUN(test_iso15693_valid_frames_match_reference);
+  TEST_RUN(test_iso15693_damaged_frames_match_reference);
+  TEST_RUN(test_iso15693_vcd_reference_frame);
+  TEST_RUN(test_iso15693_vcd_frames_match_reference);
+
+  return test_summary();
+}
+
+/* Private function --------------------------------------------------------- */
+static void m_test_iso15693_decode(const uint8_t *in, uint16_t in_len, uint16_t out_len,
+                                   uint16_t ignore_bits, bool picopass, test_iso15693_result_t *res)
+{
+  memset(res->out, 0xEE, sizeof(res->out));
+  res->err = iso15693VICCDecode(in, in_len, res->out, out_len, &res->pos, &res->bits, ignore_bits, picopass);
+}
+
+static void m_test_iso15693_decode_ref(const uint8_t *in, uint16_t in_len, uint16_t out_len,
+                                       uint16_t ignore_bits, bool picopass, test_iso15693_result_t *res)
+{
+  uint8_t  buf[TEST_ISO15693_MAX_STREAM + 1];
+  uint16_t crc;
+  uint16_t mp;
+  uint16_t bp;
+  uint8_t  man;
+  bool     eof;
+
+  memset(res->out, 0xEE, sizeof(res->out));
+  res->err  = ERR_NONE;
+  res->pos  = 0;
+  res->bits = 0;
+
+  // The former decoder looked one byte past the stream for EOF, give it a 0
+  memset(buf, 0, sizeof(buf));
+  memcpy(buf, in, in_len);
+
+  if ((buf[0] & 0x1F) != 0x17)
+  {
+    res->err = ERR_FRAMING;
+    return;
+  }
+
+  if (0 == out_len)
+    return;
+
+  memset(res->out, 0, out_len);
+
+  if (0 == in_len)
+  {
+    res->err = ERR_CRC;
+    return;
+  }
+
+  bp = 0;
+  for (mp = 5; mp < ((in_len * 8) - 2); mp += 2)
+  {
+    eof = false;
+
+    man  = (buf[mp / 8] >> (mp % 8)) & 1;
+    man |= ((buf[(mp + 1) / 8] >> ((mp + 1) % 8)) & 1) << 1;
+    if (1 == man)
+      bp++;
+    if (2 == man)
+    {
+      res->out[bp / 8] |= (uint8_t)(1U << (bp % 8));
+      bp++;
+    }
+    if (((bp % 8) == 0) && ((buf[mp / 8] & 0xE0) == 0xA0) && (buf[(mp / 8) + 1] == 0x03))
+      eof = true;
+    if (((0 == man) || (3 == man)) && !eof)
+    {
+      if (bp >= ignore_bits)
+        res->err = ERR_RF_COLLISION;
+      else
+        bp++;
+    }
+    if ((bp >= (out_len * 8)) || (ERR_RF_COLLISION == res->err) || eof)
+      break;
+  }
+
+  res->pos  = bp / 8;
+  res->bits = bp;
+
+  if (ERR_NONE != res->err)
+    return;
+
+  if (((bp % 8) != 0) || (res->pos <= 2))
+  {
+    res->err = ERR_CRC;
+    return;
+  }
+
+  crc = rfalCrcCalculateCcitt(picopass ? TEST_ISO15693_PRELOAD_PICO : TEST_ISO15693_PRELOAD, res->out, res->pos - 2);
+  crc = picopass ? crc : (uint16_t)~crc;
+
+  if (((crc & 0xFF) != res->out[res->pos - 2]) || ((crc >> 8) != res->out[res->pos - 1]))
+    res->err = ERR_CRC;
+}
+
+static uint16_t m_test_iso15693_encode(const uint8_t *data, uint16_t len, uint8_t *stream)
+{
+  static const uint8_t eof[] = { 1, 0, 1, 1, 1, 0, 0, 0 };
+  uint16_t             bit = 0;
+  uint16_t             i;
+  int                  b;
+
+  memset(stream, 0, TEST_ISO15693_MAX_STREAM);
+
+  // SOF 11101 (0x17, LSB first), then one pair per data bit: 1 as 01, 0 as 10, then EOF
+#define TEST_ISO15693_PUT(v)  do { if (v) stream[bit / 8] |= (uint8_t)(1U << (bit % 8)); bit++; } while (0)
+  TEST_ISO15693_PUT(1); TEST_ISO15693_PUT(1); TEST_ISO15693_PUT(1); TEST_ISO15693_PUT(0); TEST_ISO15693_PUT(1);
+
+  for (i = 0; i < len; i++)
+  {
+    for (b = 0; b < 8; b++)
+    {
+      TEST_ISO15693_PUT(!((data[i] >> b) & 1));
+      TEST_ISO15693_PUT((data[i] >> b) & 1);
+    }
+  }
+
+  for (b = 0; b < (int)sizeof(eof); b++)
+    TEST_ISO15693_PUT(eof[b]);
+#undef TEST_ISO15693_PUT
+
+  return (uint16_t)((bit + 7) / 8);
+}
+
+static uint16_t m_test_iso15693_frame(uint8_t *data, uint16_t len, bool picopass)
+{
+  uint16_t crc;
+
+  crc = rfalCrcCalculateCcitt(picopass ? TEST_ISO15693_PRELOAD_PICO : TEST_ISO15693_PRELOAD, data, len);
+  crc = picopass ? crc : (uint16_t)~crc;
+
+  data[len]     = (uint8_t)crc;
+  data[len + 1] = (uint8_t)(crc >> 8);
+
+  return len + 2;
+}
+
+static bool m_test_iso15693_same(const test_iso15693_result_t *a, const test_iso15693_result_t *b, uint16_t out_len)
+{
+  if ((a->err != b->err) || (a->pos != b->pos) || (a->bits != b->bits))
+  {
+    printf("  err %d/%d pos %u/%u bits %u/%u\n", a->err, b->err, a->pos, b->pos, a->bits, b->bits);
+    return false;
+  }
+
+  return (0 == memcmp(a->out, b->out, out_len));
+}
+
+static void m_test_iso15693_coding(iso15693VcdCoding_t coding)
+{
+  const struct iso15693StreamConfig *stream;
+  iso15693PhyConfig_t               cfg;
+
+  cfg.coding    = coding;
+  cfg.speedMode = 0;
+  iso15693PhyConfigure(&cfg, &stream);
+}
+
+static uint16_t m_test_iso15693_vcd_code_ref(iso15693VcdCoding_t coding, const uint8_t *data, uint16_t len,
+                                             bool crc, bool flags, bool picopass, uint8_t *out)
+{
+  static const uint8_t pulse[4] = { 0x02, 0x08, 0x20, 0x80 };
+  uint8_t              frame[TEST_ISO15693_MAX_DATA + 2];
+  uint16_t             pos;
+  uint16_t             i;
+  uint16_t             b;
+
+  // Empty frame: the EOF alone
+  if (0 == len)
+  {
+    out[0] = TEST_ISO15693_VCD_EOF;
+    return 1;
+  }
+
+  memcpy(frame, data, len);
+  if (flags && !picopass)
+    frame[0] = (uint8_t)((frame[0] | ISO15693_REQ_FLAG_HIGH_DATARATE) & ~ISO15693_REQ_FLAG_TWO_SUBCARRIERS);
+
+  if (crc && picopass)
+  {
+    // The command byte is not in the CRC of a PicoPass frame
+    m_test_iso15693_frame(&frame[1], len - 1, true);
+    len += 2;
+  }
+  else if (crc)
+  {
+    len = m_test_iso15693_frame(frame, len, false);
+  }
+
+  pos        = 0;
+  out[pos++] = (ISO15693_VCD_CODING_1_4 == coding) ? TEST_ISO15693_VCD_SOF_1_4 : TEST_ISO15693_VCD_SOF_1_256;
+
+  for (i = 0; i < len; i++)
+  {
+    if (ISO15693_VCD_CODING_1_4 == coding)
+    {
+      for (b = 0; b < 8; b += 2)
+        out[pos++] = pulse[(frame[i] >> b) & 3U];
+    }
+    else
+    {
+      memset(&out[pos], 0, 64);
+      out[pos + (frame[i] >> 2)] = pulse[frame[i] & 3U];
+      pos += 64;
+    }
+  }
+
+  out[pos++] = TEST_ISO15693_VCD_EOF;
+
+  return pos;
+}
+
+static ReturnCode m_test_iso15693_vcd_code(const uint8_t *data, uint16_t len, bool crc, bool flags, bool picopass,
+                                           uint16_t chunk, uint8_t *out, uint16_t *out_len, uint16_t *total)
+{
+  uint8_t    buf[TEST_ISO15693_MAX_DATA];
+  ReturnCode ret;
+  uint16_t   offset;
+  uint16_t   act;
+
+  // The coder adapts the flags of the caller buffer
+  memcpy(buf, data, len);
+
+  *out_len = 0;
+  offset   = 0;
+
+  do
+  {
+    ret = iso15693VCDCode(buf, len, crc, flags, picopass, total, &offset, &out[*out_len], chunk, &act);
+    if ((ERR_NONE != ret) && (ERR_AGAIN != ret))
+      return ret;
+
+    // Every call but the last fills the chunk
+    if ((ERR_AGAIN == ret) && (act != chunk))
+      return ERR_SYSTEM;
+
+    *out_len += act;
+  }
+  while ((ERR_AGAIN == ret) && (*out_len < TEST_ISO15693_VCD_MAX));
+
+  return (*out_len == offset) ? ret : ERR_SYSTEM;
+}
+
+/* End of file -------------------------------------------------------------- */
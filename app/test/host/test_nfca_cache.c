@@ -0,0 +1,339 @@
+/**
+ * @file       test_nfca_cache.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      NFC-A cached collision resolution against a simulated field of ISO14443-3 cards
+ * @note       The module is included to reset its cache between the test cases.
+ *             The cards follow the ISO14443-3 states, a card woken from HALT
+ *             goes back to HALT on a command that is not for it.
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "sys_nfc_nfca_cache.c"
+
+/* Private defines ---------------------------------------------------------- */
+#define TEST_NFCA_CARDS_MAX         (4)
+#define TEST_NFCA_DEV_LIMIT         (4)
+
+/* Private enumerate/structure ---------------------------------------------- */
+/**
+ * @brief ISO14443-3 card state
+ */
+typedef enum
+{
+  TEST_NFCA_IDLE,
+  TEST_NFCA_READY,
+  TEST_NFCA_ACTIVE,
+  TEST_NFCA_HALT
+}
+test_nfca_state_t;
+
+/**
+ * @brief Simulated card
+ */
+typedef struct
+{
+  uint8_t           uid[RFAL_NFCA_CASCADE_1_UID_LEN];
+  bool              present;
+  bool              from_halt;        // Woken by a WUPA, READY* or ACTIVE*
+  test_nfca_state_t state;
+}
+test_nfca_card_t;
+
+/* Private variables -------------------------------------------------------- */
+static test_nfca_card_t m_cards[TEST_NFCA_CARDS_MAX];
+static uint32_t         m_wupa_cnt;
+
+/* Private function prototypes ---------------------------------------------- */
+static void m_test_nfca_setup(void);
+static test_nfca_card_t *m_test_nfca_add(uint8_t uid0, test_nfca_state_t state);
+static void m_test_nfca_other_cmd(const test_nfca_card_t *except);
+static bool m_test_nfca_has(const rfalNfcaListenDevice *dev_list, uint8_t dev_cnt, const test_nfca_card_t *card);
+
+/* Test cases --------------------------------------------------------------- */
+static void test_nfca_cache_stale_head_new_card(void)
+{
+  rfalNfcaListenDevice       dev_list[TEST_NFCA_DEV_LIMIT];
+  sys_nfc_nfca_cache_stats_t stats;
+  test_nfca_card_t           *stale;
+  test_nfca_card_t           *card;
+  uint8_t                    dev_cnt;
+
+  m_test_nfca_setup();
+
+  stale = m_test_nfca_add(0x10, TEST_NFCA_IDLE);
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_resolve(TEST_NFCA_DEV_LIMIT, dev_list, &dev_cnt), ERR_NONE);
+  TEST_ASSERT_EQ(dev_cnt, 1);
+  TEST_ASSERT(m_test_nfca_has(dev_list, dev_cnt, stale));
+
+  // The remembered card left, a new one asleep came in
+  stale->present = false;
+  card = m_test_nfca_add(0x20, TEST_NFCA_HALT);
+
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_resolve(TEST_NFCA_DEV_LIMIT, dev_list, &dev_cnt), ERR_NONE);
+  TEST_ASSERT_EQ(dev_cnt, 1);
+  TEST_ASSERT(m_test_nfca_has(dev_list, dev_cnt, card));
+
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_stats_get(&stats), ESP_OK);
+  TEST_ASSERT_EQ(stats.selects, 1);
+  TEST_ASSERT_EQ(stats.misses, 1);
+  TEST_ASSERT_EQ(stats.resolutions, 1);
+  TEST_ASSERT_EQ(stats.found, 1);
+}
+
+static void test_nfca_cache_halted_cards_found(void)
+{
+  rfalNfcaListenDevice       dev_list[TEST_NFCA_DEV_LIMIT];
+  sys_nfc_nfca_cache_stats_t stats;
+  test_nfca_card_t           *a;
+  test_nfca_card_t           *b;
+  uint8_t                    dev_cnt;
+
+  m_test_nfca_setup();
+
+  a = m_test_nfca_add(0x30, TEST_NFCA_IDLE);
+  b = m_test_nfca_add(0x40, TEST_NFCA_IDLE);
+
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_resolve(TEST_NFCA_DEV_LIMIT, dev_list, &dev_cnt), ERR_NONE);
+  TEST_ASSERT_EQ(dev_cnt, 2);
+  TEST_ASSERT(m_test_nfca_has(dev_list, dev_cnt, a) && m_test_nfca_has(dev_list, dev_cnt, b));
+
+  // Field kept on, both stay in HALT until the next cycle
+  TEST_ASSERT_EQ(a->state, TEST_NFCA_HALT);
+  TEST_ASSERT_EQ(b->state, TEST_NFCA_HALT);
+
+  m_wupa_cnt = 0;
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_resolve(TEST_NFCA_DEV_LIMIT, dev_list, &dev_cnt), ERR_NONE);
+  TEST_ASSERT_EQ(dev_cnt, 2);
+  TEST_ASSERT(m_test_nfca_has(dev_list, dev_cnt, a) && m_test_nfca_has(dev_list, dev_cnt, b));
+  TEST_ASSERT_EQ(m_wupa_cnt, 2);
+
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_stats_get(&stats), ESP_OK);
+  TEST_ASSERT_EQ(stats.hits, 2);
+  TEST_ASSERT_EQ(stats.misses, 0);
+  TEST_ASSERT_EQ(stats.resolutions, 0);
+}
+
+static void test_nfca_cache_found_card_not_reported_twice(void)
+{
+  rfalNfcaListenDevice dev_list[TEST_NFCA_DEV_LIMIT];
+  test_nfca_card_t     *stale;
+  test_nfca_card_t     *a;
+  uint8_t              dev_cnt;
+
+  m_test_nfca_setup();
+
+  stale = m_test_nfca_add(0x60, TEST_NFCA_IDLE);
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_resolve(TEST_NFCA_DEV_LIMIT, dev_list, &dev_cnt), ERR_NONE);
+
+  a = m_test_nfca_add(0x50, TEST_NFCA_IDLE);
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_resolve(TEST_NFCA_DEV_LIMIT, dev_list, &dev_cnt), ERR_NONE);
+  TEST_ASSERT_EQ(dev_cnt, 2);
+
+  // Found first from the cache, woken by the WUPA after the miss, it wins the anticollision
+  stale->present = false;
+  m_test_nfca_add(0x70, TEST_NFCA_HALT);
+
+  TEST_ASSERT_EQ(sys_nfc_nfca_cache_resolve(TEST_NFCA_DEV_LIMIT, dev_list, &dev_cnt), ERR_NONE);
+  TEST_ASSERT_EQ(dev_cnt, 1);
+  TEST_ASSERT(m_test_nfca_has(dev_list, dev_cnt, a));
+  TEST_ASSERT_EQ(dev_list[1].nfcId1Len, 0);
+  TEST_ASSERT_EQ(a->state, TEST_NFCA_HALT);
+}
+
+/* Function definitions ----------------------------------------------------- */
+int main(void)
+{
+  TEST_RUN(test_nfca_cache_stale_head_new_card);
+  TEST_RUN(test_nfca_cache_halted_cards_found);
+  TEST_RUN(test_nfca_cache_found_card_not_reported_twice);
+
+  return test_summary();
+}
+
+/* Simulated RFAL ----------------------------------------------------------- */
+ReturnCode rfalISO14443ATransceiveShortFrame(rfal14443AShortFrameCmd txCmd, uint8_t *rxBuf, uint8_t rxBufLen,
+                                             uint16_t *rxRcvdLen, uint32_t fwt)
+{
+  static const rfalNfcaSensRes sens_res = { 0x44, 0x00 };
+  uint8_t                      i;
+  uint8_t                      cnt;
+
+  if (RFAL_14443A_SHORTFRAME_CMD_WUPA == txCmd)
+    m_wupa_cnt++;
+
+  m_test_nfca_other_cmd(NULL);
+
+  for (cnt = 0, i = 0; i < TEST_NFCA_CARDS_MAX; i++)
+  {
+    if (!m_cards[i].present)
+      continue;
+
+    if (TEST_NFCA_IDLE == m_cards[i].state)
+    {
+      m_cards[i].state     = TEST_NFCA_READY;
+      m_cards[i].from_halt = false;
+    }
+    else if ((TEST_NFCA_HALT == m_cards[i].state) && (RFAL_14443A_SHORTFRAME_CMD_WUPA == txCmd))
+    {
+      m_cards[i].state     = TEST_NFCA_READY;
+      m_cards[i].from_halt = true;
+    }
+
+    if (TEST_NFCA_READY == m_cards[i].state)
+      cnt++;
+  }
+
+  *rxRcvdLen = 0;
+  if (0 == cnt)
+    return ERR_TIMEOUT;
+
+  memcpy(rxBuf, &sens_res, sizeof(sens_res));
+  *rxRcvdLen = (uint16_t)rfalConvBytesToBits(sizeof(sens_res));
+
+  return ERR_NONE;
+}
+
+ReturnCode rfalNfcaPollerSelect(const uint8_t *nfcid1, uint8_t nfcidLen, rfalNfcaSelRes *selRes)
+{
+  test_nfca_card_t *card;
+  uint8_t          i;
+
+  for (card = NULL, i = 0; i < TEST_NFCA_CARDS_MAX; i++)
+  {
+    if (m_cards[i].present && (TEST_NFCA_READY == m_cards[i].state) &&
+        (sizeof(m_cards[i].uid) == nfcidLen) && (0 == memcmp(m_cards[i].uid, nfcid1, nfcidLen)))
+      card = &m_cards[i];
+  }
+
+  m_test_nfca_other_cmd(card);
+  if (NULL == card)
+    return ERR_TIMEOUT;
+
+  card->state = TEST_NFCA_ACTIVE;
+  selRes->sak = 0x00;
+
+  return ERR_NONE;
+}
+
+ReturnCode rfalNfcaPollerSingleCollisionResolution(uint8_t devLimit, bool *collPending, rfalNfcaSelRes *selRes,
+                                                   uint8_t *nfcId1, uint8_t *nfcId1Len)
+{
+  test_nfca_card_t *card;
+  uint8_t          i;
+
+  // Lowest UID wins every collision
+  for (card = NULL, i = 0; i < TEST_NFCA_CARDS_MAX; i++)
+  {
+    if (!m_cards[i].present || (TEST_NFCA_READY != m_cards[i].state))
+      continue;
+
+    if ((NULL == card) || (memcmp(m_cards[i].uid, card->uid, sizeof(card->uid)) < 0))
+      card = &m_cards[i];
+  }
+
+  if (NULL == card)
+    return ERR_TIMEOUT;
+
+  *collPending = false;
+  memcpy(nfcId1, card->uid, sizeof(card->uid));
+  *nfcId1Len = sizeof(card->uid);
+
+  return rfalNfcaPollerSelect(nfcId1, *nfcId1Len, selRes);
+}
+
+ReturnCode rfalNfcaPollerSleep(void)
+{
+  uint8_t i;
+
+  for (i = 0; i < TEST_NFCA_CARDS_MAX; i++)
+  {
+    if (m_cards[i].present && (TEST_NFCA_ACTIVE == m_cards[i].state))
+      m_cards[i].state = TEST_NFCA_HALT;
+  }
+
+  m_test_nfca_other_cmd(NULL);
+
+  return ERR_NONE;
+}
+
+ReturnCode rfalNfcaPollerFullCollisionResolution(rfalComplianceMode compMode, uint8_t devLimit,
+                                                 rfalNfcaListenDevice *nfcaDevList, uint8_t *devCnt)
+{
+  return ERR_NOTSUPP;
+}
+
+esp_err_t sys_nfc_submit(sys_nfc_req_fn_t fn, void *arg, bool wait)
+{
+  fn(arg);
+
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void)
+{
+  return 0;
+}
+
+/* Private function --------------------------------------------------------- */
+static void m_test_nfca_setup(void)
+{
+  memset(m_cards, 0, sizeof(m_cards));
+  memset(m_cache, 0, sizeof(m_cache));
+  m_cnt      = 0;
+  m_wupa_cnt = 0;
+}
+
+static test_nfca_card_t *m_test_nfca_add(uint8_t uid0, test_nfca_state_t state)
+{
+  test_nfca_card_t *card;
+  uint8_t          i;
+
+  for (i = 0; m_cards[i].present || (0 != m_cards[i].uid[0]); i++)
+    ;
+
+  card          = &m_cards[i];
+  card->uid[0]  = uid0;
+  card->uid[1]  = 0x01;
+  card->uid[2]  = 0x02;
+  card->uid[3]  = 0x03;
+  card->present = true;
+  card->state   = state;
+
+  return card;
+}
+
+static void m_test_nfca_other_cmd(const test_nfca_card_t *except)
+{
+  uint8_t i;
+
+  // Any command that is not for it sends a READY or ACTIVE card back
+  for (i = 0; i < TEST_NFCA_CARDS_MAX; i++)
+  {
+    if ((&m_cards[i] == except) || !m_cards[i].present)
+      continue;
+
+    if ((TEST_NFCA_READY == m_cards[i].state) || (TEST_NFCA_ACTIVE == m_cards[i].state))
+      m_cards[i].state = m_cards[i].from_halt ? TEST_NFCA_HALT : TEST_NFCA_IDLE;
+  }
+}
+
+static bool m_test_nfca_has(const rfalNfcaListenDevice *dev_list, uint8_t dev_cnt, const test_nfca_card_t *card)
+{
+  uint8_t i;
+
+  for (i = 0; i < dev_cnt; i++)
+  {
+    if ((sizeof(card->uid) == dev_list[i].nfcId1Len) && (0 == memcmp(dev_list[i].nfcId1, card->uid, sizeof(card->uid))))
+      return true;
+  }
+
+  return false;
+}
+
+/* End of file -------------------------------------------------------------- */
@@ -0,0 +1,151 @@
+/**
+ * @file       test_timer.c
+ * @copyright  Copyright (C) 2021 ThuanLe. All rights reserved.
+ * @license    This project is released under the ThuanLe License.
+ * @version    1.0.0
+ * @date       2021-04-25
+ * @author     Thuan Le
+ * @brief      RFAL SW timers on a fake clock, 64 bit deadlines past the 32 bit microsecond wrap
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------------- */
+#include "test_common.h"
+#include "platform.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define TEST_TIMER_WRAP_US      (0x100000000ULL)            // 32 bit microseconds, 71.6 minutes
+#define TEST_TIMER_DAY_US       (86400ULL * 1000000ULL)
+
+/* Private variables -------------------------------------------------------- */
+static uint64_t m_now;
+
+/* Private function prototypes ---------------------------------------------- */
+static uint64_t m_test_timer_clock(void);
+static void m_test_timer_setup(uint64_t now);
+
+/* Test cases --------------------------------------------------------------- */
+static void test_timer_expires_at_deadline(void)
+{
+  uint64_t t;
+
+  m_test_timer_setup(1000);
+  t = timerCalculateTimer_us(500);
+
+  m_now = 1499;
+  TEST_ASSERT(!timerIsExpired(t));
+  TEST_ASSERT(timerIsRunning(t));
+  TEST_ASSERT_EQ(timerRemaining_us(t), 1);
+
+  m_now = 1500;
+  TEST_ASSERT(timerIsExpired(t));
+  TEST_ASSERT_EQ(timerRemaining_us(t), 0);
+}
+
+static void test_timer_ms(void)
+{
+  uint64_t t;
+
+  m_test_timer_setup(0);
+  t = timerCalculateTimer(5);
+
+  m_now = 4999;
+  TEST_ASSERT(!timerIsExpired(t));
+
+  m_now = 5000;
+  TEST_ASSERT(timerIsExpired(t));
+}
+
+static void test_timer_across_32bit_wrap(void)
+{
+  uint64_t t;
+
+  // A deadline kept in 32 bits would read 3 ms, long expired
+  m_test_timer_setup(TEST_TIMER_WRAP_US - 2000);
+  t = platformTimerCreate(5);
+
+  TEST_ASSERT(t > TEST_TIMER_WRAP_US);
+
+  m_now = TEST_TIMER_WRAP_US + 1000;
+  TEST_ASSERT(!platformTimerIsExpired(t));
+  TEST_ASSERT_EQ(timerRemaining_us(t), 2000);
+
+  m_now = TEST_TIMER_WRAP_US + 3000;
+  TEST_ASSERT(platformTimerIsExpired(t));
+}
+
+static void test_timer_after_days(void)
+{
+  uint64_t t;
+
+  m_test_timer_setup(30 * TEST_TIMER_DAY_US + 123);
+  t = platformTimerCreateUs(250);
+
+  m_now += 249;
+  TEST_ASSERT(!platformTimerIsExpired(t));
+
+  m_now += 1;
+  TEST_ASSERT(platformTimerIsExpired(t));
+}
+
+static void test_timer_zero_is_expired(void)
+{
+  // Cleared timers (0) read as expired, as the SFGT and WTX ones rely on
+  m_test_timer_setup(TEST_TIMER_WRAP_US + 1);
+  TEST_ASSERT(timerIsExpired(0));
+}
+
+static void test_stopwatch_across_32bit_wrap(void)
+{
+  m_test_timer_setup(TEST_TIMER_WRAP_US - 10);
+  timerStopwatchStart();
+
+  m_now = TEST_TIMER_WRAP_US + 90;
+  TEST_ASSERT_EQ(timerStopwatchMeasure_us(), 100);
+
+  m_now += 2000;
+  TEST_ASSERT_EQ(timerStopwatchMeasure(), 2);
+}
+
+static void test_timer_platform_clock_restored(void)
+{
+  uint64_t t;
+
+  timerSetClockSource(NULL);
+
+  // Back on the host clock
+  t = timerCalculateTimer_us(1000);
+  TEST_ASSERT(!timerIsExpired(t));
+
+  host_delay_us(2000);
+  TEST_ASSERT(timerIsExpired(t));
+}
+
+/* Function definitions ----------------------------------------------------- */
+int main(void)
+{
+  TEST_RUN(test_timer_expires_at_deadline);
+  TEST_RUN(test_timer_ms);
+  TEST_RUN(test_timer_across_32bit_wrap);
+  TEST_RUN(test_timer_after_days);
+  TEST_RUN(test_timer_zero_is_expired);
+  TEST_RUN(test_stopwatch_across_32bit_wrap);
+  TEST_RUN(test_timer_platform_clock_restored);
+
+  return test_summary();
+}
+
+/* Private function --------------------------------------------------------- */
+static uint64_t m_test_timer_clock(void)
+{
+  return m_now;
+}
+
+static void m_test_timer_setup(uint64_t now)
+{
+  m_now = now;
+  timerSetClockSource(m_test_timer_clock);
+}
+
+/* End of file -------------------------------------------------------------- */